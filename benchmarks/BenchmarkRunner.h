@@ -0,0 +1,213 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "Core/RealtimeSanitizer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vizasynth {
+
+/**
+ * BenchmarkRunner - Minimal in-house microbenchmark harness
+ *
+ * Each benchmark body is timed in batches: the batch size is calibrated so a
+ * single measurement is well above timer resolution, then batches are
+ * repeated until the minimum run time has elapsed. Per-iteration statistics
+ * are collected over the batches and written as JSON for comparing branches.
+ *
+ * Usage:
+ * @code
+ * runner.run("oscillator/saw", 4096, [&] { osc.processBlock(buffer, 4096); });
+ * @endcode
+ */
+class BenchmarkRunner {
+public:
+    struct Settings {
+        double minSecondsPerBenchmark = 0.25;
+        double targetSecondsPerBatch = 0.002;
+        int minBatches = 10;
+        juce::String filter;  // Only run benchmarks whose name contains this
+    };
+
+    struct Result {
+        std::string name;
+        int64_t iterations = 0;
+        double meanNs = 0.0;       // Per iteration
+        double medianNs = 0.0;
+        double p99Ns = 0.0;
+        double minNs = 0.0;
+        double maxNs = 0.0;
+        double itemsPerSecond = 0.0;
+        double realTimeFactor = 0.0;  // Audio time / wall time, 0 if not audio
+    };
+
+    explicit BenchmarkRunner(const Settings& s) : settings(s) {}
+
+    /**
+     * Time a benchmark body.
+     * @param name Hierarchical name, e.g. "processBlock/512/voices:8"
+     * @param itemsPerIteration Items (samples, points...) processed per call
+     * @param body Callable invoked once per iteration
+     * @param audioSecondsPerIteration Audio time produced per call, for real-time factor
+     */
+    template <typename Body>
+    void run(const std::string& name, double itemsPerIteration, Body&& body,
+             double audioSecondsPerIteration = 0.0) {
+        if (!isEnabled(name))
+            return;
+
+        // Warm up caches and branch predictors, then size the batches
+        body();
+        int64_t batchSize = 1;
+        for (;;) {
+            const double seconds = timeBatch(body, batchSize);
+            if (seconds >= settings.targetSecondsPerBatch || batchSize >= (int64_t(1) << 30))
+                break;
+            batchSize *= seconds > 0.0 ? juce::jlimit<int64_t>(2, 100, static_cast<int64_t>(settings.targetSecondsPerBatch / seconds) + 1)
+                                       : 100;
+        }
+
+        std::vector<double> samples;
+        double elapsed = 0.0;
+
+        while (elapsed < settings.minSecondsPerBenchmark || static_cast<int>(samples.size()) < settings.minBatches) {
+            const double seconds = timeBatch(body, batchSize);
+            elapsed += seconds;
+            samples.push_back(seconds * 1.0e9 / static_cast<double>(batchSize));
+        }
+
+        addResult(name, std::move(samples), batchSize, itemsPerIteration, audioSecondsPerIteration);
+    }
+
+    /**
+     * Record externally timed iterations, one sample per call, for bodies
+     * that are too slow to batch or need untimed work between calls
+     * (e.g. feeding a panel before each paint).
+     * @param samplesNs Duration of each iteration in nanoseconds
+     */
+    void addSamples(const std::string& name, std::vector<double> samplesNs, double itemsPerIteration) {
+        if (isEnabled(name) && !samplesNs.empty())
+            addResult(name, std::move(samplesNs), 1, itemsPerIteration, 0.0);
+    }
+
+    /**
+     * Whether a benchmark passes the name filter; lets callers skip setup.
+     */
+    bool isEnabled(const std::string& name) const {
+        return settings.filter.isEmpty() || juce::String(name).contains(settings.filter);
+    }
+
+    const Settings& getSettings() const { return settings; }
+
+    const std::vector<Result>& getResults() const { return results; }
+
+    /**
+     * Serialise all results plus host context as JSON.
+     */
+    juce::String toJson() const {
+        auto* context = new juce::DynamicObject();
+        context->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+        context->setProperty("host", juce::SystemStats::getComputerName());
+        context->setProperty("os", juce::SystemStats::getOperatingSystemName());
+        context->setProperty("cpu", juce::SystemStats::getCpuModel());
+        context->setProperty("numCpus", juce::SystemStats::getNumCpus());
+        context->setProperty("cpuSpeedMHz", juce::SystemStats::getCpuSpeedInMegahertz());
+       #if JUCE_DEBUG
+        context->setProperty("buildType", "Debug");
+       #else
+        context->setProperty("buildType", "Release");
+       #endif
+        if (rtsan::isActive()) {
+            context->setProperty("realtimeViolations", static_cast<juce::int64>(rtsan::getViolationCount()));
+            context->setProperty("realtimeViolationSites", static_cast<int>(rtsan::getUniqueViolationCount()));
+        }
+
+        juce::Array<juce::var> entries;
+        for (const auto& r : results) {
+            auto* entry = new juce::DynamicObject();
+            entry->setProperty("name", juce::String(r.name));
+            entry->setProperty("iterations", r.iterations);
+            entry->setProperty("meanNs", r.meanNs);
+            entry->setProperty("medianNs", r.medianNs);
+            entry->setProperty("p99Ns", r.p99Ns);
+            entry->setProperty("minNs", r.minNs);
+            entry->setProperty("maxNs", r.maxNs);
+            entry->setProperty("itemsPerSecond", r.itemsPerSecond);
+            if (r.realTimeFactor > 0.0)
+                entry->setProperty("realTimeFactor", r.realTimeFactor);
+            entries.add(juce::var(entry));
+        }
+
+        auto* root = new juce::DynamicObject();
+        root->setProperty("context", juce::var(context));
+        root->setProperty("benchmarks", entries);
+        return juce::JSON::toString(juce::var(root));
+    }
+
+    /**
+     * Keep a value alive so the optimiser cannot drop the work producing it.
+     */
+    template <typename T>
+    static void doNotOptimize(const T& value) {
+        static const void* volatile sink;
+        sink = &value;
+       #if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r"(&value) : "memory");
+       #endif
+    }
+
+private:
+    void addResult(const std::string& name, std::vector<double> samples, int64_t batchSize,
+                   double itemsPerIteration, double audioSecondsPerIteration) {
+        std::sort(samples.begin(), samples.end());
+
+        Result result;
+        result.name = name;
+        result.iterations = batchSize * static_cast<int64_t>(samples.size());
+        result.minNs = samples.front();
+        result.maxNs = samples.back();
+        result.medianNs = samples[samples.size() / 2];
+        result.p99Ns = samples[std::min(samples.size() - 1, (samples.size() * 99) / 100)];
+
+        double sum = 0.0;
+        for (auto ns : samples)
+            sum += ns;
+        result.meanNs = sum / static_cast<double>(samples.size());
+
+        result.itemsPerSecond = itemsPerIteration * 1.0e9 / result.medianNs;
+        if (audioSecondsPerIteration > 0.0)
+            result.realTimeFactor = audioSecondsPerIteration * 1.0e9 / result.medianNs;
+
+        printResult(result);
+        results.push_back(result);
+    }
+
+    template <typename Body>
+    static double timeBatch(Body& body, int64_t batchSize) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int64_t i = 0; i < batchSize; ++i)
+            body();
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    static void printResult(const Result& r) {
+        juce::String line = juce::String(r.name).paddedRight(' ', 48)
+                          + juce::String(r.medianNs, 1).paddedLeft(' ', 14) + " ns"
+                          + juce::String(r.itemsPerSecond / 1.0e6, 2).paddedLeft(' ', 12) + " M/s";
+        if (r.realTimeFactor > 0.0)
+            line << juce::String(r.realTimeFactor, 1).paddedLeft(' ', 10) << "x RT";
+        line << "   (mean " << juce::String(r.meanNs, 1) << " ns, p99 " << juce::String(r.p99Ns, 1) << " ns)";
+        std::printf("%s\n", line.toRawUTF8());
+        std::fflush(stdout);
+    }
+
+    Settings settings;
+    std::vector<Result> results;
+};
+
+} // namespace vizasynth
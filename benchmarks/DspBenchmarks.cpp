@@ -0,0 +1,206 @@
+#include "BenchmarkRunner.h"
+#include "DSP/PolyBLEPOscillator.h"
+#include "DSP/Filters/FilterNode.h"
+#include "DSP/Effects/EffectsBus.h"
+#include "Visualization/ProbeBuffer.h"
+#include "Visualization/FrequencyDomain/SpectrumAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+
+namespace vizasynth {
+
+namespace {
+
+/**
+ * RBJ biquad used only to exercise FilterNode's generic analysis path.
+ */
+class BiquadNode : public FilterNode {
+public:
+    float process(float input) override {
+        const float y = b0 * input + z1;
+        z1 = b1 * input - a1 * y + z2;
+        z2 = b2 * input - a2 * y;
+        lastOutput = y;
+        return y;
+    }
+
+    void reset() override { z1 = z2 = lastOutput = 0.0f; }
+    void prepare(double newSampleRate, int) override { sampleRate = newSampleRate; updateCoefficients(); }
+    float getLastOutput() const override { return lastOutput; }
+    double getSampleRate() const override { return sampleRate; }
+    std::string getName() const override { return "Biquad"; }
+
+    void setCutoff(float hz) override { cutoff = hz; updateCoefficients(); }
+    float getCutoff() const override { return cutoff; }
+    void setResonance(float newQ) override { q = newQ; updateCoefficients(); }
+    float getResonance() const override { return q; }
+    void setType(Type) override {}
+    Type getType() const override { return Type::LowPass; }
+    int getOrder() const override { return 2; }
+
+    std::optional<TransferFunction> getTransferFunction() const override {
+        return TransferFunction({b0, b1, b2}, {a1, a2});
+    }
+
+    std::optional<std::vector<Complex>> getPoles() const override { return computePolesFromCoeffs(a1, a2); }
+    std::optional<std::vector<Complex>> getZeros() const override { return std::vector<Complex>{}; }
+
+private:
+    void updateCoefficients() {
+        const double w0 = 2.0 * juce::MathConstants<double>::pi * cutoff / sampleRate;
+        const double alpha = std::sin(w0) / (2.0 * q);
+        const double cosW0 = std::cos(w0);
+        const double a0 = 1.0 + alpha;
+
+        b0 = static_cast<float>((1.0 - cosW0) * 0.5 / a0);
+        b1 = static_cast<float>((1.0 - cosW0) / a0);
+        b2 = b0;
+        a1 = static_cast<float>(-2.0 * cosW0 / a0);
+        a2 = static_cast<float>((1.0 - alpha) / a0);
+    }
+
+    double sampleRate = 48000.0;
+    float cutoff = 1000.0f;
+    float q = 0.707f;
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    float z1 = 0.0f, z2 = 0.0f, lastOutput = 0.0f;
+};
+
+void benchmarkOscillators(BenchmarkRunner& runner)
+{
+    constexpr int NumSamples = 4096;
+    constexpr double SampleRate = 48000.0;
+
+    const std::pair<OscillatorWaveform, const char*> waveforms[] = {
+        {OscillatorWaveform::Sine, "sine"},
+        {OscillatorWaveform::Saw, "saw"},
+        {OscillatorWaveform::Square, "square"},
+        {OscillatorWaveform::Triangle, "triangle"},
+    };
+
+    std::vector<float> output(NumSamples);
+
+    for (const auto& [waveform, name] : waveforms) {
+        PolyBLEPOscillator oscillator;
+        oscillator.prepare(SampleRate);
+        oscillator.setWaveform(waveform);
+        oscillator.setFrequency(440.0f);
+
+        runner.run(std::string("oscillator/") + name, NumSamples, [&] {
+            for (int i = 0; i < NumSamples; ++i)
+                output[static_cast<size_t>(i)] = oscillator.processSample();
+            BenchmarkRunner::doNotOptimize(output);
+        }, NumSamples / SampleRate);
+    }
+}
+
+void benchmarkProbeBuffer(BenchmarkRunner& runner)
+{
+    std::vector<float> source(ProbeBuffer::DefaultCapacity, 0.5f);
+    std::vector<float> destination(ProbeBuffer::DefaultCapacity);
+
+    const std::pair<ProbeBuffer::SampleFormat, const char*> formats[] = {
+        {ProbeBuffer::SampleFormat::Float32, ""},
+        {ProbeBuffer::SampleFormat::Int16, "int16/"},
+    };
+
+    for (const auto& [format, name] : formats) {
+        for (int chunk : {1, 64, 512, 4096}) {
+            ProbeBuffer probe;
+            probe.setSampleFormat(format);
+            probe.allocate(ProbeBuffer::DefaultCapacity);
+
+            runner.run(std::string("probeBuffer/pushPull/") + name + std::to_string(chunk), chunk, [&] {
+                if (chunk == 1)
+                    probe.push(source[0]);
+                else
+                    probe.push(source.data(), chunk);
+                BenchmarkRunner::doNotOptimize(probe.pull(destination.data(), chunk));
+            });
+        }
+    }
+}
+
+void benchmarkEffects(BenchmarkRunner& runner)
+{
+    constexpr double SampleRate = 48000.0;
+    constexpr int NumBlocks = 64;
+
+    for (int blockSize : {32, 512}) {
+        const int numSamples = blockSize * NumBlocks;
+        std::vector<float> source(static_cast<size_t>(numSamples));
+        std::vector<float> left(source.size()), right(source.size());
+        for (size_t i = 0; i < source.size(); ++i)
+            source[i] = std::sin(0.03f * static_cast<float>(i));
+
+        EffectsBus bus;
+        const std::pair<EffectNode*, const char*> effects[] = {
+            {&bus.getChorus(), "chorus"},
+            {&bus.getDelay(), "delay"},
+            {&bus.getReverb(), "reverb"},
+        };
+
+        for (const auto& [effect, name] : effects) {
+            effect->setEnabled(true);
+            effect->prepare(SampleRate, blockSize);
+
+            runner.run(std::string("effects/") + name + "/" + std::to_string(blockSize), numSamples, [&] {
+                // Fresh input every pass, so the feedback paths don't build up
+                std::copy(source.begin(), source.end(), left.begin());
+                std::copy(source.begin(), source.end(), right.begin());
+
+                for (int start = 0; start < numSamples; start += blockSize)
+                    effect->process(left.data() + start, right.data() + start, blockSize);
+                BenchmarkRunner::doNotOptimize(left);
+            }, numSamples / SampleRate);
+
+            effect->setEnabled(false);
+            effect->prepare(SampleRate, blockSize);
+        }
+    }
+}
+
+void benchmarkSpectrum(BenchmarkRunner& runner)
+{
+    ProbeManager probeManager;
+    SpectrumAnalyzer analyzer(probeManager);
+
+    std::vector<float> frame(SpectrumAnalyzer::FFTSize);
+    for (size_t i = 0; i < frame.size(); ++i)
+        frame[i] = std::sin(0.05f * static_cast<float>(i)) + 0.25f * std::sin(0.31f * static_cast<float>(i));
+
+    runner.run("spectrum/processFFT/" + std::to_string(SpectrumAnalyzer::FFTSize), SpectrumAnalyzer::FFTSize, [&] {
+        analyzer.processFFT(frame.data());
+        BenchmarkRunner::doNotOptimize(analyzer.getMagnitudeSpectrum());
+    });
+}
+
+void benchmarkFilterResponse(BenchmarkRunner& runner)
+{
+    BiquadNode filter;
+    filter.prepare(48000.0, 512);
+    filter.setCutoff(1200.0f);
+    filter.setResonance(2.0f);
+
+    for (int points : {128, 512, 2048}) {
+        runner.run("filter/getFrequencyResponse/" + std::to_string(points), points, [&] {
+            auto response = filter.getFrequencyResponse(points);
+            BenchmarkRunner::doNotOptimize(response);
+        });
+    }
+}
+
+} // namespace
+
+void runDspBenchmarks(BenchmarkRunner& runner)
+{
+    benchmarkOscillators(runner);
+    benchmarkProbeBuffer(runner);
+    benchmarkEffects(runner);
+    benchmarkSpectrum(runner);
+    benchmarkFilterResponse(runner);
+}
+
+} // namespace vizasynth
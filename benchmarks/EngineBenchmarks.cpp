@@ -0,0 +1,81 @@
+#include "BenchmarkRunner.h"
+#include "PluginProcessor.h"
+
+namespace vizasynth {
+
+namespace {
+
+constexpr double SampleRate = 48000.0;
+const int BlockSizes[] = {16, 32, 64, 128, 256, 512, 1024, 2048};
+const int Polyphonies[] = {1, 8, 32, 64, 128, 256};
+
+void benchmarkVoice(BenchmarkRunner& runner)
+{
+    for (int blockSize : BlockSizes) {
+        // A one-voice Synthesiser owns the note state, the voice is then
+        // rendered directly to keep MIDI handling out of the measurement
+        juce::Synthesiser synth;
+        auto* voice = new VizASynthVoice();
+        synth.addVoice(voice);
+        synth.addSound(new VizASynthSound());
+        synth.setCurrentPlaybackSampleRate(SampleRate);
+
+        ProbeManager probeManager;
+        voice->setProbeManager(&probeManager);
+        voice->prepareToPlay(SampleRate, blockSize);
+        voice->setOscillatorType(1);
+        voice->setADSR(0.001f, 0.1f, 1.0f, 0.3f);
+        synth.noteOn(1, 57, 0.8f);
+
+        juce::AudioBuffer<float> bus(1, blockSize);
+
+        runner.run("voice/renderNextBlock/" + std::to_string(blockSize), blockSize, [&] {
+            bus.clear();
+            voice->renderNextBlock(bus, 0, blockSize);
+            BenchmarkRunner::doNotOptimize(bus.getReadPointer(0)[0]);
+        }, blockSize / SampleRate);
+    }
+}
+
+void benchmarkProcessBlock(BenchmarkRunner& runner)
+{
+    for (int polyphony : Polyphonies) {
+        VizASynthAudioProcessor processor;
+        processor.setNumVoices(polyphony);
+        processor.getAPVTS().getParameter("oscType")->setValueNotifyingHost(0.5f);  // Saw
+        processor.getAPVTS().getParameter("sustain")->setValueNotifyingHost(1.0f);
+
+        for (int blockSize : BlockSizes) {
+            processor.setPlayConfigDetails(0, 2, SampleRate, blockSize);
+            processor.prepareToPlay(SampleRate, blockSize);
+            processor.reset();
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::MidiBuffer midi;
+
+            // Hold one note per voice for the whole measurement
+            for (int i = 0; i < polyphony; ++i)
+                midi.addEvent(juce::MidiMessage::noteOn(1 + i / 128, i % 128, 0.7f), 0);
+            processor.processBlock(buffer, midi);
+            midi.clear();
+
+            runner.run("processBlock/" + std::to_string(blockSize) + "/voices:" + std::to_string(polyphony),
+                       blockSize, [&] {
+                processor.processBlock(buffer, midi);
+                BenchmarkRunner::doNotOptimize(buffer.getReadPointer(0)[0]);
+            }, blockSize / SampleRate);
+
+            processor.releaseResources();
+        }
+    }
+}
+
+} // namespace
+
+void runEngineBenchmarks(BenchmarkRunner& runner)
+{
+    benchmarkVoice(runner);
+    benchmarkProcessBlock(runner);
+}
+
+} // namespace vizasynth
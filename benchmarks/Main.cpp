@@ -0,0 +1,56 @@
+#include "BenchmarkRunner.h"
+#include "Core/RealtimeSanitizer.h"
+#include <juce_events/juce_events.h>
+#include <iostream>
+
+namespace vizasynth {
+void runDspBenchmarks(BenchmarkRunner& runner);
+void runEngineBenchmarks(BenchmarkRunner& runner);
+void runPanelBenchmarks(BenchmarkRunner& runner);
+}
+
+/**
+ * VizASynth_Benchmarks - microbenchmarks for the DSP and visualisation hot paths
+ *
+ *   VizASynth_Benchmarks [--filter <substring>] [--json <file>] [--min-time <seconds>]
+ */
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h")) {
+        std::cout << "Usage: VizASynth_Benchmarks [--filter <substring>] [--json <file>] [--min-time <seconds>]\n";
+        return 0;
+    }
+
+    vizasynth::BenchmarkRunner::Settings settings;
+    if (args.containsOption("--filter"))
+        settings.filter = args.getValueForOption("--filter");
+    if (args.containsOption("--min-time"))
+        settings.minSecondsPerBenchmark = args.getValueForOption("--min-time").getDoubleValue();
+
+    vizasynth::BenchmarkRunner runner(settings);
+    vizasynth::runDspBenchmarks(runner);
+    vizasynth::runEngineBenchmarks(runner);
+    vizasynth::runPanelBenchmarks(runner);
+
+    // Sanitizer builds: show which benchmarked paths broke real-time rules
+    if (vizasynth::rtsan::isActive())
+        vizasynth::rtsan::writeReport(std::cerr);
+
+    const auto json = runner.toJson();
+
+    if (args.containsOption("--json")) {
+        auto file = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--json"));
+        if (!file.replaceWithText(json)) {
+            std::cerr << "Cannot write " << file.getFullPathName() << "\n";
+            return 1;
+        }
+        std::cout << "Results written to " << file.getFullPathName() << "\n";
+    } else {
+        std::cout << json << "\n";
+    }
+
+    return 0;
+}
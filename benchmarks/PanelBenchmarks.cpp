@@ -0,0 +1,197 @@
+#include "BenchmarkRunner.h"
+#include "Visualization/ProbeBuffer.h"
+#include "Visualization/Core/PanelRegistry.h"
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <chrono>
+#include <cmath>
+
+namespace vizasynth {
+
+namespace {
+
+//==============================================================================
+// Synthetic probe signals
+//==============================================================================
+
+enum class TestSignal { Sine, Saw, Noise, Chord };
+
+struct SignalInfo {
+    TestSignal signal;
+    const char* name;
+};
+
+const SignalInfo Signals[] = {
+    {TestSignal::Sine, "sine"},
+    {TestSignal::Saw, "saw"},
+    {TestSignal::Noise, "noise"},
+    {TestSignal::Chord, "chord"},
+};
+
+const double SampleRates[] = {44100.0, 96000.0};
+
+struct FrameSize {
+    int width;
+    int height;
+};
+
+const FrameSize Sizes[] = {{480, 270}, {960, 540}, {1920, 1080}};
+const float Scales[] = {1.0f, 2.0f};
+
+constexpr int FramesPerSecond = 60;
+constexpr int WarmupFrames = 10;
+constexpr int MinFrames = 30;
+constexpr int MaxFrames = 2000;
+
+/**
+ * Generates the probe feed for a test signal. The chord is a C major triad,
+ * registered with the ProbeManager as three voices like real playback.
+ */
+class SignalGenerator {
+public:
+    SignalGenerator(TestSignal s, double rate) : signal(s), sampleRate(rate) {}
+
+    std::vector<float> getFrequencies() const {
+        switch (signal) {
+            case TestSignal::Sine:  return {440.0f};
+            case TestSignal::Saw:   return {110.0f};
+            case TestSignal::Noise: return {};
+            case TestSignal::Chord: return {261.63f, 329.63f, 392.0f};
+        }
+        return {};
+    }
+
+    void fill(float* output, int numSamples) {
+        const auto frequencies = getFrequencies();
+
+        for (int i = 0; i < numSamples; ++i) {
+            float x = 0.0f;
+
+            if (signal == TestSignal::Noise) {
+                x = random.nextFloat() * 2.0f - 1.0f;
+            } else {
+                for (size_t v = 0; v < frequencies.size(); ++v) {
+                    const double phase = std::fmod(time * frequencies[v], 1.0);
+                    x += signal == TestSignal::Saw
+                             ? static_cast<float>(2.0 * phase - 1.0)
+                             : static_cast<float>(std::sin(phase * juce::MathConstants<double>::twoPi));
+                }
+                x /= static_cast<float>(frequencies.size());
+            }
+
+            output[i] = 0.5f * x;
+            time += 1.0 / sampleRate;
+        }
+    }
+
+private:
+    TestSignal signal;
+    double sampleRate;
+    double time = 0.0;
+    juce::Random random{12345};
+};
+
+double elapsedNs(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+//==============================================================================
+// Panel frames
+//==============================================================================
+
+/**
+ * Render one panel configuration frame by frame: push a frame's worth of
+ * probe audio, run the panel's timer update, then paint into an offscreen
+ * image. Update and paint are timed separately, one sample per frame.
+ */
+void benchmarkPanel(BenchmarkRunner& runner, const PanelRegistry::PanelInfo& info,
+                    const SignalInfo& signalInfo, double sampleRate, FrameSize size, float scale)
+{
+    const std::string name = "panel/" + info.typeId + "/" + signalInfo.name + "/"
+                           + std::to_string(static_cast<int>(sampleRate / 1000.0)) + "k/"
+                           + std::to_string(size.width) + "x" + std::to_string(size.height) + "@"
+                           + std::to_string(static_cast<int>(scale)) + "x";
+
+    if (!runner.isEnabled(name + "/update") && !runner.isEnabled(name + "/paint"))
+        return;
+
+    ProbeManager probeManager;
+    probeManager.prepare(sampleRate);
+    probeManager.setActiveProbe(ProbePoint::Output);
+    probeManager.setVoiceMode(VoiceMode::Mix);
+
+    SignalGenerator generator(signalInfo.signal, sampleRate);
+    const auto frequencies = generator.getFrequencies();
+    for (size_t v = 0; v < frequencies.size(); ++v)
+        probeManager.setVoiceFrequency(static_cast<int>(v), frequencies[v]);
+    if (!frequencies.empty())
+        probeManager.setActiveFrequency(frequencies.front());
+
+    auto panel = PanelRegistry::getInstance().createPanel(info.typeId, probeManager);
+    if (panel == nullptr)
+        return;
+
+    // Frames are driven by hand; there is no message loop to run the timer
+    panel->stopTimer();
+    panel->setSampleRate(static_cast<float>(sampleRate));
+    panel->setBounds(0, 0, size.width, size.height);
+    panel->setVisible(true);
+
+    juce::Image image(juce::Image::ARGB,
+                      juce::roundToInt(static_cast<float>(size.width) * scale),
+                      juce::roundToInt(static_cast<float>(size.height) * scale), true);
+
+    const int samplesPerFrame = static_cast<int>(sampleRate) / FramesPerSecond;
+    std::vector<float> frame(static_cast<size_t>(samplesPerFrame));
+
+    std::vector<double> updateNs, paintNs;
+    double totalNs = 0.0;
+    const double minNs = runner.getSettings().minSecondsPerBenchmark * 1.0e9;
+
+    for (int f = 0; f < MaxFrames; ++f) {
+        generator.fill(frame.data(), samplesPerFrame);
+        probeManager.getProbeBuffer().push(frame.data(), samplesPerFrame);
+        probeManager.getMixProbeBuffer().push(frame.data(), samplesPerFrame);
+
+        const auto start = std::chrono::steady_clock::now();
+        panel->timerCallback();
+        const auto updated = std::chrono::steady_clock::now();
+        {
+            juce::Graphics g(image);
+            g.addTransform(juce::AffineTransform::scale(scale));
+            panel->paintEntireComponent(g, false);
+        }
+        const auto painted = std::chrono::steady_clock::now();
+
+        if (f < WarmupFrames)
+            continue;
+
+        updateNs.push_back(elapsedNs(start, updated));
+        paintNs.push_back(elapsedNs(updated, painted));
+        totalNs += elapsedNs(start, painted);
+
+        if (totalNs >= minNs && static_cast<int>(paintNs.size()) >= MinFrames)
+            break;
+    }
+
+    const double pixels = static_cast<double>(image.getWidth()) * image.getHeight();
+    runner.addSamples(name + "/update", std::move(updateNs), samplesPerFrame);
+    runner.addSamples(name + "/paint", std::move(paintNs), pixels);
+}
+
+} // namespace
+
+/**
+ * Offscreen frame cost of every registered visualization panel.
+ */
+void runPanelBenchmarks(BenchmarkRunner& runner)
+{
+    for (const auto& info : PanelRegistry::getInstance().getAvailablePanels())
+        for (const auto& signal : Signals)
+            for (double sampleRate : SampleRates)
+                for (auto size : Sizes)
+                    for (float scale : Scales)
+                        benchmarkPanel(runner, info, signal, sampleRate, size, scale);
+}
+
+} // namespace vizasynth
@@ -0,0 +1,50 @@
+# Build the preset bank the plugin loads from config/presets.vzbank.
+# Programs are listed in config/presets.json with plain parameter values
+# (Hz, dB, seconds, choice index, 0/1 for switches) by parameter ID; every
+# program lists the same parameters. Writes the "VZBK" version 1 layout
+# described in src/Core/PresetBank.h.
+# Example usage:
+#   python make_preset_bank.py
+#   python make_preset_bank.py ../config/presets.json ../config/presets.vzbank
+
+import json
+import os
+import struct
+import sys
+
+config_dir = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'config')
+source = sys.argv[1] if len(sys.argv) > 1 else os.path.join(config_dir, 'presets.json')
+target = sys.argv[2] if len(sys.argv) > 2 else os.path.join(config_dir, 'presets.vzbank')
+
+with open(source) as f:
+    programs = json.load(f)['programs']
+
+# Parameters are matched by ID when the bank loads, so the column order is
+# free; IDs the plugin doesn't know are skipped, missing ones get defaults
+parameter_ids = list(programs[0]['parameters'].keys())
+for program in programs:
+    if set(program['parameters'].keys()) != set(parameter_ids):
+        sys.exit(f"Program '{program['name']}' does not list the same parameters as '{programs[0]['name']}'")
+
+
+def short_string(text):
+    data = text.encode('utf-8')
+    if len(data) > 255:
+        sys.exit(f"'{text}' is longer than 255 bytes")
+    return struct.pack('<B', len(data)) + data
+
+
+bank = bytearray(b'VZBK')
+bank += struct.pack('<HHI', 1, len(parameter_ids), len(programs))
+for parameter_id in parameter_ids:
+    bank += short_string(parameter_id)
+
+for program in programs:
+    bank += short_string(program['name'])
+    for parameter_id in parameter_ids:
+        bank += struct.pack('<f', float(program['parameters'][parameter_id]))
+
+with open(target, 'wb') as f:
+    f.write(bank)
+
+print(f"Wrote {len(programs)} programs with {len(parameter_ids)} parameters to {target}")
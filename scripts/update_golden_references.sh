@@ -0,0 +1,44 @@
+#!/usr/bin/env bash
+# Regenerate the golden references in tests/golden from a known-good revision.
+#
+#   scripts/update_golden_references.sh [ref] [build-type]
+#
+# Builds VizASynth_GoldenTests from <ref> (default HEAD) in a temporary
+# worktree, using this checkout's tests/ so that every current scenario is
+# rendered, and writes the references into this checkout's tests/golden.
+# Render from the last revision whose sound you trust, then run the tests at
+# HEAD to compare against it. Needs the same toolchain and JUCE as a normal build.
+set -euo pipefail
+
+ref="${1:-HEAD}"
+build_type="${2:-Release}"
+
+repo="$(git -C "$(dirname "$0")" rev-parse --show-toplevel)"
+worktree="$(mktemp -d "${TMPDIR:-/tmp}/vizasynth-golden.XXXXXX")"
+
+cleanup() {
+    git -C "$repo" worktree remove --force "$worktree" >/dev/null 2>&1 || true
+    rm -rf "$worktree"
+}
+trap cleanup EXIT
+
+git -C "$repo" worktree add --detach "$worktree" "$ref" >/dev/null
+
+# Scenarios and harness come from this checkout, the engine from <ref>
+rm -rf "$worktree/tests"
+cp -R "$repo/tests" "$worktree/tests"
+
+cmake -S "$worktree" -B "$worktree/build" \
+    -DVIZASYNTH_BUILD_TESTS=ON -DCMAKE_BUILD_TYPE="$build_type"
+cmake --build "$worktree/build" --config "$build_type" --target VizASynth_GoldenTests -j
+
+runner="$(find "$worktree/build" -type f -perm -u+x -name 'VizASynth_GoldenTests*' | head -n 1)"
+if [ -z "$runner" ]; then
+    echo "VizASynth_GoldenTests was not built" >&2
+    exit 1
+fi
+
+"$runner" --update --golden-dir "$repo/tests/golden"
+
+echo "References from $(git -C "$repo" rev-parse --short "$ref") written to tests/golden."
+echo "Review with 'git status tests/golden' and commit them."
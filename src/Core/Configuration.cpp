@@ -28,6 +28,8 @@ public:
         stopTimer();
     }
 
+    const juce::File& getDirectory() const { return configDir; }
+
 private:
     void timerCallback() override {
         bool changed = false;
@@ -259,9 +261,23 @@ bool ConfigurationManager::loadThemeConfig(const juce::File& file)
 
 bool ConfigurationManager::loadFromDirectory(const juce::File& configDir)
 {
+    auto layoutFile = configDir.getChildFile("layout.json");
+    auto themeFile = configDir.getChildFile("theme.json");
+    auto layoutTime = layoutFile.getLastModificationTime();
+    auto themeTime = themeFile.getLastModificationTime();
+
+    // Every plugin instance loads the same directory; parse it once per change
+    if (configDir == loadedDirectory && layoutTime == loadedLayoutTime && themeTime == loadedThemeTime)
+        return lastLoadSucceeded;
+
     bool loaded = false;
-    loaded |= loadLayoutConfig(configDir.getChildFile("layout.json"));
-    loaded |= loadThemeConfig(configDir.getChildFile("theme.json"));
+    loaded |= loadLayoutConfig(layoutFile);
+    loaded |= loadThemeConfig(themeFile);
+
+    loadedDirectory = configDir;
+    loadedLayoutTime = layoutTime;
+    loadedThemeTime = themeTime;
+    lastLoadSucceeded = loaded;
     return loaded;
 }
 
@@ -527,6 +543,10 @@ float ConfigurationManager::getSampleRate() const
 #if JUCE_DEBUG
 void ConfigurationManager::enableFileWatching(const juce::File& configDir)
 {
+    // Already watching it for another plugin instance
+    if (fileWatcher != nullptr && fileWatcher->getDirectory() == configDir)
+        return;
+
     fileWatcher = std::make_unique<FileWatcher>(*this, configDir);
 }
 
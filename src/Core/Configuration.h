@@ -70,7 +70,8 @@ public:
 
     /**
      * Load all configuration from a directory.
-     * Looks for layout.json and theme.json in the directory.
+     * Looks for layout.json and theme.json in the directory. Files unchanged
+     * since the last call (e.g. from another plugin instance) aren't parsed again.
      * @param configDir The configuration directory
      * @return true if at least one config was loaded
      */
@@ -250,6 +251,12 @@ private:
     juce::ValueTree themeTree;
     float currentSampleRate = 44100.0f;
 
+    // What loadFromDirectory() last parsed, so repeat loads are free
+    juce::File loadedDirectory;
+    juce::Time loadedLayoutTime;
+    juce::Time loadedThemeTime;
+    bool lastLoadSucceeded = false;
+
 #if JUCE_DEBUG
     class FileWatcher;
     std::unique_ptr<FileWatcher> fileWatcher;
@@ -0,0 +1,161 @@
+#include "DspLoadMonitor.h"
+#include <cmath>
+
+namespace vizasynth {
+
+#if VIZASYNTH_DSP_LOAD_MONITOR
+namespace {
+
+/**
+ * Counter rate measured against steady_clock. A few milliseconds is plenty
+ * for percent-level accuracy; the rate is a property of the machine, so the
+ * busy-wait runs once per process rather than on every prepareToPlay.
+ */
+double measureTicksPerSecond()
+{
+    using Clock = std::chrono::steady_clock;
+    const auto clockStart = Clock::now();
+    const DspLoadMonitor::Ticks tickStart = DspLoadMonitor::now();
+
+    Clock::time_point clockEnd;
+    do {
+        clockEnd = Clock::now();
+    } while (clockEnd - clockStart < std::chrono::milliseconds(5));
+
+    const DspLoadMonitor::Ticks tickEnd = DspLoadMonitor::now();
+    const double seconds = std::chrono::duration<double>(clockEnd - clockStart).count();
+    const double rate = static_cast<double>(tickEnd - tickStart) / seconds;
+
+    return rate > 0.0 ? rate : 1.0e9;
+}
+
+} // namespace
+#endif
+
+//=============================================================================
+// Counters
+//=============================================================================
+
+void DspLoadMonitor::Counters::add(Ticks ticks) noexcept
+{
+    // Only the audio thread writes, so load/store avoids locked RMW instructions
+    calls.store(calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    totalTicks.store(totalTicks.load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+
+    if (ticks > maxTicks.load(std::memory_order_relaxed))
+        maxTicks.store(ticks, std::memory_order_relaxed);
+
+    int bucket = 0;
+    for (Ticks t = ticks; t > 1 && bucket < NumBuckets - 1; t >>= 1)
+        ++bucket;
+
+    auto& counter = buckets[static_cast<size_t>(bucket)];
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void DspLoadMonitor::Counters::clear() noexcept
+{
+    calls.store(0);
+    totalTicks.store(0);
+    maxTicks.store(0);
+    for (auto& counter : buckets)
+        counter.store(0);
+}
+
+DspLoadMonitor::Stats DspLoadMonitor::Counters::toStats(double ticksPerSecond) const
+{
+    Stats stats;
+    stats.calls = calls.load(std::memory_order_relaxed);
+    stats.totalSeconds = static_cast<double>(totalTicks.load(std::memory_order_relaxed)) / ticksPerSecond;
+    stats.maxSeconds = static_cast<double>(maxTicks.load(std::memory_order_relaxed)) / ticksPerSecond;
+
+    for (size_t i = 0; i < buckets.size(); ++i)
+        stats.histogram[i] = buckets[i].load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+//=============================================================================
+// DspLoadMonitor
+//=============================================================================
+
+void DspLoadMonitor::prepare(double newSampleRate)
+{
+    // With the timers compiled out nothing is ever measured, so skip the calibration
+   #if VIZASYNTH_DSP_LOAD_MONITOR
+    static const double calibratedTicksPerSecond = measureTicksPerSecond();
+    ticksPerSecond.store(calibratedTicksPerSecond);
+   #endif
+
+    sampleRate.store(newSampleRate);
+    ticksPerSample.store(ticksPerSecond.load() / newSampleRate);
+
+    reset();
+}
+
+void DspLoadMonitor::reset()
+{
+    for (auto& stage : stages)
+        stage.clear();
+
+    block.clear();
+    xruns.store(0);
+    processedSamples.store(0);
+    worstBlockLoad.store(0.0);
+}
+
+void DspLoadMonitor::recordBlock(Ticks ticks, int numSamples) noexcept
+{
+    block.add(ticks);
+    processedSamples.store(processedSamples.load(std::memory_order_relaxed) + static_cast<uint64_t>(numSamples),
+                           std::memory_order_relaxed);
+
+    if (numSamples <= 0)
+        return;
+
+    // Deadline: the block has to be produced in less time than it lasts
+    const double deadline = static_cast<double>(numSamples) * ticksPerSample.load(std::memory_order_relaxed);
+    const double load = static_cast<double>(ticks) / deadline;
+
+    if (load > worstBlockLoad.load(std::memory_order_relaxed))
+        worstBlockLoad.store(load, std::memory_order_relaxed);
+
+    if (load > 1.0)
+        xruns.store(xruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+DspLoadMonitor::Snapshot DspLoadMonitor::getSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.ticksPerSecond = ticksPerSecond.load();
+    snapshot.sampleRate = sampleRate.load();
+
+    for (size_t i = 0; i < stages.size(); ++i)
+        snapshot.stages[i] = stages[i].toStats(snapshot.ticksPerSecond);
+
+    snapshot.block = block.toStats(snapshot.ticksPerSecond);
+    snapshot.xruns = xruns.load(std::memory_order_relaxed);
+    snapshot.processedSamples = processedSamples.load(std::memory_order_relaxed);
+    snapshot.worstBlockLoad = worstBlockLoad.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+double DspLoadMonitor::getBucketSeconds(int bucket, double ticksPerSecond)
+{
+    return std::ldexp(1.0, bucket) / ticksPerSecond;
+}
+
+const char* DspLoadMonitor::getStageName(DspStage stage)
+{
+    switch (stage) {
+        case DspStage::MidiMerge:       return "MIDI merge";
+        case DspStage::ParameterUpdate: return "Parameters";
+        case DspStage::VoiceRender:     return "Voices";
+        case DspStage::Effects:         return "Effects";
+        case DspStage::OutputStage:     return "Output stage";
+        case DspStage::ProbeWrite:      return "Probe writes";
+        default:                        return "?";
+    }
+}
+
+} // namespace vizasynth
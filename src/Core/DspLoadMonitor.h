@@ -0,0 +1,231 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+ #if defined(_MSC_VER)
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+#ifndef VIZASYNTH_DSP_LOAD_MONITOR
+ #define VIZASYNTH_DSP_LOAD_MONITOR 1
+#endif
+
+namespace vizasynth {
+
+/**
+ * Audio-thread stages timed by DspLoadMonitor.
+ */
+enum class DspStage {
+    MidiMerge,        // Injected MIDI merge and note tracking
+    ParameterUpdate,  // Pushing parameters to the voices
+    VoiceRender,      // Each voice's renderNextBlock
+    Effects,          // Chorus, delay and reverb on the effects bus
+    OutputStage,      // Master gain, metering and bus expansion
+    ProbeWrite,       // Copies into the probe buffers
+    NumStages
+};
+
+/**
+ * DspLoadMonitor - Per-stage audio-thread timing with lock-free histograms
+ *
+ * Scoped timers read the CPU timestamp counter (x86 TSC, ARM virtual counter,
+ * steady_clock elsewhere) and record exclusive time: a stage nested inside
+ * another is subtracted from its parent, so stage times add up to the block.
+ * Time not covered by any stage (e.g. the Synthesiser's own MIDI handling)
+ * is reported as the remainder of the block total.
+ *
+ * Each stage keeps call count, total, maximum and a log2 histogram in
+ * atomics written only by the audio thread; the UI reads them at any time.
+ * A block that takes longer than its own duration counts as an xrun.
+ *
+ * Compile with VIZASYNTH_DSP_LOAD_MONITOR=0 to remove every timer: the
+ * VIZASYNTH_DSP_BLOCK / VIZASYNTH_DSP_STAGE macros then expand to nothing.
+ */
+class DspLoadMonitor {
+public:
+    static constexpr int NumStages = static_cast<int>(DspStage::NumStages);
+    static constexpr int NumBuckets = 32;  // Bucket b holds durations in [2^b, 2^(b+1)) ticks
+
+    using Ticks = uint64_t;
+
+    /**
+     * Statistics for one stage (or the whole block), converted to seconds.
+     */
+    struct Stats {
+        uint64_t calls = 0;
+        double totalSeconds = 0.0;
+        double maxSeconds = 0.0;
+        std::array<uint32_t, NumBuckets> histogram{};
+    };
+
+    /**
+     * Consistent-enough copy of all counters for display.
+     */
+    struct Snapshot {
+        std::array<Stats, NumStages> stages;
+        Stats block;
+        uint64_t xruns = 0;
+        uint64_t processedSamples = 0;
+        double sampleRate = 0.0;
+        double ticksPerSecond = 1.0;
+        double worstBlockLoad = 0.0;  // Largest block time / block duration
+    };
+
+    DspLoadMonitor() = default;
+
+    /**
+     * Calibrate the tick rate and reset counters. Call from prepareToPlay.
+     */
+    void prepare(double sampleRate);
+
+    /**
+     * Reset all counters (message thread; racing blocks may be half counted).
+     */
+    void reset();
+
+    /**
+     * Read the counters (any thread).
+     */
+    Snapshot getSnapshot() const;
+
+    /**
+     * Lower edge of a histogram bucket in seconds.
+     */
+    static double getBucketSeconds(int bucket, double ticksPerSecond);
+
+    static const char* getStageName(DspStage stage);
+
+    static Ticks now() noexcept {
+       #if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        return static_cast<Ticks>(__rdtsc());
+       #elif defined(__aarch64__)
+        Ticks value;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+       #else
+        return static_cast<Ticks>(std::chrono::steady_clock::now().time_since_epoch().count());
+       #endif
+    }
+
+    //=========================================================================
+    // Scoped timers (use the macros below)
+    //=========================================================================
+
+    /**
+     * Times a whole processBlock and makes the monitor current for any
+     * stage timers on this thread.
+     */
+    class ScopedBlock {
+    public:
+        ScopedBlock(DspLoadMonitor& m, int numSamples) noexcept
+            : monitor(m), previous(current), savedChildTicks(childTicks),
+              blockSamples(numSamples), start(now()) {
+            current = &monitor;
+            childTicks = 0;
+        }
+
+        ~ScopedBlock() noexcept {
+            const Ticks elapsed = now() - start;
+            monitor.recordBlock(elapsed, blockSamples);
+            current = previous;
+            childTicks = savedChildTicks;
+        }
+
+        ScopedBlock(const ScopedBlock&) = delete;
+        ScopedBlock& operator=(const ScopedBlock&) = delete;
+
+    private:
+        DspLoadMonitor& monitor;
+        DspLoadMonitor* previous;
+        Ticks savedChildTicks;
+        int blockSamples;
+        Ticks start;
+    };
+
+    /**
+     * Times one stage against the current block's monitor; no-op outside a block.
+     */
+    class ScopedStage {
+    public:
+        explicit ScopedStage(DspStage s) noexcept
+            : monitor(current), stage(s), savedChildTicks(childTicks), start(0) {
+            if (monitor != nullptr) {
+                childTicks = 0;
+                start = now();
+            }
+        }
+
+        ~ScopedStage() noexcept {
+            if (monitor == nullptr)
+                return;
+
+            const Ticks elapsed = now() - start;
+            const Ticks exclusive = elapsed > childTicks ? elapsed - childTicks : 0;
+            monitor->recordStage(stage, exclusive);
+            childTicks = savedChildTicks + elapsed;
+        }
+
+        ScopedStage(const ScopedStage&) = delete;
+        ScopedStage& operator=(const ScopedStage&) = delete;
+
+    private:
+        DspLoadMonitor* monitor;
+        DspStage stage;
+        Ticks savedChildTicks;
+        Ticks start;
+    };
+
+private:
+    /**
+     * Single-writer counters: the audio thread stores, readers load.
+     */
+    struct Counters {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> totalTicks{0};
+        std::atomic<uint64_t> maxTicks{0};
+        std::array<std::atomic<uint32_t>, NumBuckets> buckets{};
+
+        void add(Ticks ticks) noexcept;
+        void clear() noexcept;
+        Stats toStats(double ticksPerSecond) const;
+    };
+
+    void recordStage(DspStage stage, Ticks ticks) noexcept {
+        stages[static_cast<size_t>(stage)].add(ticks);
+    }
+
+    void recordBlock(Ticks ticks, int numSamples) noexcept;
+
+    std::array<Counters, NumStages> stages;
+    Counters block;
+    std::atomic<uint64_t> xruns{0};
+    std::atomic<uint64_t> processedSamples{0};
+    std::atomic<double> worstBlockLoad{0.0};
+    std::atomic<double> sampleRate{44100.0};
+    std::atomic<double> ticksPerSecond{1.0e9};
+    std::atomic<double> ticksPerSample{1.0e9 / 44100.0};
+
+    static inline thread_local DspLoadMonitor* current = nullptr;
+    static inline thread_local Ticks childTicks = 0;
+};
+
+} // namespace vizasynth
+
+#if VIZASYNTH_DSP_LOAD_MONITOR
+ #define VIZASYNTH_DSP_CONCAT_INNER(a, b) a##b
+ #define VIZASYNTH_DSP_CONCAT(a, b) VIZASYNTH_DSP_CONCAT_INNER(a, b)
+ #define VIZASYNTH_DSP_BLOCK(monitor, numSamples) \
+     ::vizasynth::DspLoadMonitor::ScopedBlock VIZASYNTH_DSP_CONCAT(dspLoadBlock_, __LINE__)(monitor, numSamples)
+ #define VIZASYNTH_DSP_STAGE(stage) \
+     ::vizasynth::DspLoadMonitor::ScopedStage VIZASYNTH_DSP_CONCAT(dspLoadStage_, __LINE__)(::vizasynth::DspStage::stage)
+#else
+ #define VIZASYNTH_DSP_BLOCK(monitor, numSamples)
+ #define VIZASYNTH_DSP_STAGE(stage)
+#endif
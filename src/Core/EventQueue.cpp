@@ -0,0 +1,171 @@
+#include "EventQueue.h"
+#include <algorithm>
+#include <cmath>
+
+namespace vizasynth {
+
+//=============================================================================
+// TimedEvent
+//=============================================================================
+
+TimedEvent TimedEvent::midiEvent(int64_t sampleTime, const juce::MidiMessage& message)
+{
+    TimedEvent event;
+    event.sampleTime = sampleTime;
+    event.type = Type::Midi;
+
+    const int size = message.getRawDataSize();
+    if (size <= static_cast<int>(sizeof(event.midi))) {
+        event.midiSize = static_cast<uint8_t>(size);
+        std::copy(message.getRawData(), message.getRawData() + size, event.midi);
+    }
+
+    return event;
+}
+
+TimedEvent TimedEvent::parameterEvent(int64_t sampleTime, int parameterIndex, float previousValue, float value)
+{
+    TimedEvent event;
+    event.sampleTime = sampleTime;
+    event.type = Type::Parameter;
+    event.parameterIndex = parameterIndex;
+    event.previousValue = previousValue;
+    event.value = value;
+    return event;
+}
+
+//=============================================================================
+// Setup
+//=============================================================================
+
+void EventQueue::prepare(double sampleRate)
+{
+    const juce::SpinLock::ScopedLockType lock(producerLock);
+
+    fifo.reset();
+    numPending = 0;
+    numDue = 0;
+    clockSampleRate.store(sampleRate);
+}
+
+//=============================================================================
+// Producers
+//=============================================================================
+
+bool EventQueue::push(const TimedEvent& event)
+{
+    const juce::SpinLock::ScopedLockType lock(producerLock);
+
+    const auto scope = fifo.write(1);
+    if (scope.blockSize1 + scope.blockSize2 == 0) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    incoming[static_cast<size_t>(scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)] = event;
+    return true;
+}
+
+int64_t EventQueue::getScheduleTime() const
+{
+    uint32_t sequence;
+    int64_t sample;
+    double millis;
+    int size;
+
+    do {
+        sequence = clockSequence.load(std::memory_order_acquire);
+        sample = clockSample.load();
+        millis = clockMillis.load();
+        size = clockBlockSize.load();
+    } while ((sequence & 1) != 0 || sequence != clockSequence.load(std::memory_order_acquire));
+
+    // No block processed yet: apply at the start of the first one
+    if (sequence == 0)
+        return sample;
+
+    const double elapsedMs = juce::Time::getMillisecondCounterHiRes() - millis;
+    const auto elapsedSamples = static_cast<int64_t>(std::llround(elapsedMs * clockSampleRate.load() / 1000.0));
+
+    // More than a block since the last block started means the audio thread
+    // is late or stopped: the next block hasn't arrived when it was due
+    if (elapsedSamples > size)
+        return sample + size;
+
+    return sample + elapsedSamples + size;
+}
+
+int64_t EventQueue::getNextBlockStart() const
+{
+    uint32_t sequence;
+    int64_t sample;
+    int size;
+
+    do {
+        sequence = clockSequence.load(std::memory_order_acquire);
+        sample = clockSample.load();
+        size = clockBlockSize.load();
+    } while ((sequence & 1) != 0 || sequence != clockSequence.load(std::memory_order_acquire));
+
+    return sample + size;
+}
+
+//=============================================================================
+// Audio thread
+//=============================================================================
+
+void EventQueue::beginBlock(int64_t blockStartSample, int numSamples)
+{
+    blockStart = blockStartSample;
+    blockSize = numSamples;
+
+    clockSequence.fetch_add(1, std::memory_order_acq_rel);
+    clockSample.store(blockStartSample);
+    clockMillis.store(juce::Time::getMillisecondCounterHiRes());
+    clockBlockSize.store(numSamples);
+    clockSequence.fetch_add(1, std::memory_order_acq_rel);
+
+    // Collect everything queued since the last block
+    const auto scope = fifo.read(fifo.getNumReady());
+    for (int i = 0; i < scope.blockSize1; ++i)
+        insertPending(incoming[static_cast<size_t>(scope.startIndex1 + i)]);
+    for (int i = 0; i < scope.blockSize2; ++i)
+        insertPending(incoming[static_cast<size_t>(scope.startIndex2 + i)]);
+
+    numDue = 0;
+    while (numDue < numPending && isInCurrentBlock(pending[static_cast<size_t>(numDue)]))
+        ++numDue;
+}
+
+int EventQueue::getBlockOffset(const TimedEvent& event) const
+{
+    return static_cast<int>(juce::jlimit<int64_t>(0, juce::jmax(0, blockSize - 1), event.sampleTime - blockStart));
+}
+
+void EventQueue::endBlock()
+{
+    std::move(pending.begin() + numDue, pending.begin() + numPending, pending.begin());
+    numPending -= numDue;
+    numDue = 0;
+}
+
+void EventQueue::insertPending(const TimedEvent& event)
+{
+    if (numPending == Capacity) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Events mostly arrive in time order, so this is usually an append;
+    // equal times keep their arrival order
+    int position = numPending;
+    while (position > 0 && pending[static_cast<size_t>(position - 1)].sampleTime > event.sampleTime) {
+        pending[static_cast<size_t>(position)] = pending[static_cast<size_t>(position - 1)];
+        --position;
+    }
+
+    pending[static_cast<size_t>(position)] = event;
+    ++numPending;
+}
+
+} // namespace vizasynth
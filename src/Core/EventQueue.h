@@ -0,0 +1,146 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace vizasynth {
+
+/**
+ * One timestamped event for the audio thread: a short MIDI message (the
+ * virtual keyboard) or a parameter change (knobs, presets, state loads).
+ */
+struct TimedEvent {
+    enum class Type : uint8_t { Midi, Parameter };
+
+    int64_t sampleTime = 0;  // On the processor's sample clock
+    Type type = Type::Midi;
+
+    // Midi
+    uint8_t midiSize = 0;
+    uint8_t midi[3] = {};
+
+    // Parameter (plain values)
+    int parameterIndex = -1;
+    float previousValue = 0.0f;
+    float value = 0.0f;
+
+    static TimedEvent midiEvent(int64_t sampleTime, const juce::MidiMessage& message);
+    static TimedEvent parameterEvent(int64_t sampleTime, int parameterIndex, float previousValue, float value);
+};
+
+/**
+ * EventQueue - Timestamped event stream from the UI into the audio thread
+ *
+ * Producers stamp events against a sample clock that the audio thread
+ * publishes at the start of every block (block start sample and wall time).
+ * An event created now is scheduled one block ahead of the estimated
+ * current sample, so it always reaches the audio thread in time and lands at
+ * a constant delay instead of jittering with the buffer position.
+ *
+ * Producers are serialised by a spin lock that the audio thread never takes;
+ * the audio thread drains them into a time-ordered pending list and consumes
+ * the events that fall inside each block. Events arriving while the queue is
+ * full are dropped and counted.
+ */
+class EventQueue {
+public:
+    static constexpr int Capacity = 1024;
+
+    EventQueue() = default;
+
+    /**
+     * Clear all events and set the clock rate. Must not run concurrently
+     * with beginBlock/endBlock.
+     */
+    void prepare(double sampleRate);
+
+    //=========================================================================
+    // Producers (any thread except the audio thread)
+    //=========================================================================
+
+    /**
+     * Queue an event.
+     * @return false if the queue was full and the event was dropped
+     */
+    bool push(const TimedEvent& event);
+
+    /**
+     * Sample time for an event created now: the estimated current sample
+     * plus one block. If the audio thread has stalled or stopped, events go
+     * to the start of the next block instead.
+     */
+    int64_t getScheduleTime() const;
+
+    /**
+     * First sample of the block after the current one (events stamped here
+     * are applied at the very start of the next block).
+     */
+    int64_t getNextBlockStart() const;
+
+    uint64_t getDroppedEventCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    //=========================================================================
+    // Audio thread
+    //=========================================================================
+
+    /**
+     * Publish the clock for a new block and collect queued events.
+     */
+    void beginBlock(int64_t blockStartSample, int numSamples);
+
+    /**
+     * Events not yet consumed, in time order. The first getNumDue() of
+     * them fall inside the current block; the rest are for later blocks.
+     */
+    int getNumPending() const { return numPending; }
+    int getNumDue() const { return numDue; }
+    const TimedEvent& getPending(int index) const { return pending[static_cast<size_t>(index)]; }
+
+    /**
+     * Offset of an event within the current block (late events map to 0).
+     */
+    int getBlockOffset(const TimedEvent& event) const;
+
+    bool isInCurrentBlock(const TimedEvent& event) const {
+        return event.sampleTime < blockStart + blockSize;
+    }
+
+    bool isDueAtBlockStart(const TimedEvent& event) const {
+        return event.sampleTime <= blockStart;
+    }
+
+    /**
+     * Drop the events that were due in the current block.
+     */
+    void endBlock();
+
+private:
+    void insertPending(const TimedEvent& event);
+
+    // Producer side
+    juce::SpinLock producerLock;
+    juce::AbstractFifo fifo{Capacity};
+    std::array<TimedEvent, Capacity> incoming;
+
+    // Audio thread side
+    std::array<TimedEvent, Capacity> pending;
+    int numPending = 0;
+    int numDue = 0;
+    int64_t blockStart = 0;
+    int blockSize = 0;
+
+    // Sample clock, published by beginBlock under a sequence counter
+    std::atomic<uint32_t> clockSequence{0};
+    std::atomic<int64_t> clockSample{0};
+    std::atomic<double> clockMillis{0.0};
+    std::atomic<int> clockBlockSize{0};
+    std::atomic<double> clockSampleRate{44100.0};
+
+    std::atomic<uint64_t> dropped{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EventQueue)
+};
+
+} // namespace vizasynth
@@ -0,0 +1,168 @@
+#include "PluginState.h"
+#include <cstring>
+
+namespace vizasynth {
+
+namespace {
+
+juce::RangedAudioParameter* asRanged(juce::AudioProcessorParameter* parameter)
+{
+    return dynamic_cast<juce::RangedAudioParameter*>(parameter);
+}
+
+} // namespace
+
+//=============================================================================
+// Writing
+//=============================================================================
+
+void PluginState::write(const juce::AudioProcessor& processor, const juce::ValueTree& state,
+                        juce::MemoryBlock& destData)
+{
+    juce::Array<juce::RangedAudioParameter*> parameters;
+    for (auto* parameter : processor.getParameters())
+        if (auto* ranged = asRanged(parameter); ranged != nullptr && ranged->getParameterID().getNumBytesAsUTF8() <= 255)
+            parameters.add(ranged);
+
+    juce::MemoryOutputStream out(destData, false);
+    out.write(Magic, sizeof(Magic));
+    out.writeShort(static_cast<short>(CurrentVersion));
+    out.writeShort(static_cast<short>(parameters.size()));
+
+    for (auto* parameter : parameters) {
+        const auto id = parameter->getParameterID().toRawUTF8();
+        const auto idLength = std::strlen(id);
+
+        out.writeByte(static_cast<char>(idLength));
+        out.write(id, idLength);
+        out.writeFloat(parameter->convertFrom0to1(parameter->getValue()));
+    }
+
+    // Version 2: everything in the state tree that is not a parameter
+    juce::ValueTree properties(state.getType());
+    properties.copyPropertiesFrom(state, nullptr);
+    for (const auto& child : state)
+        if (!child.hasType(ParameterType))
+            properties.appendChild(child.createCopy(), nullptr);
+
+    juce::MemoryOutputStream tree;
+    properties.writeToStream(tree);
+    out.writeInt(static_cast<int>(tree.getDataSize()));
+    out.write(tree.getData(), tree.getDataSize());
+}
+
+//=============================================================================
+// Reading
+//=============================================================================
+
+bool PluginState::isBinaryState(const void* data, int sizeInBytes)
+{
+    return data != nullptr && sizeInBytes >= HeaderSize
+        && std::memcmp(data, Magic, sizeof(Magic)) == 0;
+}
+
+bool PluginState::read(const void* data, int sizeInBytes, std::vector<Value>& values,
+                       juce::ValueTree& properties)
+{
+    if (!isBinaryState(data, sizeInBytes))
+        return false;
+
+    juce::MemoryInputStream in(data, static_cast<size_t>(sizeInBytes), false);
+    in.skipNextBytes(sizeof(Magic));
+
+    const auto version = static_cast<uint16_t>(in.readShort());
+    if (version == 0)
+        return false;
+
+    const auto count = static_cast<uint16_t>(in.readShort());
+    values.clear();
+    values.reserve(count);
+
+    for (uint16_t i = 0; i < count; ++i) {
+        const int idLength = static_cast<uint8_t>(in.readByte());
+        if (in.getNumBytesRemaining() < idLength + static_cast<juce::int64>(sizeof(float)))
+            return false;
+
+        char id[256];
+        in.read(id, idLength);
+
+        Value value;
+        value.paramId = juce::String::fromUTF8(id, idLength);
+        value.value = in.readFloat();
+        values.push_back(std::move(value));
+    }
+
+    properties = juce::ValueTree();
+
+    if (version >= 2) {
+        if (in.getNumBytesRemaining() < static_cast<juce::int64>(sizeof(uint32_t)))
+            return false;
+
+        const auto size = static_cast<uint32_t>(in.readInt());
+        if (static_cast<juce::uint64>(in.getNumBytesRemaining()) < size)
+            return false;
+
+        juce::MemoryBlock tree(size);
+        in.read(tree.getData(), static_cast<int>(size));
+        properties = juce::ValueTree::readFromData(tree.getData(), tree.getSize());
+    }
+
+    // Sections added by later versions follow here; this version ignores them
+    return true;
+}
+
+//=============================================================================
+// Applying
+//=============================================================================
+
+void PluginState::apply(juce::AudioProcessor& processor, const std::vector<Value>& values)
+{
+    const auto& parameters = processor.getParameters();
+
+    for (int index = 0; index < parameters.size(); ++index) {
+        auto* ranged = asRanged(parameters[index]);
+        if (ranged == nullptr)
+            continue;
+
+        const auto& id = ranged->getParameterID();
+        float normalised = ranged->getDefaultValue();
+
+        // States written by the same build list parameters in processor order
+        const auto hint = static_cast<size_t>(index);
+        if (hint < values.size() && values[hint].paramId == id) {
+            normalised = ranged->convertTo0to1(values[hint].value);
+        } else {
+            for (const auto& value : values) {
+                if (value.paramId == id) {
+                    normalised = ranged->convertTo0to1(value.value);
+                    break;
+                }
+            }
+        }
+
+        if (ranged->getValue() != normalised)
+            ranged->setValueNotifyingHost(normalised);
+    }
+}
+
+void PluginState::applyProperties(juce::ValueTree& state, const juce::ValueTree& properties)
+{
+    // Missing properties and children revert, as a full replaceState would
+    for (int i = state.getNumProperties(); --i >= 0;)
+        if (!properties.hasProperty(state.getPropertyName(i)))
+            state.removeProperty(state.getPropertyName(i), nullptr);
+
+    for (int i = 0; i < properties.getNumProperties(); ++i) {
+        const auto name = properties.getPropertyName(i);
+        state.setProperty(name, properties.getProperty(name), nullptr);
+    }
+
+    for (int i = state.getNumChildren(); --i >= 0;)
+        if (!state.getChild(i).hasType(ParameterType))
+            state.removeChild(i, nullptr);
+
+    for (const auto& child : properties)
+        state.appendChild(child.createCopy(), nullptr);
+}
+
+} // namespace vizasynth
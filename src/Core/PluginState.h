@@ -0,0 +1,90 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <cstdint>
+#include <vector>
+
+namespace vizasynth {
+
+/**
+ * PluginState - Compact binary plugin state
+ *
+ * Replaces the XML blob from copyXmlToBinary() for host sessions. Layout
+ * (little-endian):
+ *
+ *   char[4]  magic "VZST"
+ *   uint16   format version
+ *   uint16   parameter count
+ *   per parameter:
+ *     uint8  ID length, followed by the ID bytes (no terminator)
+ *     float  plain (denormalised) value
+ *   version 2 onwards:
+ *     uint32 size, followed by the non-parameter ValueTree content
+ *            (properties and children other than PARAM) in
+ *            ValueTree::writeToStream format
+ *
+ * Later versions append sections after the parameter table, so an older
+ * build still restores the parameters it knows. Parameters are matched by
+ * ID; unknown IDs are skipped and parameters missing from the state revert
+ * to their defaults, as a full APVTS restore would.
+ *
+ * Restoring writes the parameter values directly rather than rebuilding the
+ * APVTS ValueTree. The audio thread only reads the parameter atomics, so it
+ * picks the new values up on its next block without taking a lock; nothing
+ * the audio thread waits on is touched. The apply itself is synchronous on
+ * the host's thread, because hosts and the offline renderer expect the
+ * state to be in effect when setStateInformation returns. The non-parameter
+ * properties are the exception: they live in the APVTS tree, which belongs
+ * to the message thread, so the processor hands them over there. Blobs that
+ * are not in this format (older sessions) fall back to XML in the processor.
+ */
+class PluginState {
+public:
+    static constexpr uint16_t CurrentVersion = 2;
+
+    struct Value {
+        juce::String paramId;
+        float value = 0.0f;
+    };
+
+    /**
+     * Write every parameter of the processor to destData, followed by the
+     * properties and non-parameter children of the APVTS state tree.
+     */
+    static void write(const juce::AudioProcessor& processor, const juce::ValueTree& state,
+                      juce::MemoryBlock& destData);
+
+    /**
+     * Check for the binary format magic.
+     */
+    static bool isBinaryState(const void* data, int sizeInBytes);
+
+    /**
+     * Parse a binary state.
+     * @param properties Receives the non-parameter state; left invalid for
+     *                   version 1 states, which have none
+     * @return false if the data is not a readable binary state
+     */
+    static bool read(const void* data, int sizeInBytes, std::vector<Value>& values,
+                     juce::ValueTree& properties);
+
+    /**
+     * Apply parsed values to the processor's parameters. Only parameters
+     * whose value actually changes are touched (and reported to the host).
+     */
+    static void apply(juce::AudioProcessor& processor, const std::vector<Value>& values);
+
+    /**
+     * Replace the non-parameter properties and children of the APVTS state
+     * tree with the restored ones. Message thread only for the live APVTS
+     * tree; a copy may be updated on any thread.
+     */
+    static void applyProperties(juce::ValueTree& state, const juce::ValueTree& properties);
+
+private:
+    static constexpr char Magic[4] = {'V', 'Z', 'S', 'T'};
+    static constexpr int HeaderSize = 8;
+    static constexpr const char* ParameterType = "PARAM";  // APVTS parameter child type
+};
+
+} // namespace vizasynth
@@ -0,0 +1,184 @@
+#include "PresetBank.h"
+#include <cstring>
+
+namespace vizasynth {
+
+namespace {
+
+const char BankMagic[4] = {'V', 'Z', 'B', 'K'};
+
+juce::RangedAudioParameter* asRanged(juce::AudioProcessorParameter* parameter)
+{
+    return dynamic_cast<juce::RangedAudioParameter*>(parameter);
+}
+
+bool readShortString(juce::MemoryInputStream& in, juce::String& result)
+{
+    const int length = static_cast<uint8_t>(in.readByte());
+    if (in.getNumBytesRemaining() < length)
+        return false;
+
+    char bytes[256];
+    in.read(bytes, length);
+    result = juce::String::fromUTF8(bytes, length);
+    return true;
+}
+
+void writeShortString(juce::OutputStream& out, const juce::String& text)
+{
+    const auto length = juce::jmin<size_t>(text.getNumBytesAsUTF8(), 255);
+    out.writeByte(static_cast<char>(length));
+    out.write(text.toRawUTF8(), length);
+}
+
+} // namespace
+
+//=============================================================================
+// Loading
+//=============================================================================
+
+bool PresetBank::load(const juce::File& file, const juce::AudioProcessor& processor)
+{
+    juce::MemoryMappedFile mapped(file, juce::MemoryMappedFile::readOnly);
+    if (mapped.getData() == nullptr || mapped.getSize() < 12
+        || std::memcmp(mapped.getData(), BankMagic, sizeof(BankMagic)) != 0)
+        return false;
+
+    juce::MemoryInputStream in(mapped.getData(), mapped.getSize(), false);
+    in.skipNextBytes(sizeof(BankMagic));
+
+    const auto version = static_cast<uint16_t>(in.readShort());
+    const int fileParameterCount = static_cast<uint16_t>(in.readShort());
+    const auto programCount = static_cast<uint32_t>(in.readInt());
+    if (version == 0)
+        return false;
+
+    // Where each of the file's parameters lives in the processor (-1: unknown)
+    std::vector<int> parameterMap(static_cast<size_t>(fileParameterCount), -1);
+    for (auto& index : parameterMap) {
+        juce::String paramId;
+        if (!readShortString(in, paramId))
+            return false;
+        index = findParameterIndex(processor, paramId);
+    }
+
+    // Programs start from the defaults so missing parameters are well defined
+    const Program defaults = createDefaultProgram(processor, {});
+
+    const auto programBytes = static_cast<juce::int64>(fileParameterCount) * static_cast<juce::int64>(sizeof(float));
+
+    // Every program takes at least its name length byte and its values; a
+    // count the file can't hold is corrupt and must not size the reserve
+    if (static_cast<juce::int64>(programCount) * (programBytes + 1) > in.getNumBytesRemaining())
+        return false;
+
+    std::vector<Program> decoded;
+    decoded.reserve(programCount);
+
+    for (uint32_t p = 0; p < programCount; ++p) {
+        Program program = defaults;
+        if (!readShortString(in, program.name) || in.getNumBytesRemaining() < programBytes)
+            return false;
+
+        for (int index : parameterMap) {
+            const float value = in.readFloat();
+            if (index >= 0)
+                program.values[static_cast<size_t>(index)] = value;
+        }
+
+        decoded.push_back(std::move(program));
+    }
+
+    if (decoded.empty())
+        return false;
+
+    programs = std::move(decoded);
+    return true;
+}
+
+void PresetBank::loadDefaults(const juce::AudioProcessor& processor)
+{
+    programs.clear();
+    programs.push_back(createDefaultProgram(processor, "Init"));
+}
+
+//=============================================================================
+// Writing
+//=============================================================================
+
+bool PresetBank::write(const juce::File& file, const juce::AudioProcessor& processor,
+                       const std::vector<Program>& programsToWrite)
+{
+    const auto& parameters = processor.getParameters();
+
+    juce::MemoryOutputStream out;
+    out.write(BankMagic, sizeof(BankMagic));
+    out.writeShort(static_cast<short>(CurrentVersion));
+    out.writeShort(static_cast<short>(parameters.size()));
+    out.writeInt(static_cast<int>(programsToWrite.size()));
+
+    for (auto* parameter : parameters) {
+        auto* ranged = asRanged(parameter);
+        writeShortString(out, ranged != nullptr ? ranged->getParameterID() : juce::String());
+    }
+
+    for (const auto& program : programsToWrite) {
+        writeShortString(out, program.name);
+        for (int i = 0; i < parameters.size(); ++i)
+            out.writeFloat(static_cast<size_t>(i) < program.values.size() ? program.values[static_cast<size_t>(i)] : 0.0f);
+    }
+
+    return file.replaceWithData(out.getData(), out.getDataSize());
+}
+
+PresetBank::Program PresetBank::createDefaultProgram(const juce::AudioProcessor& processor, const juce::String& name)
+{
+    const auto& parameters = processor.getParameters();
+
+    Program program;
+    program.name = name;
+    program.values.resize(static_cast<size_t>(parameters.size()), 0.0f);
+
+    for (int i = 0; i < parameters.size(); ++i)
+        if (auto* ranged = asRanged(parameters[i]))
+            program.values[static_cast<size_t>(i)] = ranged->convertFrom0to1(ranged->getDefaultValue());
+
+    return program;
+}
+
+PresetBank::Program PresetBank::capture(const juce::AudioProcessor& processor, const juce::String& name)
+{
+    const auto& parameters = processor.getParameters();
+
+    Program program;
+    program.name = name;
+    program.values.resize(static_cast<size_t>(parameters.size()), 0.0f);
+
+    for (int i = 0; i < parameters.size(); ++i)
+        if (auto* ranged = asRanged(parameters[i]))
+            program.values[static_cast<size_t>(i)] = ranged->convertFrom0to1(ranged->getValue());
+
+    return program;
+}
+
+//=============================================================================
+// Access
+//=============================================================================
+
+void PresetBank::setProgramName(int index, const juce::String& name)
+{
+    if (index >= 0 && index < getNumPrograms())
+        programs[static_cast<size_t>(index)].name = name;
+}
+
+int PresetBank::findParameterIndex(const juce::AudioProcessor& processor, const juce::String& paramId)
+{
+    const auto& parameters = processor.getParameters();
+    for (int i = 0; i < parameters.size(); ++i)
+        if (auto* ranged = asRanged(parameters[i]); ranged != nullptr && ranged->getParameterID() == paramId)
+            return i;
+
+    return -1;
+}
+
+} // namespace vizasynth
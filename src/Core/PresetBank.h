@@ -0,0 +1,77 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <cstdint>
+#include <vector>
+
+namespace vizasynth {
+
+/**
+ * PresetBank - Programs decoded from a memory-mapped bank file
+ *
+ * The bank is read once through a memory map and every program is decoded
+ * up front into plain parameter values in the processor's parameter order,
+ * so selecting a program later needs no parsing, lookup or allocation.
+ *
+ * File layout (little-endian):
+ *
+ *   char[4]  magic "VZBK"
+ *   uint16   format version
+ *   uint16   parameter count
+ *   uint32   program count
+ *   per parameter: uint8 ID length, followed by the ID bytes
+ *   per program:   uint8 name length, followed by the name bytes,
+ *                  then one float (plain value) per parameter
+ *
+ * Parameters are matched by ID, so banks survive parameters being added,
+ * removed or reordered; anything the bank doesn't mention gets its default.
+ *
+ * Loading and renaming are message thread operations.
+ */
+class PresetBank {
+public:
+    static constexpr uint16_t CurrentVersion = 1;
+
+    struct Program {
+        juce::String name;
+        std::vector<float> values;  // Plain values, processor parameter order
+    };
+
+    /**
+     * Replace the bank with the programs in a bank file.
+     * @return false (leaving the bank unchanged) if the file can't be read
+     */
+    bool load(const juce::File& file, const juce::AudioProcessor& processor);
+
+    /**
+     * Replace the bank with a single "Init" program of parameter defaults.
+     */
+    void loadDefaults(const juce::AudioProcessor& processor);
+
+    /**
+     * Write programs (in the processor's parameter order) to a bank file.
+     */
+    static bool write(const juce::File& file, const juce::AudioProcessor& processor,
+                      const std::vector<Program>& programs);
+
+    /**
+     * Current parameter values as a program.
+     */
+    static Program capture(const juce::AudioProcessor& processor, const juce::String& name);
+
+    int getNumPrograms() const { return static_cast<int>(programs.size()); }
+    const Program& getProgram(int index) const { return programs[static_cast<size_t>(index)]; }
+    void setProgramName(int index, const juce::String& name);
+
+    /**
+     * Position of a parameter in the processor's parameter order, or -1.
+     */
+    static int findParameterIndex(const juce::AudioProcessor& processor, const juce::String& paramId);
+
+private:
+    static Program createDefaultProgram(const juce::AudioProcessor& processor, const juce::String& name);
+
+    std::vector<Program> programs;
+};
+
+} // namespace vizasynth
@@ -0,0 +1,408 @@
+#include "RealtimeSanitizer.h"
+#include <array>
+#include <atomic>
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if VIZASYNTH_RT_SANITIZER && defined(__GLIBC__)
+ #define VIZASYNTH_RT_INTERPOSE 1
+ #include <cerrno>
+ #include <cstdio>
+ #include <cxxabi.h>
+ #include <dlfcn.h>
+ #include <execinfo.h>
+ #include <fcntl.h>
+ #include <pthread.h>
+ #include <unistd.h>
+#else
+ #define VIZASYNTH_RT_INTERPOSE 0
+#endif
+
+namespace vizasynth {
+namespace rtsan {
+
+namespace {
+
+constexpr int MaxFrames = 32;
+constexpr size_t TableSize = 256;  // Distinct call stacks, power of two
+
+/**
+ * One distinct violating call stack. The key is claimed with a CAS, the
+ * payload is written by the claiming thread and published through 'ready'.
+ */
+struct Entry {
+    std::atomic<uint64_t> key{0};
+    std::atomic<uint64_t> count{0};
+    std::atomic<bool> ready{false};
+    ViolationKind kind = ViolationKind::Allocation;
+    const char* function = nullptr;
+    const char* scope = nullptr;
+    int numFrames = 0;
+    void* frames[MaxFrames] = {};
+};
+
+std::array<Entry, TableSize> table;
+std::atomic<uint64_t> totalViolations{0};
+std::atomic<uint64_t> droppedViolations{0};
+
+// Trivially initialised thread locals: no TLS constructor runs inside malloc
+thread_local int realtimeDepth = 0;
+thread_local int allowDepth = 0;
+thread_local bool recording = false;
+thread_local const char* currentScope = nullptr;
+
+uint64_t hashStack(ViolationKind kind, void* const* frames, int numFrames)
+{
+    uint64_t hash = 1469598103934665603ull ^ static_cast<uint64_t>(kind);
+    for (int i = 0; i < numFrames; ++i) {
+        hash ^= reinterpret_cast<uintptr_t>(frames[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash | 1;  // 0 marks an empty slot
+}
+
+void record(ViolationKind kind, const char* function)
+{
+    void* frames[MaxFrames] = {};
+    int numFrames = 0;
+
+   #if VIZASYNTH_RT_INTERPOSE
+    numFrames = backtrace(frames, MaxFrames);
+   #endif
+
+    const uint64_t key = hashStack(kind, frames, numFrames);
+    totalViolations.fetch_add(1, std::memory_order_relaxed);
+
+    for (size_t probe = 0; probe < TableSize; ++probe) {
+        auto& entry = table[(key + probe) & (TableSize - 1)];
+        uint64_t existing = entry.key.load(std::memory_order_acquire);
+
+        if (existing == 0) {
+            if (entry.key.compare_exchange_strong(existing, key, std::memory_order_acq_rel)) {
+                entry.kind = kind;
+                entry.function = function;
+                entry.scope = currentScope;
+                entry.numFrames = numFrames;
+                std::memcpy(entry.frames, frames, sizeof(void*) * static_cast<size_t>(numFrames));
+                entry.count.fetch_add(1, std::memory_order_relaxed);
+                entry.ready.store(true, std::memory_order_release);
+                return;
+            }
+            // Lost the race; 'existing' now holds the winner's key
+        }
+
+        if (existing == key) {
+            entry.count.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    droppedViolations.fetch_add(1, std::memory_order_relaxed);
+}
+
+const char* kindToString(ViolationKind kind)
+{
+    switch (kind) {
+        case ViolationKind::Allocation:   return "allocation";
+        case ViolationKind::Deallocation: return "deallocation";
+        case ViolationKind::MutexLock:    return "mutex lock";
+        case ViolationKind::FileIO:       return "file I/O";
+        default:                          return "unknown";
+    }
+}
+
+#if VIZASYNTH_RT_INTERPOSE
+/**
+ * Turn "binary(_ZN3foo3barEv+0x1c) [0x...]" into "foo::bar() [binary]".
+ */
+std::string formatFrame(const char* symbol)
+{
+    std::string line(symbol);
+    const auto open = line.find('(');
+    const auto plus = line.find('+', open);
+
+    if (open == std::string::npos || plus == std::string::npos || plus == open + 1)
+        return line;
+
+    const auto mangled = line.substr(open + 1, plus - open - 1);
+    const auto binary = line.substr(0, open);
+
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+    if (status != 0 || demangled == nullptr)
+        return mangled + "  [" + binary + "]";  // C symbol
+
+    std::string result = std::string(demangled) + "  [" + binary + "]";
+    std::free(demangled);
+    return result;
+}
+
+bool isSanitizerFrame(const std::string& frame)
+{
+    const auto name = frame.substr(0, frame.find("  ["));
+
+    static const char* const interposed[] = {
+        "malloc", "free", "calloc", "realloc", "memalign", "aligned_alloc",
+        "posix_memalign", "pthread_mutex_lock", "fopen", "open", "read", "write"
+    };
+
+    for (const auto* function : interposed)
+        if (name == function)
+            return true;
+
+    return name.rfind("vizasynth::rtsan::", 0) == 0;
+}
+
+/**
+ * backtrace() loads its unwinder lazily; do that before any real-time scope.
+ */
+struct BacktracePrimer {
+    BacktracePrimer() {
+        void* frames[2];
+        backtrace(frames, 2);
+    }
+} backtracePrimer;
+#endif
+
+} // namespace
+
+//=============================================================================
+ScopedRealtime::ScopedRealtime(const char* scopeName) noexcept
+    : previousScope(currentScope)
+{
+    currentScope = scopeName;
+    ++realtimeDepth;
+}
+
+ScopedRealtime::~ScopedRealtime() noexcept
+{
+    --realtimeDepth;
+    currentScope = previousScope;
+}
+
+ScopedAllow::ScopedAllow() noexcept { ++allowDepth; }
+ScopedAllow::~ScopedAllow() noexcept { --allowDepth; }
+
+bool isActive() noexcept
+{
+    return VIZASYNTH_RT_INTERPOSE != 0;
+}
+
+void checkRealtime(ViolationKind kind, const char* function) noexcept
+{
+    if (realtimeDepth == 0 || allowDepth > 0 || recording)
+        return;
+
+    // The unwinder and the table may themselves allocate or lock
+    recording = true;
+    record(kind, function);
+    recording = false;
+}
+
+uint64_t getViolationCount() noexcept
+{
+    return totalViolations.load(std::memory_order_relaxed);
+}
+
+size_t getUniqueViolationCount() noexcept
+{
+    size_t unique = 0;
+    for (const auto& entry : table)
+        if (entry.ready.load(std::memory_order_acquire))
+            ++unique;
+    return unique;
+}
+
+void writeReport(std::ostream& out)
+{
+    out << "Real-time safety: " << getViolationCount() << " violation(s) at "
+        << getUniqueViolationCount() << " call site(s)";
+    if (const auto dropped = droppedViolations.load(); dropped > 0)
+        out << ", " << dropped << " not recorded (table full)";
+    out << "\n";
+
+    if (!isActive())
+        out << "  (sanitizer not compiled in; configure with -DVIZASYNTH_RT_SANITIZER=ON on Linux)\n";
+
+    for (const auto& entry : table) {
+        if (!entry.ready.load(std::memory_order_acquire))
+            continue;
+
+        out << "\n" << kindToString(entry.kind) << " via " << entry.function
+            << " in scope '" << (entry.scope != nullptr ? entry.scope : "?") << "', "
+            << entry.count.load(std::memory_order_relaxed) << " time(s)\n";
+
+       #if VIZASYNTH_RT_INTERPOSE
+        char** symbols = backtrace_symbols(entry.frames, entry.numFrames);
+        bool skipping = true;
+
+        for (int i = 0; i < entry.numFrames; ++i) {
+            const auto frame = symbols != nullptr ? formatFrame(symbols[i]) : std::string("?");
+            if (skipping && isSanitizerFrame(frame))
+                continue;
+
+            skipping = false;
+            out << "    #" << i << " " << frame << "\n";
+        }
+
+        std::free(symbols);
+       #endif
+    }
+}
+
+void reset() noexcept
+{
+    for (auto& entry : table) {
+        entry.ready.store(false, std::memory_order_relaxed);
+        entry.count.store(0, std::memory_order_relaxed);
+        entry.key.store(0, std::memory_order_release);
+    }
+
+    totalViolations.store(0);
+    droppedViolations.store(0);
+}
+
+} // namespace rtsan
+} // namespace vizasynth
+
+//=============================================================================
+// Interposed libc functions
+//=============================================================================
+
+#if VIZASYNTH_RT_INTERPOSE
+
+using vizasynth::rtsan::ViolationKind;
+using vizasynth::rtsan::checkRealtime;
+
+extern "C" {
+
+// glibc's allocator entry points, which the overrides forward to
+void* __libc_malloc(size_t size);
+void __libc_free(void* ptr);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+
+}
+
+namespace {
+
+// Resolved lazily with dlsym; namespace scope so no static-init guard
+// (which can itself lock) runs on the interposed path
+std::atomic<void*> realMutexLock{nullptr};
+std::atomic<void*> realFopen{nullptr};
+std::atomic<void*> realOpen{nullptr};
+std::atomic<void*> realRead{nullptr};
+std::atomic<void*> realWrite{nullptr};
+
+template <typename Function>
+Function next(std::atomic<void*>& cache, const char* name)
+{
+    void* function = cache.load(std::memory_order_relaxed);
+    if (function == nullptr) {
+        function = dlsym(RTLD_NEXT, name);
+        cache.store(function, std::memory_order_relaxed);
+    }
+    return reinterpret_cast<Function>(function);
+}
+
+} // namespace
+
+extern "C" {
+
+void* malloc(size_t size) noexcept
+{
+    checkRealtime(ViolationKind::Allocation, "malloc");
+    return __libc_malloc(size);
+}
+
+void free(void* ptr) noexcept
+{
+    if (ptr != nullptr)
+        checkRealtime(ViolationKind::Deallocation, "free");
+    __libc_free(ptr);
+}
+
+void* calloc(size_t count, size_t size) noexcept
+{
+    checkRealtime(ViolationKind::Allocation, "calloc");
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) noexcept
+{
+    checkRealtime(ViolationKind::Allocation, "realloc");
+    return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) noexcept
+{
+    checkRealtime(ViolationKind::Allocation, "memalign");
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept
+{
+    checkRealtime(ViolationKind::Allocation, "aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** result, size_t alignment, size_t size) noexcept
+{
+    checkRealtime(ViolationKind::Allocation, "posix_memalign");
+
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+
+    void* ptr = __libc_memalign(alignment, size);
+    if (ptr == nullptr)
+        return ENOMEM;
+
+    *result = ptr;
+    return 0;
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+{
+    checkRealtime(ViolationKind::MutexLock, "pthread_mutex_lock");
+    return next<int (*)(pthread_mutex_t*)>(realMutexLock, "pthread_mutex_lock")(mutex);
+}
+
+FILE* fopen(const char* path, const char* mode)
+{
+    checkRealtime(ViolationKind::FileIO, "fopen");
+    return next<FILE* (*)(const char*, const char*)>(realFopen, "fopen")(path, mode);
+}
+
+int open(const char* path, int flags, ...)
+{
+    checkRealtime(ViolationKind::FileIO, "open");
+
+    mode_t mode = 0;
+    if ((flags & O_CREAT) != 0 || (flags & O_TMPFILE) == O_TMPFILE) {
+        va_list args;
+        va_start(args, flags);
+        mode = static_cast<mode_t>(va_arg(args, int));
+        va_end(args);
+    }
+
+    return next<int (*)(const char*, int, ...)>(realOpen, "open")(path, flags, mode);
+}
+
+ssize_t read(int fd, void* buffer, size_t count)
+{
+    checkRealtime(ViolationKind::FileIO, "read");
+    return next<ssize_t (*)(int, void*, size_t)>(realRead, "read")(fd, buffer, count);
+}
+
+ssize_t write(int fd, const void* buffer, size_t count)
+{
+    checkRealtime(ViolationKind::FileIO, "write");
+    return next<ssize_t (*)(int, const void*, size_t)>(realWrite, "write")(fd, buffer, count);
+}
+
+}
+
+#endif
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#ifndef VIZASYNTH_RT_SANITIZER
+ #define VIZASYNTH_RT_SANITIZER 0
+#endif
+
+namespace vizasynth {
+
+/**
+ * RealtimeSanitizer - Detects non-real-time-safe calls on the audio thread
+ *
+ * Debug builds configured with -DVIZASYNTH_RT_SANITIZER=ON interpose the C
+ * allocator (and with it operator new/delete), pthread_mutex_lock and the
+ * basic file I/O calls. Any such call made while a thread is inside a
+ * VIZASYNTH_REALTIME_SCOPE is recorded together with its stack trace.
+ *
+ * Recording is lock-free and allocation-free: violations are deduplicated by
+ * call stack into a fixed-size open-addressing table, so a per-block offender
+ * costs one counter increment after the first hit. Reports are formatted on
+ * demand from a non-real-time thread.
+ *
+ * Interposition needs glibc (Linux) and only works for code linked into an
+ * executable: the Standalone app, the renderer, benchmarks and tests. In all
+ * other builds the scope macro compiles to nothing.
+ */
+namespace rtsan {
+
+enum class ViolationKind {
+    Allocation,
+    Deallocation,
+    MutexLock,
+    FileIO
+};
+
+/**
+ * Marks the current thread as real-time for the lifetime of the object.
+ * Scopes nest, e.g. the voice render inside processBlock.
+ */
+class ScopedRealtime {
+public:
+    explicit ScopedRealtime(const char* scopeName) noexcept;
+    ~ScopedRealtime() noexcept;
+
+    ScopedRealtime(const ScopedRealtime&) = delete;
+    ScopedRealtime& operator=(const ScopedRealtime&) = delete;
+
+private:
+    const char* previousScope;
+};
+
+/**
+ * Temporarily allows blocking calls inside a real-time scope, for known and
+ * accepted offenders that cannot be removed yet.
+ */
+class ScopedAllow {
+public:
+    ScopedAllow() noexcept;
+    ~ScopedAllow() noexcept;
+
+    ScopedAllow(const ScopedAllow&) = delete;
+    ScopedAllow& operator=(const ScopedAllow&) = delete;
+};
+
+/**
+ * Whether the sanitizer is compiled in and able to intercept calls.
+ */
+bool isActive() noexcept;
+
+/**
+ * Record a violation from the calling thread if it is in a real-time scope.
+ * Called by the interposed functions; safe to call from anywhere.
+ */
+void checkRealtime(ViolationKind kind, const char* function) noexcept;
+
+/**
+ * Total number of violations seen, including repeats of the same call stack.
+ */
+uint64_t getViolationCount() noexcept;
+
+/**
+ * Number of distinct call stacks recorded.
+ */
+size_t getUniqueViolationCount() noexcept;
+
+/**
+ * Write every distinct violation with its count, scope and symbolised stack.
+ * Allocates; call from a non-real-time thread.
+ */
+void writeReport(std::ostream& out);
+
+/**
+ * Forget all recorded violations (for test setups). Not thread-safe against
+ * concurrent recording.
+ */
+void reset() noexcept;
+
+} // namespace rtsan
+} // namespace vizasynth
+
+#if VIZASYNTH_RT_SANITIZER
+ #define VIZASYNTH_RT_CONCAT_INNER(a, b) a##b
+ #define VIZASYNTH_RT_CONCAT(a, b) VIZASYNTH_RT_CONCAT_INNER(a, b)
+ #define VIZASYNTH_REALTIME_SCOPE(name) \
+     ::vizasynth::rtsan::ScopedRealtime VIZASYNTH_RT_CONCAT(realtimeScope_, __LINE__)(name)
+ #define VIZASYNTH_REALTIME_ALLOW() \
+     ::vizasynth::rtsan::ScopedAllow VIZASYNTH_RT_CONCAT(realtimeAllow_, __LINE__)
+#else
+ #define VIZASYNTH_REALTIME_SCOPE(name)
+ #define VIZASYNTH_REALTIME_ALLOW()
+#endif
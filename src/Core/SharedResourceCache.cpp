@@ -0,0 +1,54 @@
+#include "SharedResourceCache.h"
+
+namespace vizasynth {
+
+SharedResourceCache& SharedResourceCache::getInstance()
+{
+    static SharedResourceCache instance;
+    return instance;
+}
+
+std::shared_ptr<const void> SharedResourceCache::getOrBuild(const std::string& key,
+                                                            const std::function<std::shared_ptr<const void>()>& build)
+{
+    std::shared_ptr<Slot> slot;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        // Drop slots whose resources have been released (and aren't being rebuilt)
+        for (auto it = slots.begin(); it != slots.end();) {
+            if (it->first != key && it->second.use_count() == 1 && it->second->resource.expired())
+                it = slots.erase(it);
+            else
+                ++it;
+        }
+
+        auto& entry = slots[key];
+        if (entry == nullptr)
+            entry = std::make_shared<Slot>();
+        slot = entry;
+    }
+
+    std::lock_guard<std::mutex> building(slot->buildLock);
+
+    if (auto existing = slot->resource.lock())
+        return existing;
+
+    auto resource = build();
+    slot->resource = resource;
+    return resource;
+}
+
+int SharedResourceCache::getNumLiveResources() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    int live = 0;
+    for (const auto& entry : slots)
+        if (!entry.second->resource.expired())
+            ++live;
+    return live;
+}
+
+} // namespace vizasynth
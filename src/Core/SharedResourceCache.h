@@ -0,0 +1,75 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+
+namespace vizasynth {
+
+/**
+ * SharedResourceCache - Process-wide, reference-counted immutable resources
+ *
+ * Plugin instances in one host process share a single copy of read-only
+ * tables (FFT plans, window tables, wavetables) instead of each building
+ * their own. Ask for a resource by key with a function that builds it:
+ *
+ *   auto tables = SharedResourceCache::getInstance().get<FFTTables>(
+ *       "fft/12", [] { return std::make_unique<FFTTables>(12); });
+ *
+ * The first caller builds it; callers for the same key that arrive while
+ * it is being built wait for that build instead of starting another, and
+ * different keys build in parallel. A resource lives as long as any
+ * handle to it and is built again the next time it is wanted after that.
+ *
+ * Resources are shared between threads, so they must be immutable (or
+ * internally thread-safe) once built. Keys are per type, so two types may
+ * use the same key.
+ */
+class SharedResourceCache {
+public:
+    static SharedResourceCache& getInstance();
+
+    /**
+     * Handle to the shared resource of type T for key, built with create()
+     * (returning std::unique_ptr<T>) if no live one exists. Returns null if
+     * create() does.
+     */
+    template <typename T, typename Factory>
+    std::shared_ptr<const T> get(const std::string& key, Factory&& create) {
+        auto built = getOrBuild(std::string(typeid(T).name()) + '/' + key, [&create]() -> std::shared_ptr<const void> {
+            return std::shared_ptr<const T>(create());
+        });
+        return std::static_pointer_cast<const T>(built);
+    }
+
+    /**
+     * Number of resources currently alive.
+     */
+    int getNumLiveResources() const;
+
+private:
+    SharedResourceCache() = default;
+
+    /**
+     * One key's resource. Its mutex is held while the resource is built,
+     * which is what makes same-key callers wait.
+     */
+    struct Slot {
+        std::mutex buildLock;
+        std::weak_ptr<const void> resource;
+    };
+
+    std::shared_ptr<const void> getOrBuild(const std::string& key,
+                                           const std::function<std::shared_ptr<const void>()>& build);
+
+    mutable std::mutex lock;  // Guards the map, never held while building
+    std::unordered_map<std::string, std::shared_ptr<Slot>> slots;
+
+    JUCE_DECLARE_NON_COPYABLE(SharedResourceCache)
+};
+
+} // namespace vizasynth
@@ -0,0 +1,271 @@
+#include "TraceRecorder.h"
+#include <juce_events/juce_events.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace vizasynth {
+
+namespace {
+
+void copyName(char* destination, const char* source) noexcept
+{
+    std::strncpy(destination, source != nullptr ? source : "", TraceRecorder::MaxNameLength - 1);
+    destination[TraceRecorder::MaxNameLength - 1] = '\0';
+}
+
+void writeEscaped(juce::OutputStream& out, const char* text)
+{
+    for (const char* c = text; *c != '\0'; ++c) {
+        if (*c == '"' || *c == '\\')
+            out.writeByte('\\');
+        if (static_cast<unsigned char>(*c) >= 0x20)
+            out.writeByte(*c);
+    }
+}
+
+} // namespace
+
+//=============================================================================
+// Writer thread
+//=============================================================================
+
+/**
+ * Drains the rings every few milliseconds and streams them as Chrome trace
+ * JSON. The footer is written when the thread is asked to exit.
+ */
+class TraceRecorder::Writer : public juce::Thread {
+public:
+    Writer(TraceRecorder& r, std::unique_ptr<juce::FileOutputStream> s)
+        : juce::Thread("Trace writer"), recorder(r), stream(std::move(s)) {
+        *stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        writeMetadata(0, "process_name", "Viz-A-Synth");
+    }
+
+    void run() override {
+        while (!threadShouldExit()) {
+            drain();
+            wait(10);
+        }
+
+        drain();
+
+        *stream << "\n],\"otherData\":{\"droppedEvents\":"
+                << juce::String(static_cast<juce::int64>(recorder.getDroppedEventCount())) << "}}\n";
+        stream->flush();
+    }
+
+private:
+    void drain() {
+        const uint64_t origin = recorder.captureStartNanos.load();
+
+        for (int t = 0; t < MaxThreads; ++t) {
+            auto& slot = recorder.slots[static_cast<size_t>(t)];
+            if (!slot.ready.load(std::memory_order_acquire))
+                continue;
+
+            if (!named[static_cast<size_t>(t)]) {
+                writeMetadata(t + 1, "thread_name", slot.threadName);
+                named[static_cast<size_t>(t)] = true;
+            }
+
+            const uint32_t head = slot.head.load(std::memory_order_acquire);
+            uint32_t tail = slot.tail.load(std::memory_order_relaxed);
+
+            for (; tail != head; ++tail) {
+                const auto& event = slot.events[tail & (EventsPerThread - 1)];
+
+                // Scopes that closed before the capture began are stale
+                if (event.endNanos < origin)
+                    continue;
+
+                const uint64_t start = std::max(event.startNanos, origin) - origin;
+                const uint64_t duration = event.endNanos - origin - start;
+
+                char timing[96];
+                std::snprintf(timing, sizeof(timing), "\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                              t + 1, static_cast<double>(start) * 1.0e-3, static_cast<double>(duration) * 1.0e-3);
+
+                beginEntry();
+                *stream << "{\"cat\":\"";
+                writeEscaped(*stream, event.category);
+                *stream << "\",\"name\":\"";
+                writeEscaped(*stream, event.name);
+                *stream << timing;
+            }
+
+            slot.tail.store(tail, std::memory_order_release);
+        }
+    }
+
+    void writeMetadata(int tid, const char* key, const char* value) {
+        beginEntry();
+        *stream << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << juce::String(tid) << ",\"name\":\"" << key
+                << "\",\"args\":{\"name\":\"";
+        writeEscaped(*stream, value);
+        *stream << "\"}}";
+    }
+
+    void beginEntry() {
+        if (!firstEntry)
+            *stream << ",\n";
+        firstEntry = false;
+    }
+
+    TraceRecorder& recorder;
+    std::unique_ptr<juce::FileOutputStream> stream;
+    std::array<bool, MaxThreads> named{};
+    bool firstEntry = true;
+};
+
+//=============================================================================
+// TraceRecorder
+//=============================================================================
+
+TraceRecorder& TraceRecorder::getInstance()
+{
+    static TraceRecorder instance;
+    return instance;
+}
+
+TraceRecorder::TraceRecorder() = default;
+
+TraceRecorder::~TraceRecorder()
+{
+    stopCapture();
+}
+
+uint64_t TraceRecorder::now() noexcept
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool TraceRecorder::startCapture(const juce::File& outputFile)
+{
+    if (writer != nullptr)
+        return false;
+
+    outputFile.getParentDirectory().createDirectory();
+    outputFile.deleteFile();
+
+    auto stream = std::make_unique<juce::FileOutputStream>(outputFile, 1 << 16);
+    if (!stream->openedOk())
+        return false;
+
+    // Rings are allocated once and never freed, so producers that raced
+    // the capture flag can never write into released memory
+    if (!slotsAllocated) {
+        for (auto& slot : slots)
+            slot.events = std::make_unique<Event[]>(EventsPerThread);
+        slotsAllocated = true;
+    }
+
+    for (auto& slot : slots) {
+        slot.tail.store(slot.head.load());
+        slot.dropped.store(0);
+    }
+    unassignedDropped.store(0);
+
+    captureFile = outputFile;
+    captureStartNanos.store(now());
+    writer = std::make_unique<Writer>(*this, std::move(stream));
+
+    capturing.store(true, std::memory_order_release);
+    writer->startThread();
+    return true;
+}
+
+void TraceRecorder::stopCapture()
+{
+    if (writer == nullptr)
+        return;
+
+    capturing.store(false, std::memory_order_release);
+    writer->stopThread(2000);
+    writer.reset();
+}
+
+uint64_t TraceRecorder::getDroppedEventCount() const
+{
+    uint64_t total = unassignedDropped.load();
+    for (const auto& slot : slots)
+        total += slot.dropped.load();
+    return total;
+}
+
+juce::File TraceRecorder::createDefaultCaptureFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+        .getChildFile("VizASynth Traces")
+        .getChildFile("trace-" + juce::Time::getCurrentTime().formatted("%Y-%m-%d_%H-%M-%S") + ".json");
+}
+
+TraceRecorder::ThreadSlot* TraceRecorder::claimSlot(const char* category) noexcept
+{
+    for (int t = 0; t < MaxThreads; ++t) {
+        auto& slot = slots[static_cast<size_t>(t)];
+        bool expected = false;
+
+        if (!slot.claimed.load(std::memory_order_relaxed)
+            && slot.claimed.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            // Name the track after the first thing it records
+            if (juce::MessageManager::existsAndIsCurrentThread())
+                std::snprintf(slot.threadName, sizeof(slot.threadName), "Message thread");
+            else if (std::strcmp(category, "audio") == 0)
+                std::snprintf(slot.threadName, sizeof(slot.threadName), "Audio thread %d", t + 1);
+            else
+                std::snprintf(slot.threadName, sizeof(slot.threadName), "Thread %d", t + 1);
+
+            // Publish the name before the writer can see the slot
+            slot.ready.store(true, std::memory_order_release);
+            return &slot;
+        }
+    }
+
+    return nullptr;
+}
+
+void TraceRecorder::record(const char* category, const char* name,
+                           uint64_t startNanos, uint64_t endNanos) noexcept
+{
+    if (!isCapturing())
+        return;
+
+    if (currentSlot == nullptr) {
+        if (noSlotAvailable || (currentSlot = claimSlot(category)) == nullptr) {
+            noSlotAvailable = true;
+            unassignedDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    auto& slot = *currentSlot;
+    const uint32_t head = slot.head.load(std::memory_order_relaxed);
+
+    if (head - slot.tail.load(std::memory_order_acquire) >= EventsPerThread) {
+        slot.dropped.store(slot.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto& event = slot.events[head & (EventsPerThread - 1)];
+    event.startNanos = startNanos;
+    event.endNanos = endNanos;
+    event.category = category;
+    copyName(event.name, name);
+
+    slot.head.store(head + 1, std::memory_order_release);
+}
+
+TraceRecorder::ScopedEvent::ScopedEvent(const char* eventCategory, const char* eventName) noexcept
+{
+    if (!isCapturing())
+        return;
+
+    category = eventCategory;
+    copyName(name, eventName);
+    startNanos = now();
+}
+
+} // namespace vizasynth
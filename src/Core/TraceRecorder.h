@@ -0,0 +1,156 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#ifndef VIZASYNTH_TRACE
+ #define VIZASYNTH_TRACE 1
+#endif
+
+namespace vizasynth {
+
+/**
+ * TraceRecorder - Chrome trace event capture for the audio and UI threads
+ *
+ * Scoped events (processBlock, voice renders, panel paints and timer
+ * callbacks) are pushed into per-thread single-producer rings, so recording
+ * never locks or allocates. A background writer thread drains the rings
+ * while a capture is running and streams them to a Chrome trace JSON file,
+ * which chrome://tracing and ui.perfetto.dev both open.
+ *
+ * When no capture is running each scope costs one atomic load.
+ * Capture starts and stops at any time (the Standalone app has a "Trace"
+ * button). Compile with VIZASYNTH_TRACE=0 to remove the scopes entirely.
+ *
+ * Each thread claims a ring the first time it records and keeps it for the
+ * life of the process; threads beyond MaxThreads and events that arrive
+ * while a ring is full are counted as dropped.
+ */
+class TraceRecorder {
+public:
+    static constexpr int MaxThreads = 32;
+    static constexpr uint32_t EventsPerThread = 1u << 13;  // Power of two
+    static constexpr int MaxNameLength = 48;
+
+    /**
+     * One completed scope.
+     */
+    struct Event {
+        uint64_t startNanos = 0;
+        uint64_t endNanos = 0;
+        const char* category = nullptr;  // String literal
+        char name[MaxNameLength] = {};
+    };
+
+    static TraceRecorder& getInstance();
+    ~TraceRecorder();
+
+    //=========================================================================
+    // Capture control (message thread)
+    //=========================================================================
+
+    /**
+     * Start writing events to the given file (replaced if it exists).
+     * @return false if a capture is already running or the file can't be opened
+     */
+    bool startCapture(const juce::File& outputFile);
+
+    /**
+     * Stop capturing, flush the remaining events and close the file.
+     */
+    void stopCapture();
+
+    static bool isCapturing() noexcept { return capturing.load(std::memory_order_acquire); }
+
+    /**
+     * File of the current or most recent capture.
+     */
+    juce::File getCaptureFile() const { return captureFile; }
+
+    /**
+     * Events lost to full rings or too many threads during the last capture.
+     */
+    uint64_t getDroppedEventCount() const;
+
+    /**
+     * Timestamped file in ~/Documents/VizASynth Traces.
+     */
+    static juce::File createDefaultCaptureFile();
+
+    //=========================================================================
+    // Recording (any thread)
+    //=========================================================================
+
+    static uint64_t now() noexcept;
+
+    void record(const char* category, const char* name, uint64_t startNanos, uint64_t endNanos) noexcept;
+
+    /**
+     * Records the lifetime of the object as one event. The name is copied,
+     * so it may point at a temporary.
+     */
+    class ScopedEvent {
+    public:
+        ScopedEvent(const char* category, const char* eventName) noexcept;
+
+        ~ScopedEvent() noexcept {
+            if (category != nullptr)
+                getInstance().record(category, name, startNanos, now());
+        }
+
+        ScopedEvent(const ScopedEvent&) = delete;
+        ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+    private:
+        const char* category = nullptr;
+        uint64_t startNanos = 0;
+        char name[MaxNameLength];
+    };
+
+private:
+    TraceRecorder();
+
+    /**
+     * Ring owned by one producer thread; the writer thread is the consumer.
+     */
+    struct ThreadSlot {
+        std::atomic<bool> claimed{false};  // Taken by a producer thread
+        std::atomic<bool> ready{false};    // Name written, visible to the writer
+        char threadName[32] = {};
+        std::unique_ptr<Event[]> events;
+        std::atomic<uint32_t> head{0};  // Written by the producer
+        std::atomic<uint32_t> tail{0};  // Written by the writer
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    class Writer;
+
+    ThreadSlot* claimSlot(const char* category) noexcept;
+
+    std::array<ThreadSlot, MaxThreads> slots;
+    std::atomic<uint64_t> unassignedDropped{0};
+    std::atomic<uint64_t> captureStartNanos{0};
+    bool slotsAllocated = false;
+    juce::File captureFile;
+    std::unique_ptr<Writer> writer;
+
+    static inline std::atomic<bool> capturing{false};
+    static inline thread_local ThreadSlot* currentSlot = nullptr;
+    static inline thread_local bool noSlotAvailable = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TraceRecorder)
+};
+
+} // namespace vizasynth
+
+#if VIZASYNTH_TRACE
+ #define VIZASYNTH_TRACE_CONCAT_INNER(a, b) a##b
+ #define VIZASYNTH_TRACE_CONCAT(a, b) VIZASYNTH_TRACE_CONCAT_INNER(a, b)
+ #define VIZASYNTH_TRACE_SCOPE(category, name) \
+     ::vizasynth::TraceRecorder::ScopedEvent VIZASYNTH_TRACE_CONCAT(traceScope_, __LINE__)(category, name)
+#else
+ #define VIZASYNTH_TRACE_SCOPE(category, name)
+#endif
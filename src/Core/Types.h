@@ -160,13 +160,17 @@ enum class ProbePoint {
     PostFilter,
     PostEnvelope,
     Output,
-    Mix
+    Mix,
+    Chorus,       // Effects bus, after each effect
+    Delay,
+    Reverb
 };
 
 // Voice visualization mode
 enum class VoiceMode {
     Mix,         // Show sum of all voices (default)
-    SingleVoice  // Show only the most recently triggered voice
+    SingleVoice, // Show only the most recently triggered voice
+    Overlay      // Show every sounding voice at once, each in its own colour
 };
 
 // Convert ProbePoint to string for display
@@ -177,8 +181,16 @@ inline std::string probePointToString(ProbePoint point) {
         case ProbePoint::PostEnvelope: return "Post-Envelope";
         case ProbePoint::Output:       return "Output";
         case ProbePoint::Mix:          return "Mix";
+        case ProbePoint::Chorus:       return "Chorus";
+        case ProbePoint::Delay:        return "Delay";
+        case ProbePoint::Reverb:       return "Reverb";
         default:                       return "Unknown";
     }
 }
 
+// Probe points on the effects bus, which are read through the mix probe
+inline bool isEffectProbePoint(ProbePoint point) {
+    return point == ProbePoint::Chorus || point == ProbePoint::Delay || point == ProbePoint::Reverb;
+}
+
 } // namespace vizasynth
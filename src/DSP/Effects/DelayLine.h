@@ -0,0 +1,130 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace vizasynth {
+
+/**
+ * DelayLine - Pre-allocated ring of past samples for block-processed effects
+ *
+ * The ring is a power of two long and is only allocated in prepare(). An
+ * effect reads a whole block out of the line before writing that block in,
+ * so every delay must be at least the block length; reads and writes are
+ * then at most two contiguous copies, split where the ring wraps.
+ *
+ * Positions are relative to the next sample to be written: a delay of d
+ * reads the sample written d samples before it.
+ *
+ * restart() empties the line without touching the ring: it only resets the
+ * count of samples written since, and reads return zero for anything older.
+ * That keeps switching an effect back on O(1) on the audio thread however
+ * long its lines are; the extra checks stop once the ring has been refilled.
+ */
+class DelayLine {
+public:
+    /**
+     * Size the ring for delays up to maxDelaySamples and clear it.
+     * Allocates, so call from prepareToPlay.
+     */
+    void prepare(int maxDelaySamples) {
+        const auto required = static_cast<size_t>(std::max(1, maxDelaySamples)) + 1;
+        size_t capacity = 1;
+        while (capacity < required)
+            capacity <<= 1;
+
+        buffer.assign(capacity, 0.0f);
+        mask = capacity - 1;
+        writePosition = 0;
+        validSamples = capacity;
+    }
+
+    /**
+     * Zero the whole ring. Proportional to its length, so not for the audio thread.
+     */
+    void clear() {
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        validSamples = buffer.size();
+    }
+
+    /**
+     * Treat everything written so far as silence. O(1), real-time safe.
+     */
+    void restart() { validSamples = 0; }
+
+    int getMaxDelay() const { return static_cast<int>(mask); }
+
+    /**
+     * Read a block at a fixed whole-sample delay.
+     * @param delay Delay in samples, from numSamples to getMaxDelay()
+     */
+    void read(float* destination, int delay, int numSamples) const {
+        jassert(delay >= numSamples && delay <= getMaxDelay());
+
+        const size_t start = (writePosition - static_cast<size_t>(delay)) & mask;
+        const size_t first = std::min(static_cast<size_t>(numSamples), buffer.size() - start);
+        std::copy_n(buffer.data() + start, first, destination);
+        std::copy_n(buffer.data(), static_cast<size_t>(numSamples) - first, destination + first);
+
+        // Sample i is delay - i samples old; those from before a restart are silent
+        if (validSamples < static_cast<size_t>(delay)) {
+            const auto stale = std::min(static_cast<size_t>(numSamples), static_cast<size_t>(delay) - validSamples);
+            std::fill_n(destination, stale, 0.0f);
+        }
+    }
+
+    /**
+     * Read a block with a per-sample fractional delay (linear interpolation).
+     * @param delays Delay of each sample, from numSamples + 1 to below getMaxDelay()
+     */
+    void readInterpolated(float* destination, const float* delays, int numSamples) const {
+        const float* data = buffer.data();
+        const bool partial = validSamples < buffer.size();
+
+        for (int i = 0; i < numSamples; ++i) {
+            jassert(delays[i] >= static_cast<float>(numSamples + 1) && delays[i] < static_cast<float>(getMaxDelay()));
+
+            const float position = static_cast<float>(i) - delays[i];
+            const float whole = std::floor(position);
+            const float fraction = position - whole;
+            const auto offset = static_cast<std::ptrdiff_t>(whole);
+            const size_t index = (writePosition + static_cast<size_t>(offset)) & mask;
+
+            float a = data[index];
+            float b = data[(index + 1) & mask];
+
+            // a is -offset samples old and b one sample younger
+            if (partial) {
+                const auto age = static_cast<size_t>(-offset);
+                a = age <= validSamples ? a : 0.0f;
+                b = age - 1 <= validSamples ? b : 0.0f;
+            }
+
+            destination[i] = a + fraction * (b - a);
+        }
+    }
+
+    /**
+     * Append a block (no longer than the ring).
+     */
+    void write(const float* source, int numSamples) {
+        jassert(static_cast<size_t>(numSamples) <= buffer.size());
+
+        const size_t first = std::min(static_cast<size_t>(numSamples), buffer.size() - writePosition);
+        std::copy_n(source, first, buffer.data() + writePosition);
+        std::copy_n(source + first, static_cast<size_t>(numSamples) - first, buffer.data());
+        writePosition = (writePosition + static_cast<size_t>(numSamples)) & mask;
+        validSamples = std::min(validSamples + static_cast<size_t>(numSamples), buffer.size());
+    }
+
+private:
+    std::vector<float> buffer = std::vector<float>(1, 0.0f);
+    size_t mask = 0;
+    size_t writePosition = 0;
+    size_t validSamples = 1;  // Samples written since the last restart, up to the ring size
+};
+
+} // namespace vizasynth
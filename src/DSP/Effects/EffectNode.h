@@ -0,0 +1,157 @@
+#pragma once
+
+#include "../../Core/SignalNode.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <algorithm>
+#include <array>
+
+namespace vizasynth {
+
+/**
+ * EffectNode - Base for the stereo effects on the effects bus
+ *
+ * Effects process stereo blocks in place. A block is split into sub-blocks
+ * of at most MaxSubBlock samples, which is also the shortest delay any
+ * effect uses, so each sub-block can be read out of its delay lines and
+ * written back with whole-block (vectorised) operations.
+ *
+ * The subclass renders the wet signal; the base crossfades it with the dry
+ * signal. The wet gain ramps over RampSeconds when the mix changes and when
+ * the effect is switched on or off. Once a switched-off effect has faded
+ * out it is inactive: the bus stops calling it, and its delay lines are
+ * restarted the next time it is switched on so no stale tail comes back.
+ * Restarting is O(1) (see DelayLine::restart), so switching on is as cheap
+ * at 192 kHz as at 44.1 kHz.
+ *
+ * Parameters are set on the audio thread, between blocks.
+ */
+class EffectNode : public SignalNode {
+public:
+    static constexpr int MaxSubBlock = 64;
+    static constexpr double RampSeconds = 0.01;
+
+    ~EffectNode() override = default;
+
+    //=========================================================================
+    // Control
+    //=========================================================================
+
+    void setEnabled(bool shouldBeEnabled) {
+        if (shouldBeEnabled && !isActive())
+            needsRestart = true;
+
+        enabled = shouldBeEnabled;
+    }
+
+    bool isEnabled() const { return enabled; }
+
+    /**
+     * True while the effect still has to run: switched on, or fading out.
+     */
+    bool isActive() const { return enabled || wetGain > 0.0f; }
+
+    /**
+     * Wet/dry balance, 0 (dry) to 1 (wet only).
+     */
+    void setMix(float newMix) { mix = juce::jlimit(0.0f, 1.0f, newMix); }
+    float getMix() const { return mix; }
+
+    //=========================================================================
+    // Processing
+    //=========================================================================
+
+    void prepare(double sampleRate, int samplesPerBlock) override {
+        currentSampleRate = sampleRate;
+        currentBlockSize = samplesPerBlock;
+        rampStep = static_cast<float>(1.0 / std::max(1.0, sampleRate * RampSeconds));
+
+        prepareEffect(sampleRate);
+        reset();
+
+        wetGain = enabled ? mix : 0.0f;
+        needsRestart = false;
+    }
+
+    /**
+     * Process a stereo block in place. Real-time safe at any block size.
+     */
+    void process(float* left, float* right, int numSamples) {
+        if (needsRestart) {
+            restart();
+            needsRestart = false;
+        }
+
+        for (int start = 0; start < numSamples; start += MaxSubBlock) {
+            const int count = std::min(MaxSubBlock, numSamples - start);
+            processSubBlock(left + start, right + start, count);
+        }
+
+        if (numSamples > 0)
+            lastOutput = 0.5f * (left[numSamples - 1] + right[numSamples - 1]);
+    }
+
+    /**
+     * Mono input through both channels, returning their average.
+     */
+    float process(float input) override {
+        float left = input, right = input;
+        process(&left, &right, 1);
+        return lastOutput;
+    }
+
+    float getLastOutput() const override { return lastOutput; }
+    double getSampleRate() const override { return currentSampleRate; }
+
+protected:
+    /**
+     * Allocate delay lines for the sample rate (called from prepare, before reset).
+     */
+    virtual void prepareEffect(double sampleRate) = 0;
+
+    /**
+     * Forget all past input, as reset() does, in constant time: restart the
+     * delay lines rather than clearing them. Called on the audio thread.
+     */
+    virtual void restart() = 0;
+
+    /**
+     * Render the wet signal for one sub-block of at most MaxSubBlock samples,
+     * advancing the effect's state. The input must be left untouched.
+     */
+    virtual void renderWet(const float* left, const float* right, float* wetLeft, float* wetRight,
+                           int numSamples) = 0;
+
+private:
+    void processSubBlock(float* left, float* right, int numSamples) {
+        renderWet(left, right, wetScratchLeft.data(), wetScratchRight.data(), numSamples);
+
+        // The wet gain moves linearly towards its target, at most RampSeconds end to end
+        const float target = enabled ? mix : 0.0f;
+        const float maxMove = rampStep * static_cast<float>(numSamples);
+        const float endGain = wetGain + juce::jlimit(-maxMove, maxMove, target - wetGain);
+        const float step = (endGain - wetGain) / static_cast<float>(numSamples);
+
+        crossfade(left, wetScratchLeft.data(), wetGain, step, numSamples);
+        crossfade(right, wetScratchRight.data(), wetGain, step, numSamples);
+
+        wetGain = endGain;
+    }
+
+    static void crossfade(float* dry, const float* wet, float startGain, float step, int numSamples) {
+        for (int i = 0; i < numSamples; ++i) {
+            const float gain = startGain + step * static_cast<float>(i + 1);
+            dry[i] += gain * (wet[i] - dry[i]);
+        }
+    }
+
+    std::array<float, MaxSubBlock> wetScratchLeft{};
+    std::array<float, MaxSubBlock> wetScratchRight{};
+
+    bool enabled = false;
+    bool needsRestart = false;
+    float mix = 0.5f;
+    float wetGain = 0.0f;
+    float rampStep = 1.0f / 441.0f;
+};
+
+} // namespace vizasynth
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Chorus.h"
+#include "PingPongDelay.h"
+#include "Reverb.h"
+#include "../../Visualization/ProbeBuffer.h"
+#include "../../Core/DspLoadMonitor.h"
+#include <utility>
+
+namespace vizasynth {
+
+/**
+ * EffectsBus - Chorus, ping-pong delay and reverb after the voice sum
+ *
+ * Runs the effects in series on the stereo voice bus, before the output
+ * stage. An effect that is switched off costs nothing once its wet signal
+ * has faded out, and with all three off the processor skips the bus.
+ *
+ * Each effect has a probe point. When one of them is the active probe
+ * point, the bus pushes the left channel as it leaves that effect into the
+ * mix probe, whether the effect is on or bypassed. The recorder's mix tap
+ * doesn't get it; the processor records the output there instead.
+ */
+class EffectsBus {
+public:
+    EffectsBus() = default;
+
+    void prepare(double sampleRate, int samplesPerBlock) {
+        chorus.prepare(sampleRate, samplesPerBlock);
+        delay.prepare(sampleRate, samplesPerBlock);
+        reverb.prepare(sampleRate, samplesPerBlock);
+    }
+
+    void reset() {
+        chorus.reset();
+        delay.reset();
+        reverb.reset();
+    }
+
+    Chorus& getChorus() { return chorus; }
+    PingPongDelay& getDelay() { return delay; }
+    Reverb& getReverb() { return reverb; }
+
+    /**
+     * True if any effect is on or still fading out.
+     */
+    bool isActive() const { return chorus.isActive() || delay.isActive() || reverb.isActive(); }
+
+    /**
+     * Process the stereo bus in place.
+     * @param probe Probe buffer receiving the left channel after the effect at
+     *              probePoint, or nullptr to skip probing
+     */
+    void process(float* left, float* right, int numSamples, ProbeBuffer* probe, ProbePoint probePoint) {
+        const std::pair<EffectNode*, ProbePoint> stages[] = {
+            {&chorus, ProbePoint::Chorus},
+            {&delay, ProbePoint::Delay},
+            {&reverb, ProbePoint::Reverb},
+        };
+
+        for (const auto& [effect, point] : stages) {
+            if (effect->isActive())
+                effect->process(left, right, numSamples);
+
+            if (probe != nullptr && point == probePoint) {
+                VIZASYNTH_DSP_STAGE(ProbeWrite);
+                probe->pushUnrecorded(left, numSamples);
+            }
+        }
+    }
+
+private:
+    Chorus chorus;
+    PingPongDelay delay;
+    Reverb reverb;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EffectsBus)
+};
+
+} // namespace vizasynth
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "EffectNode.h"
+#include "DelayLine.h"
+#include <array>
+#include <cmath>
+
+namespace vizasynth {
+
+/**
+ * PingPongDelay - Stereo echo that alternates between the channels
+ *
+ * The mono sum of the input enters the left line; each echo is fed back
+ * into the opposite line, so repeats bounce left, right, left. The delay
+ * is a whole number of samples and at least a sub-block, so every pass is
+ * a block read, a few vector multiply-adds and a block write.
+ *
+ * A new delay time moves the read tap at the next sub-block. That sub-block
+ * reads both taps and crossfades from the old one to the new one, so an
+ * automated delay time glides instead of jumping (and clicking).
+ */
+class PingPongDelay : public EffectNode {
+public:
+    static constexpr double MaxDelayMs = 2000.0;
+
+    /**
+     * Time between repeats in milliseconds.
+     */
+    void setDelayMs(float milliseconds) {
+        delayMs = juce::jlimit(1.0f, static_cast<float>(MaxDelayMs), milliseconds);
+        updateDelaySamples();
+    }
+
+    float getDelayMs() const { return delayMs; }
+
+    /**
+     * Level of each repeat relative to the previous one, 0 to 0.95.
+     */
+    void setFeedback(float gain) { feedback = juce::jlimit(0.0f, 0.95f, gain); }
+    float getFeedback() const { return feedback; }
+
+    void reset() override {
+        leftLine.clear();
+        rightLine.clear();
+        lastOutput = 0.0f;
+    }
+
+    bool isLTI() const override { return true; }
+
+    std::string getName() const override { return "Ping-Pong Delay"; }
+    std::string getDescription() const override {
+        return "Repeats of the signal that alternate between left and right, each quieter than the last";
+    }
+    std::string getProcessingType() const override { return "LTI System"; }
+    std::string getEquationLatex() const override {
+        return "y_L[n] = x[n - D] + g\\,y_R[n - D], \\quad y_R[n] = g\\,y_L[n - D]";
+    }
+
+protected:
+    void prepareEffect(double sampleRate) override {
+        const int maxDelay = static_cast<int>(std::ceil(sampleRate * MaxDelayMs / 1000.0));
+        leftLine.prepare(std::max(maxDelay, MaxSubBlock));
+        rightLine.prepare(std::max(maxDelay, MaxSubBlock));
+        updateDelaySamples();
+        delaySamples = targetDelaySamples;
+    }
+
+    void restart() override {
+        leftLine.restart();
+        rightLine.restart();
+    }
+
+    void renderWet(const float* left, const float* right, float* wetLeft, float* wetRight,
+                   int numSamples) override {
+        using Vector = juce::FloatVectorOperations;
+
+        leftLine.read(wetLeft, delaySamples, numSamples);
+        rightLine.read(wetRight, delaySamples, numSamples);
+
+        if (targetDelaySamples != delaySamples) {
+            leftLine.read(newTap.data(), targetDelaySamples, numSamples);
+            crossfadeTo(wetLeft, newTap.data(), numSamples);
+            rightLine.read(newTap.data(), targetDelaySamples, numSamples);
+            crossfadeTo(wetRight, newTap.data(), numSamples);
+            delaySamples = targetDelaySamples;
+        }
+
+        // Left line: the mono input plus the right echo
+        Vector::add(feed.data(), left, right, numSamples);
+        Vector::multiply(feed.data(), 0.5f, numSamples);
+        Vector::addWithMultiply(feed.data(), wetRight, feedback, numSamples);
+        leftLine.write(feed.data(), numSamples);
+
+        // Right line: the left echo
+        Vector::multiply(feed.data(), wetLeft, feedback, numSamples);
+        rightLine.write(feed.data(), numSamples);
+    }
+
+private:
+    void updateDelaySamples() {
+        const int samples = static_cast<int>(std::lround(delayMs * currentSampleRate / 1000.0));
+        targetDelaySamples = juce::jlimit(MaxSubBlock, std::max(MaxSubBlock, leftLine.getMaxDelay()), samples);
+    }
+
+    /**
+     * Linear fade from the old tap (in place) to the new one across the sub-block.
+     */
+    static void crossfadeTo(float* oldTap, const float* newTap, int numSamples) {
+        const float step = 1.0f / static_cast<float>(numSamples);
+        for (int i = 0; i < numSamples; ++i)
+            oldTap[i] += step * static_cast<float>(i + 1) * (newTap[i] - oldTap[i]);
+    }
+
+    DelayLine leftLine;
+    DelayLine rightLine;
+    std::array<float, MaxSubBlock> feed{};
+    std::array<float, MaxSubBlock> newTap{};
+
+    float delayMs = 375.0f;
+    float feedback = 0.4f;
+    int delaySamples = 16538;        // Tap being read
+    int targetDelaySamples = 16538;  // Tap for the current delay time
+};
+
+} // namespace vizasynth
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "EffectNode.h"
+#include "DelayLine.h"
+#include <array>
+#include <cmath>
+
+namespace vizasynth {
+
+/**
+ * Reverb - Schroeder/Moorer algorithmic reverb (the Freeverb topology)
+ *
+ * Per channel, eight lowpass-feedback comb filters in parallel feed four
+ * allpass filters in series; the right channel's delays are slightly
+ * longer to decorrelate the two. Room size sets the comb feedback and
+ * damping the lowpass in the feedback path.
+ *
+ * Every delay is longer than a sub-block, so combs and allpasses read and
+ * write whole blocks. The allpasses are pure vector arithmetic. The combs'
+ * damping filters are recursive; four of them run side by side in one
+ * loop so their dependency chains overlap and vectorise across combs.
+ */
+class Reverb : public EffectNode {
+public:
+    static constexpr int NumCombs = 8;
+    static constexpr int NumAllpasses = 4;
+
+    /**
+     * Room size, 0 (small, short tail) to 1 (large, long tail).
+     */
+    void setRoomSize(float size) {
+        roomSize = juce::jlimit(0.0f, 1.0f, size);
+        combFeedback = roomSize * 0.28f + 0.7f;
+    }
+
+    float getRoomSize() const { return roomSize; }
+
+    /**
+     * High-frequency damping of the tail, 0 (bright) to 1 (dark).
+     */
+    void setDamping(float amount) {
+        damping = juce::jlimit(0.0f, 1.0f, amount);
+        combDamping = damping * 0.4f;
+    }
+
+    float getDamping() const { return damping; }
+
+    void reset() override {
+        for (auto& channel : channels) {
+            for (auto& comb : channel.combs)
+                comb.clear();
+            for (auto& allpass : channel.allpasses)
+                allpass.clear();
+            channel.combState.fill(0.0f);
+        }
+
+        lastOutput = 0.0f;
+    }
+
+    std::string getName() const override { return "Reverb"; }
+    std::string getDescription() const override {
+        return "Dense, decaying reflections from parallel comb and series allpass filters";
+    }
+    std::string getProcessingType() const override { return "LTI System"; }
+    std::string getEquationLatex() const override {
+        return "H(z) = \\prod_k A_k(z) \\sum_c \\frac{z^{-N_c}}{1 - g\\,L(z)\\,z^{-N_c}}";
+    }
+    bool isLTI() const override { return true; }
+
+protected:
+    void prepareEffect(double sampleRate) override {
+        // Freeverb's tunings at 44.1 kHz, scaled to the sample rate
+        static constexpr std::array<int, NumCombs> combTunings = {1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617};
+        static constexpr std::array<int, NumAllpasses> allpassTunings = {556, 441, 341, 225};
+        static constexpr int StereoSpread = 23;
+
+        const double scale = sampleRate / 44100.0;
+        auto scaled = [scale](int samples) {
+            return std::max(MaxSubBlock, static_cast<int>(std::lround(samples * scale)));
+        };
+
+        for (size_t side = 0; side < channels.size(); ++side) {
+            auto& channel = channels[side];
+            const int spread = side == 0 ? 0 : StereoSpread;
+
+            for (size_t c = 0; c < NumCombs; ++c) {
+                channel.combLengths[c] = scaled(combTunings[c] + spread);
+                channel.combs[c].prepare(channel.combLengths[c]);
+            }
+
+            for (size_t a = 0; a < NumAllpasses; ++a) {
+                channel.allpassLengths[a] = scaled(allpassTunings[a] + spread);
+                channel.allpasses[a].prepare(channel.allpassLengths[a]);
+            }
+        }
+    }
+
+    void restart() override {
+        for (auto& channel : channels) {
+            for (auto& comb : channel.combs)
+                comb.restart();
+            for (auto& allpass : channel.allpasses)
+                allpass.restart();
+            channel.combState.fill(0.0f);
+        }
+    }
+
+    void renderWet(const float* left, const float* right, float* wetLeft, float* wetRight,
+                   int numSamples) override {
+        using Vector = juce::FloatVectorOperations;
+
+        // Both channels share the mono input, as in Freeverb
+        Vector::add(input.data(), left, right, numSamples);
+        Vector::multiply(input.data(), InputGain, numSamples);
+
+        renderChannel(channels[0], wetLeft, numSamples);
+        renderChannel(channels[1], wetRight, numSamples);
+    }
+
+private:
+    static constexpr float InputGain = 0.015f;
+    static constexpr float WetGain = 3.0f;
+    static constexpr float AllpassFeedback = 0.5f;
+
+    struct Channel {
+        std::array<DelayLine, NumCombs> combs;
+        std::array<DelayLine, NumAllpasses> allpasses;
+        std::array<int, NumCombs> combLengths{};
+        std::array<int, NumAllpasses> allpassLengths{};
+        std::array<float, NumCombs> combState{};
+    };
+
+    void renderChannel(Channel& channel, float* output, int numSamples) {
+        using Vector = juce::FloatVectorOperations;
+
+        for (size_t c = 0; c < NumCombs; ++c)
+            channel.combs[c].read(combOut[c].data(), channel.combLengths[c], numSamples);
+
+        for (size_t c = 0; c < NumCombs; c += 4)
+            runDampingFilters(channel, c, numSamples);
+
+        Vector::copy(output, combOut[0].data(), numSamples);
+        for (size_t c = 0; c < NumCombs; ++c) {
+            channel.combs[c].write(combIn[c].data(), numSamples);
+            if (c > 0)
+                Vector::add(output, combOut[c].data(), numSamples);
+        }
+
+        // Allpass: out = delayed - in, into the line goes in + delayed / 2
+        for (size_t a = 0; a < NumAllpasses; ++a) {
+            auto& line = channel.allpasses[a];
+            line.read(delayed.data(), channel.allpassLengths[a], numSamples);
+
+            Vector::copy(feed.data(), output, numSamples);
+            Vector::addWithMultiply(feed.data(), delayed.data(), AllpassFeedback, numSamples);
+            Vector::subtract(output, delayed.data(), output, numSamples);
+            line.write(feed.data(), numSamples);
+        }
+
+        Vector::multiply(output, WetGain, numSamples);
+    }
+
+    /**
+     * Lowpass in the feedback path of four combs, with four independent
+     * filter states per sample.
+     */
+    void runDampingFilters(Channel& channel, size_t firstComb, int numSamples) {
+        const float damp1 = combDamping;
+        const float damp2 = 1.0f - combDamping;
+        const float gain = combFeedback;
+
+        const float* out0 = combOut[firstComb].data();
+        const float* out1 = combOut[firstComb + 1].data();
+        const float* out2 = combOut[firstComb + 2].data();
+        const float* out3 = combOut[firstComb + 3].data();
+        float* in0 = combIn[firstComb].data();
+        float* in1 = combIn[firstComb + 1].data();
+        float* in2 = combIn[firstComb + 2].data();
+        float* in3 = combIn[firstComb + 3].data();
+
+        float s0 = channel.combState[firstComb];
+        float s1 = channel.combState[firstComb + 1];
+        float s2 = channel.combState[firstComb + 2];
+        float s3 = channel.combState[firstComb + 3];
+
+        for (int i = 0; i < numSamples; ++i) {
+            const float x = input[static_cast<size_t>(i)];
+
+            s0 = out0[i] * damp2 + s0 * damp1;
+            s1 = out1[i] * damp2 + s1 * damp1;
+            s2 = out2[i] * damp2 + s2 * damp1;
+            s3 = out3[i] * damp2 + s3 * damp1;
+
+            in0[i] = x + s0 * gain;
+            in1[i] = x + s1 * gain;
+            in2[i] = x + s2 * gain;
+            in3[i] = x + s3 * gain;
+        }
+
+        channel.combState[firstComb] = s0;
+        channel.combState[firstComb + 1] = s1;
+        channel.combState[firstComb + 2] = s2;
+        channel.combState[firstComb + 3] = s3;
+    }
+
+    std::array<Channel, 2> channels;
+
+    // Sub-block scratch
+    std::array<float, MaxSubBlock> input{};
+    std::array<float, MaxSubBlock> delayed{};
+    std::array<float, MaxSubBlock> feed{};
+    std::array<std::array<float, MaxSubBlock>, NumCombs> combOut{};
+    std::array<std::array<float, MaxSubBlock>, NumCombs> combIn{};
+
+    float roomSize = 0.6f;
+    float damping = 0.5f;
+    float combFeedback = 0.6f * 0.28f + 0.7f;
+    float combDamping = 0.5f * 0.4f;
+};
+
+} // namespace vizasynth
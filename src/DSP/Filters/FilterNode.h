@@ -95,7 +95,7 @@ public:
      * Get the transfer function H(z).
      * Must be implemented by all filter types.
      */
-    TransferFunction getTransferFunction() const override = 0;
+    std::optional<TransferFunction> getTransferFunction() const override = 0;
 
     /**
      * Get the pole locations in the z-plane.
@@ -117,7 +117,10 @@ public:
         FrequencyResponse response(static_cast<float>(getSampleRate()));
         response.reserve(static_cast<size_t>(numPoints));
 
-        TransferFunction tf = getTransferFunction();
+        auto tf = getTransferFunction();
+        if (!tf)
+            return response;
+
         float sampleRate = static_cast<float>(getSampleRate());
 
         for (int i = 0; i < numPoints; ++i) {
@@ -131,7 +134,7 @@ public:
             float normalizedFreq = (2.0f * static_cast<float>(M_PI) * freqHz) / sampleRate;
 
             // Evaluate H(e^jω)
-            Complex H = tf.evaluateAtFrequency(normalizedFreq);
+            Complex H = tf->evaluateAtFrequency(normalizedFreq);
 
             float magLinear = std::abs(H);
             float magDB = 20.0f * std::log10(std::max(magLinear, 1e-10f));
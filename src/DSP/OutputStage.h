@@ -0,0 +1,236 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../Visualization/ProbeBuffer.h"
+#include "../Core/DspLoadMonitor.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace vizasynth {
+
+/**
+ * OutputStage - Fused post-render pass over the master bus
+ *
+ * Replaces separate applyGain / getMagnitude / per-sample probe passes with a
+ * single pass per channel that:
+ *   - Applies a linearly smoothed master gain (no zipper noise on volume moves)
+ *   - Accumulates peak and sum of squares for metering
+ *   - Bulk-copies channel 0 into the mix probe buffer while it is still in cache
+ *   - Optionally expands a mono voice bus to the host channel layout
+ *
+ * The steady-state loop keeps four independent accumulators so the compiler
+ * can vectorise it without relying on fast-math reassociation.
+ */
+class OutputStage {
+public:
+    static constexpr int MaxMeteredChannels = 2;
+
+    /**
+     * Per-block metering results.
+     */
+    struct Metering {
+        std::array<float, MaxMeteredChannels> peak{};
+        std::array<float, MaxMeteredChannels> rms{};
+        float maxPeak = 0.0f;
+        float maxRms = 0.0f;
+        bool clipped = false;
+    };
+
+    OutputStage() = default;
+
+    /**
+     * Prepare for playback.
+     * @param sampleRate The sample rate in Hz
+     * @param rampSeconds Length of the master gain ramp
+     */
+    void prepare(double sampleRate, double rampSeconds = 0.02) {
+        rampLengthSamples = std::max(1, static_cast<int>(sampleRate * rampSeconds));
+        currentGain = targetGain;
+        gainStep = 0.0f;
+        rampSamplesRemaining = 0;
+    }
+
+    /**
+     * Set the master gain target in decibels.
+     * The dB to linear conversion only runs when the value actually changes.
+     */
+    void setTargetGainDecibels(float dB) {
+        if (dB == lastTargetDecibels)
+            return;
+
+        lastTargetDecibels = dB;
+        setTargetGain(juce::Decibels::decibelsToGain(dB));
+    }
+
+    /**
+     * Set the master gain target as a linear value.
+     */
+    void setTargetGain(float gain) {
+        if (gain == targetGain)
+            return;
+
+        targetGain = gain;
+        rampSamplesRemaining = rampLengthSamples;
+        gainStep = (targetGain - currentGain) / static_cast<float>(rampLengthSamples);
+    }
+
+    float getCurrentGain() const { return currentGain; }
+
+    /**
+     * Apply gain, meter and probe the given region of the buffer in one pass.
+     * @param buffer The buffer to process in place
+     * @param startSample First sample to process
+     * @param numSamples Number of samples to process
+     * @param mixProbe Probe buffer receiving channel 0, or nullptr to skip probing
+     */
+    Metering process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                     ProbeBuffer* mixProbe) {
+        return processChannels(buffer.getArrayOfReadPointers(), buffer.getNumChannels(),
+                               buffer.getArrayOfWritePointers(), buffer.getNumChannels(),
+                               startSample, numSamples, mixProbe);
+    }
+
+    /**
+     * Expand a mono or stereo voice bus to the host layout while applying gain,
+     * metering and probing, so the expansion costs no extra pass.
+     * Host channels beyond the bus width reuse the last bus channel.
+     * @param source The voice bus (starting at sample 0)
+     * @param destination The host buffer (starting at sample 0)
+     * @param numSamples Number of samples to process
+     * @param mixProbe Probe buffer receiving channel 0, or nullptr to skip probing
+     */
+    Metering process(const juce::AudioBuffer<float>& source, juce::AudioBuffer<float>& destination,
+                     int numSamples, ProbeBuffer* mixProbe) {
+        return processChannels(source.getArrayOfReadPointers(), source.getNumChannels(),
+                               destination.getArrayOfWritePointers(), destination.getNumChannels(),
+                               0, numSamples, mixProbe);
+    }
+
+private:
+    Metering processChannels(const float* const* source, int numSourceChannels,
+                             float* const* destination, int numDestChannels,
+                             int startSample, int numSamples, ProbeBuffer* mixProbe) {
+        Metering result;
+
+        if (numSourceChannels <= 0)
+            return result;
+
+        const int rampSamples = std::min(numSamples, rampSamplesRemaining);
+        const float steadyGain = rampSamples == rampSamplesRemaining
+                                     ? targetGain
+                                     : currentGain + gainStep * static_cast<float>(rampSamples);
+
+        for (int channel = 0; channel < numDestChannels; ++channel) {
+            const float* in = source[std::min(channel, numSourceChannels - 1)] + startSample;
+            float* out = destination[channel] + startSample;
+            float peak = 0.0f;
+            float sumSquares = 0.0f;
+
+            processRamp(in, out, rampSamples, currentGain, gainStep, peak, sumSquares);
+            processConstant(in + rampSamples, out + rampSamples, numSamples - rampSamples,
+                            steadyGain, peak, sumSquares);
+
+            if (channel == 0 && mixProbe != nullptr) {
+                VIZASYNTH_DSP_STAGE(ProbeWrite);
+                mixProbe->push(out, numSamples);
+            }
+
+            const float rms = numSamples > 0 ? std::sqrt(sumSquares / static_cast<float>(numSamples)) : 0.0f;
+
+            if (channel < MaxMeteredChannels) {
+                result.peak[static_cast<size_t>(channel)] = peak;
+                result.rms[static_cast<size_t>(channel)] = rms;
+            }
+
+            result.maxPeak = std::max(result.maxPeak, peak);
+            result.maxRms = std::max(result.maxRms, rms);
+        }
+
+        result.clipped = result.maxPeak >= 1.0f;
+
+        advanceRamp(numSamples);
+        return result;
+    }
+
+    /**
+     * Ramp section: gain changes every sample, so keep it simple.
+     */
+    static void processRamp(const float* in, float* out, int numSamples, float startGain, float step,
+                            float& peak, float& sumSquares) {
+        for (int i = 0; i < numSamples; ++i) {
+            const float gain = startGain + step * static_cast<float>(i + 1);
+            const float x = in[i] * gain;
+            out[i] = x;
+            peak = std::max(peak, std::abs(x));
+            sumSquares += x * x;
+        }
+    }
+
+    /**
+     * Steady section: constant gain with four independent accumulator lanes.
+     */
+    static void processConstant(const float* in, float* out, int numSamples, float gain,
+                                float& peak, float& sumSquares) {
+        float p0 = peak, p1 = 0.0f, p2 = 0.0f, p3 = 0.0f;
+        float s0 = sumSquares, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4) {
+            const float x0 = in[i] * gain;
+            const float x1 = in[i + 1] * gain;
+            const float x2 = in[i + 2] * gain;
+            const float x3 = in[i + 3] * gain;
+
+            out[i] = x0;
+            out[i + 1] = x1;
+            out[i + 2] = x2;
+            out[i + 3] = x3;
+
+            p0 = std::max(p0, std::abs(x0));
+            p1 = std::max(p1, std::abs(x1));
+            p2 = std::max(p2, std::abs(x2));
+            p3 = std::max(p3, std::abs(x3));
+
+            s0 += x0 * x0;
+            s1 += x1 * x1;
+            s2 += x2 * x2;
+            s3 += x3 * x3;
+        }
+
+        for (; i < numSamples; ++i) {
+            const float x = in[i] * gain;
+            out[i] = x;
+            p0 = std::max(p0, std::abs(x));
+            s0 += x * x;
+        }
+
+        peak = std::max(std::max(p0, p1), std::max(p2, p3));
+        sumSquares = (s0 + s1) + (s2 + s3);
+    }
+
+    void advanceRamp(int numSamples) {
+        if (rampSamplesRemaining <= 0)
+            return;
+
+        if (numSamples >= rampSamplesRemaining) {
+            currentGain = targetGain;
+            gainStep = 0.0f;
+            rampSamplesRemaining = 0;
+        } else {
+            currentGain += gainStep * static_cast<float>(numSamples);
+            rampSamplesRemaining -= numSamples;
+        }
+    }
+
+    float currentGain = 1.0f;
+    float targetGain = 1.0f;
+    float gainStep = 0.0f;
+    float lastTargetDecibels = 0.0f;
+    int rampLengthSamples = 882;
+    int rampSamplesRemaining = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OutputStage)
+};
+
+} // namespace vizasynth
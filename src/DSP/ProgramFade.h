@@ -0,0 +1,88 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <algorithm>
+
+namespace vizasynth {
+
+/**
+ * ProgramFade - Short fade-out / fade-in around a program switch
+ *
+ * Switching programs changes every voice parameter at once (oscillator
+ * waveform, filter, envelope), which clicks if it lands mid-waveform. The
+ * voice bus is faded to silence over a few milliseconds, the new parameter
+ * snapshot is applied at the silent sample and the bus fades back up.
+ *
+ * The caller renders in segments: while fading out, getSamplesUntilSilent()
+ * says where to split the block so the switch lands exactly on the silent
+ * sample. When idle, process() is never needed and the render path is
+ * untouched.
+ */
+class ProgramFade {
+public:
+    /**
+     * Prepare for playback.
+     * @param sampleRate The sample rate in Hz
+     * @param fadeSeconds Length of each half of the fade
+     */
+    void prepare(double sampleRate, double fadeSeconds = 0.005) {
+        fadeLengthSamples = std::max(1, static_cast<int>(sampleRate * fadeSeconds));
+        position = fadeLengthSamples;
+        direction = 0;
+    }
+
+    /**
+     * Fade towards silence from the current gain (restarts a fade-in).
+     */
+    void startFadeOut() { direction = -1; }
+
+    /**
+     * Fade back to unity from the current gain.
+     */
+    void startFadeIn() { direction = 1; }
+
+    bool isActive() const { return direction != 0; }
+    bool isFadingOut() const { return direction < 0; }
+    bool isSilent() const { return direction < 0 && position == 0; }
+
+    /**
+     * Samples left before the fade-out reaches silence.
+     */
+    int getSamplesUntilSilent() const { return direction < 0 ? position : 0; }
+
+    /**
+     * Apply the fade to a region of the bus and advance it.
+     * A fade-out holds at silence once it gets there.
+     */
+    void process(juce::AudioBuffer<float>& bus, int startSample, int numSamples) {
+        if (direction == 0)
+            return;
+
+        const float scale = 1.0f / static_cast<float>(fadeLengthSamples);
+        int endPosition = position;
+
+        for (int channel = 0; channel < bus.getNumChannels(); ++channel) {
+            float* data = bus.getWritePointer(channel, startSample);
+            int p = position;
+
+            for (int i = 0; i < numSamples; ++i) {
+                p = std::clamp(p + direction, 0, fadeLengthSamples);
+                data[i] *= static_cast<float>(p) * scale;
+            }
+
+            endPosition = p;
+        }
+
+        position = endPosition;
+
+        if (direction > 0 && position == fadeLengthSamples)
+            direction = 0;
+    }
+
+private:
+    int fadeLengthSamples = 1;
+    int position = 1;   // Current gain = position / fadeLengthSamples
+    int direction = 0;  // -1 fading out, +1 fading in, 0 idle at unity
+};
+
+} // namespace vizasynth
@@ -1,5 +1,6 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "Core/TraceRecorder.h"
 
 //==============================================================================
 VizASynthAudioProcessorEditor::VizASynthAudioProcessorEditor(VizASynthAudioProcessor& p)
@@ -8,6 +9,7 @@ VizASynthAudioProcessorEditor::VizASynthAudioProcessorEditor(VizASynthAudioProce
       oscilloscope(p.getProbeManager()),
       spectrumAnalyzer(p.getProbeManager()),
       harmonicView(p.getProbeManager()),
+      dspLoadView(p.getProbeManager()),
       singleCycleView(p.getProbeManager(),
                       [&]() -> vizasynth::PolyBLEPOscillator& {
                           if (auto* voice = p.getVoice(0)) {
@@ -24,10 +26,13 @@ VizASynthAudioProcessorEditor::VizASynthAudioProcessorEditor(VizASynthAudioProce
     // Register for configuration changes
     config.addChangeListener(this);
 
-    // Add visualization components
+    // Add visualization components; scope and spectrum layers render on worker threads
+    oscilloscope.setBackgroundRendering(true);
+    spectrumAnalyzer.setBackgroundRendering(true);
     addAndMakeVisible(oscilloscope);
     addAndMakeVisible(spectrumAnalyzer);
     addAndMakeVisible(harmonicView);
+    addAndMakeVisible(dspLoadView);
     addAndMakeVisible(singleCycleView);
     addAndMakeVisible(envelopeVisualizer);
 
@@ -47,6 +52,11 @@ VizASynthAudioProcessorEditor::VizASynthAudioProcessorEditor(VizASynthAudioProce
     harmonicsButton.onClick = [this]() { setVisualizationMode(VisualizationMode::Harmonics); };
     addAndMakeVisible(harmonicsButton);
 
+    dspLoadButton.setClickingTogglesState(false);
+    dspLoadButton.setColour(juce::TextButton::buttonColourId, config.getPanelBackgroundColour());
+    dspLoadButton.onClick = [this]() { setVisualizationMode(VisualizationMode::DspLoad); };
+    addAndMakeVisible(dspLoadButton);
+
     // Initial visualization mode
     setVisualizationMode(VisualizationMode::Oscilloscope);
 
@@ -67,6 +77,9 @@ VizASynthAudioProcessorEditor::VizASynthAudioProcessorEditor(VizASynthAudioProce
     setupProbeButton(probeOscButton, vizasynth::ProbePoint::Oscillator, vizasynth::Oscilloscope::getProbeColour(vizasynth::ProbePoint::Oscillator));
     setupProbeButton(probeFilterButton, vizasynth::ProbePoint::PostFilter, vizasynth::Oscilloscope::getProbeColour(vizasynth::ProbePoint::PostFilter));
     setupProbeButton(probeOutputButton, vizasynth::ProbePoint::Output, vizasynth::Oscilloscope::getProbeColour(vizasynth::ProbePoint::Output));
+    setupProbeButton(probeChorusButton, vizasynth::ProbePoint::Chorus, vizasynth::Oscilloscope::getProbeColour(vizasynth::ProbePoint::Chorus));
+    setupProbeButton(probeDelayButton, vizasynth::ProbePoint::Delay, vizasynth::Oscilloscope::getProbeColour(vizasynth::ProbePoint::Delay));
+    setupProbeButton(probeReverbButton, vizasynth::ProbePoint::Reverb, vizasynth::Oscilloscope::getProbeColour(vizasynth::ProbePoint::Reverb));
 
     // Freeze button
     freezeButton.setClickingTogglesState(true);
@@ -78,6 +91,7 @@ VizASynthAudioProcessorEditor::VizASynthAudioProcessorEditor(VizASynthAudioProce
         oscilloscope.setFrozen(frozen);
         spectrumAnalyzer.setFrozen(frozen);
         harmonicView.setFrozen(frozen);
+        dspLoadView.setFrozen(frozen);
         singleCycleView.setFrozen(frozen);
     };
     addAndMakeVisible(freezeButton);
@@ -87,16 +101,36 @@ VizASynthAudioProcessorEditor::VizASynthAudioProcessorEditor(VizASynthAudioProce
     clearTraceButton.onClick = [this]()
     {
         oscilloscope.clearTrace();
-        spectrumAnalyzer.clearFrozenTrace();
+        spectrumAnalyzer.clearTrace();
         harmonicView.clearTrace();
+        dspLoadView.clearTrace();
         singleCycleView.clearFrozenTrace();
     };
     addAndMakeVisible(clearTraceButton);
 
+    // Trace capture toggle (Chrome trace of the audio and UI threads).
+    // Only offered in the Standalone app; hosts have their own profilers.
+    traceButton.setClickingTogglesState(false);
+    traceButton.setColour(juce::TextButton::buttonColourId, config.getPanelBackgroundColour());
+    traceButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::red.darker());
+    traceButton.setToggleState(vizasynth::TraceRecorder::isCapturing(), juce::dontSendNotification);
+    traceButton.onClick = [this]() { toggleTraceCapture(); };
+    if (audioProcessor.wrapperType == juce::AudioProcessor::wrapperType_Standalone)
+        addAndMakeVisible(traceButton);
+
+    // Probe recording toggle (voice tap and mix streamed to disk)
+    recordButton.setClickingTogglesState(false);
+    recordButton.setColour(juce::TextButton::buttonColourId, config.getPanelBackgroundColour());
+    recordButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::red.darker());
+    recordButton.setToggleState(audioProcessor.getProbeManager().getRecorder().isRecording(), juce::dontSendNotification);
+    recordButton.onClick = [this]() { toggleProbeRecording(); };
+    addAndMakeVisible(recordButton);
+
     // Time window slider
     timeWindowSlider.setSliderStyle(juce::Slider::LinearHorizontal);
     timeWindowSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 50, 20);
-    timeWindowSlider.setRange(1.0, 50.0, 0.5);
+    timeWindowSlider.setRange(1.0, vizasynth::Oscilloscope::MaxRollWindowMs, 0.5);
+    timeWindowSlider.setSkewFactorFromMidPoint(50.0);
     timeWindowSlider.setValue(10.0);
     timeWindowSlider.setTextValueSuffix(" ms");
     timeWindowSlider.onValueChange = [this]()
@@ -253,6 +287,7 @@ VizASynthAudioProcessorEditor::~VizASynthAudioProcessorEditor()
 //==============================================================================
 void VizASynthAudioProcessorEditor::paint(juce::Graphics& g)
 {
+    VIZASYNTH_TRACE_SCOPE("paint", "editor");
     auto& config = vizasynth::ConfigurationManager::getInstance();
 
     // Dark background
@@ -495,6 +530,7 @@ void VizASynthAudioProcessorEditor::resized()
         singleCycleView.setBounds(scopeArea.reduced(0, 2));
         spectrumAnalyzer.setBounds(scopeArea);  // Hidden but positioned
         harmonicView.setBounds(scopeArea);      // Hidden but positioned
+        dspLoadView.setBounds(scopeArea);       // Hidden but positioned
     }
     else if (currentVizMode == VisualizationMode::Spectrum)
     {
@@ -502,40 +538,67 @@ void VizASynthAudioProcessorEditor::resized()
         oscilloscope.setBounds(scopeArea);      // Hidden but positioned
         singleCycleView.setBounds(scopeArea);   // Hidden but positioned
         harmonicView.setBounds(scopeArea);      // Hidden but positioned
+        dspLoadView.setBounds(scopeArea);       // Hidden but positioned
     }
-    else // Harmonics mode
+    else if (currentVizMode == VisualizationMode::Harmonics)
     {
         harmonicView.setBounds(scopeArea);
         oscilloscope.setBounds(scopeArea);      // Hidden but positioned
         singleCycleView.setBounds(scopeArea);   // Hidden but positioned
         spectrumAnalyzer.setBounds(scopeArea);  // Hidden but positioned
+        dspLoadView.setBounds(scopeArea);       // Hidden but positioned
+    }
+    else // DSP load mode
+    {
+        dspLoadView.setBounds(scopeArea);
+        oscilloscope.setBounds(scopeArea);      // Hidden but positioned
+        singleCycleView.setBounds(scopeArea);   // Hidden but positioned
+        spectrumAnalyzer.setBounds(scopeArea);  // Hidden but positioned
+        harmonicView.setBounds(scopeArea);      // Hidden but positioned
     }
 
     // Controls below visualization
     int harmonicsButtonWidth = config.getLayoutInt("components.buttons.harmonics.width", 70);
+    int dspLoadButtonWidth = config.getLayoutInt("components.buttons.dspLoad.width", 45);
     auto vizControlArea = vizArea.reduced(layout.vizControlAreaHPad, layout.vizControlAreaVPad);
     scopeButton.setBounds(vizControlArea.removeFromLeft(layout.vizControlScopeWidth));
     vizControlArea.removeFromLeft(layout.vizControlScopeSpacing);
     spectrumButton.setBounds(vizControlArea.removeFromLeft(layout.vizControlSpectrumWidth));
     vizControlArea.removeFromLeft(layout.vizControlScopeSpacing);
     harmonicsButton.setBounds(vizControlArea.removeFromLeft(harmonicsButtonWidth));
+    vizControlArea.removeFromLeft(layout.vizControlScopeSpacing);
+    dspLoadButton.setBounds(vizControlArea.removeFromLeft(dspLoadButtonWidth));
     vizControlArea.removeFromLeft(layout.vizControlSectionSpacing);
     probeOscButton.setBounds(vizControlArea.removeFromLeft(layout.vizControlProbeWidth));
     vizControlArea.removeFromLeft(layout.vizControlProbeSpacing);
     probeFilterButton.setBounds(vizControlArea.removeFromLeft(layout.vizControlProbeWidth));
     vizControlArea.removeFromLeft(layout.vizControlProbeSpacing);
     probeOutputButton.setBounds(vizControlArea.removeFromLeft(layout.vizControlProbeWidth));
+    vizControlArea.removeFromLeft(layout.vizControlProbeSpacing);
+    probeChorusButton.setBounds(vizControlArea.removeFromLeft(layout.vizControlProbeWidth));
+    vizControlArea.removeFromLeft(layout.vizControlProbeSpacing);
+    probeDelayButton.setBounds(vizControlArea.removeFromLeft(layout.vizControlProbeWidth));
+    vizControlArea.removeFromLeft(layout.vizControlProbeSpacing);
+    probeReverbButton.setBounds(vizControlArea.removeFromLeft(layout.vizControlProbeWidth));
     vizControlArea.removeFromLeft(layout.vizControlSectionSpacing);
     freezeButton.setBounds(vizControlArea.removeFromLeft(layout.vizControlFreezeWidth));
     vizControlArea.removeFromLeft(layout.vizControlProbeSpacing);
     clearTraceButton.setBounds(vizControlArea.removeFromLeft(layout.vizControlClearWidth));
     vizControlArea.removeFromLeft(layout.vizControlSectionSpacing);
+    if (audioProcessor.wrapperType == juce::AudioProcessor::wrapperType_Standalone)
+    {
+        traceButton.setBounds(vizControlArea.removeFromLeft(config.getLayoutInt("components.buttons.trace.width", 50)));
+        vizControlArea.removeFromLeft(layout.vizControlSectionSpacing);
+    }
+    recordButton.setBounds(vizControlArea.removeFromLeft(config.getLayoutInt("components.buttons.record.width", 45)));
+    vizControlArea.removeFromLeft(layout.vizControlSectionSpacing);
     timeWindowLabel.setBounds(vizControlArea.removeFromLeft(layout.vizControlLabelWidth));
     timeWindowSlider.setBounds(vizControlArea);
 }
 
 void VizASynthAudioProcessorEditor::timerCallback()
 {
+    VIZASYNTH_TRACE_SCOPE("timer", "Editor::timerCallback");
     // Update probe button highlighting
     updateProbeButtons();
 
@@ -610,15 +673,17 @@ void VizASynthAudioProcessorEditor::applyThemeToComponents()
     auto buttonText = config.getThemeColour("colors.buttons.text", juce::Colour(0xffe0e0e0));
     auto toggleOnColor = config.getThemeColour("colors.buttons.toggleOn", juce::Colours::red.darker());
 
-    for (auto* btn : {&scopeButton, &spectrumButton, &harmonicsButton, &probeOscButton, &probeFilterButton,
-                      &probeOutputButton, &clearTraceButton}) {
+    for (auto* btn : {&scopeButton, &spectrumButton, &harmonicsButton, &dspLoadButton, &probeOscButton, &probeFilterButton,
+                      &probeOutputButton, &probeChorusButton, &probeDelayButton, &probeReverbButton, &clearTraceButton}) {
         btn->setColour(juce::TextButton::buttonColourId, buttonDefault);
         btn->setColour(juce::TextButton::textColourOffId, buttonText);
     }
 
-    freezeButton.setColour(juce::TextButton::buttonColourId, buttonDefault);
-    freezeButton.setColour(juce::TextButton::buttonOnColourId, toggleOnColor);
-    freezeButton.setColour(juce::TextButton::textColourOffId, buttonText);
+    for (auto* btn : {&freezeButton, &traceButton, &recordButton}) {
+        btn->setColour(juce::TextButton::buttonColourId, buttonDefault);
+        btn->setColour(juce::TextButton::buttonOnColourId, toggleOnColor);
+        btn->setColour(juce::TextButton::textColourOffId, buttonText);
+    }
 
     // Apply label colors
     auto labelColor = config.getThemeColour("colors.labels.text", juce::Colour(0xffe0e0e0));
@@ -657,6 +722,74 @@ void VizASynthAudioProcessorEditor::updateProbeButtons()
                     vizasynth::Oscilloscope::getProbeColour(vizasynth::ProbePoint::PostFilter));
     highlightButton(probeOutputButton, activeProbe == vizasynth::ProbePoint::Output,
                     vizasynth::Oscilloscope::getProbeColour(vizasynth::ProbePoint::Output));
+    highlightButton(probeChorusButton, activeProbe == vizasynth::ProbePoint::Chorus,
+                    vizasynth::Oscilloscope::getProbeColour(vizasynth::ProbePoint::Chorus));
+    highlightButton(probeDelayButton, activeProbe == vizasynth::ProbePoint::Delay,
+                    vizasynth::Oscilloscope::getProbeColour(vizasynth::ProbePoint::Delay));
+    highlightButton(probeReverbButton, activeProbe == vizasynth::ProbePoint::Reverb,
+                    vizasynth::Oscilloscope::getProbeColour(vizasynth::ProbePoint::Reverb));
+}
+
+void VizASynthAudioProcessorEditor::toggleTraceCapture()
+{
+    auto& recorder = vizasynth::TraceRecorder::getInstance();
+
+    if (recorder.isCapturing())
+    {
+        recorder.stopCapture();
+        traceButton.setToggleState(false, juce::dontSendNotification);
+
+        auto message = "Saved to " + recorder.getCaptureFile().getFullPathName()
+                     + "\n\nOpen it in ui.perfetto.dev or chrome://tracing.";
+        if (auto dropped = recorder.getDroppedEventCount(); dropped > 0)
+            message << "\n" << juce::String(static_cast<juce::int64>(dropped)) << " events were dropped.";
+
+        juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::InfoIcon, "Trace captured", message);
+    }
+    else
+    {
+        auto file = vizasynth::TraceRecorder::createDefaultCaptureFile();
+
+        if (recorder.startCapture(file))
+            traceButton.setToggleState(true, juce::dontSendNotification);
+        else
+            juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Trace capture",
+                                                   "Couldn't create " + file.getFullPathName());
+    }
+}
+
+void VizASynthAudioProcessorEditor::toggleProbeRecording()
+{
+    auto& probeManager = audioProcessor.getProbeManager();
+    auto& recorder = probeManager.getRecorder();
+
+    if (recorder.isRecording())
+    {
+        probeManager.stopRecording();
+        recordButton.setToggleState(false, juce::dontSendNotification);
+
+        juce::String message = "Saved to";
+        for (auto tap : {vizasynth::ProbeRecorder::VoiceTap, vizasynth::ProbeRecorder::MixTap})
+            message << "\n" << recorder.getFile(tap).getFullPathName();
+
+        if (auto dropped = recorder.getDroppedSamples(); dropped > 0)
+            message << "\n\n" << juce::String(static_cast<juce::int64>(dropped))
+                    << " samples were dropped because the disk fell behind.";
+        if (recorder.hasWriteError())
+            message << "\n\nA write failed; the recording may be incomplete.";
+
+        juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::InfoIcon, "Probe recording", message);
+    }
+    else
+    {
+        auto file = vizasynth::ProbeRecorder::createDefaultCaptureFile();
+
+        if (probeManager.startRecording(file))
+            recordButton.setToggleState(true, juce::dontSendNotification);
+        else
+            juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Probe recording",
+                                                   "Couldn't create " + file.getFullPathName() + "-*.w64");
+    }
 }
 
 void VizASynthAudioProcessorEditor::setVisualizationMode(VisualizationMode mode)
@@ -671,12 +804,14 @@ void VizASynthAudioProcessorEditor::updateVisualizationMode()
     bool isScope = (currentVizMode == VisualizationMode::Oscilloscope);
     bool isSpectrum = (currentVizMode == VisualizationMode::Spectrum);
     bool isHarmonics = (currentVizMode == VisualizationMode::Harmonics);
+    bool isDspLoad = (currentVizMode == VisualizationMode::DspLoad);
 
     // Show/hide appropriate visualization
     oscilloscope.setVisible(isScope);
     singleCycleView.setVisible(isScope);
     spectrumAnalyzer.setVisible(isSpectrum);
     harmonicView.setVisible(isHarmonics);
+    dspLoadView.setVisible(isDspLoad);
 
     // Update button highlighting
     scopeButton.setColour(juce::TextButton::buttonColourId,
@@ -685,6 +820,8 @@ void VizASynthAudioProcessorEditor::updateVisualizationMode()
                              isSpectrum ? config.getAccentColour() : config.getPanelBackgroundColour());
     harmonicsButton.setColour(juce::TextButton::buttonColourId,
                               isHarmonics ? config.getAccentColour() : config.getPanelBackgroundColour());
+    dspLoadButton.setColour(juce::TextButton::buttonColourId,
+                            isDspLoad ? config.getAccentColour() : config.getPanelBackgroundColour());
 
     // Show/hide time window control (only relevant for oscilloscope)
     timeWindowSlider.setEnabled(isScope);
@@ -2,8 +2,9 @@
 
 #include "PluginProcessor.h"
 #include "Visualization/TimeDomain/Oscilloscope.h"
-#include "Visualization/SpectrumAnalyzer.h"
+#include "Visualization/FrequencyDomain/SpectrumAnalyzer.h"
 #include "Visualization/FrequencyDomain/HarmonicView.h"
+#include "Visualization/Diagnostics/DspLoadView.h"
 #include "Visualization/SingleCycleView.h"
 #include "Visualization/EnvelopeVisualizer.h"
 #include "UI/LevelMeter.h"
@@ -18,7 +19,8 @@ enum class VisualizationMode
 {
     Oscilloscope,
     Spectrum,
-    Harmonics
+    Harmonics,
+    DspLoad
 };
 
 //==============================================================================
@@ -44,6 +46,8 @@ private:
     void updateVisualizationMode();
     void setVisualizationMode(VisualizationMode mode);
     void applyThemeToComponents();
+    void toggleTraceCapture();
+    void toggleProbeRecording();
 
     VizASynthAudioProcessor& audioProcessor;
 
@@ -54,6 +58,7 @@ private:
     vizasynth::Oscilloscope oscilloscope;
     vizasynth::SpectrumAnalyzer spectrumAnalyzer;
     vizasynth::HarmonicView harmonicView;
+    vizasynth::DspLoadView dspLoadView;
     vizasynth::SingleCycleView singleCycleView;
     vizasynth::EnvelopeVisualizer envelopeVisualizer;
     VisualizationMode currentVizMode = VisualizationMode::Oscilloscope;
@@ -62,13 +67,19 @@ private:
     juce::TextButton scopeButton{"Scope"};
     juce::TextButton spectrumButton{"Spectrum"};
     juce::TextButton harmonicsButton{"Harmonics"};
+    juce::TextButton dspLoadButton{"DSP"};
 
     // Probe selector buttons
     juce::TextButton probeOscButton{"OSC"};
     juce::TextButton probeFilterButton{"FILT"};
     juce::TextButton probeOutputButton{"OUT"};
+    juce::TextButton probeChorusButton{"CHO"};
+    juce::TextButton probeDelayButton{"DLY"};
+    juce::TextButton probeReverbButton{"REV"};
     juce::TextButton freezeButton{"Freeze"};
     juce::TextButton clearTraceButton{"Clear"};
+    juce::TextButton traceButton{"Trace"};  // Standalone only
+    juce::TextButton recordButton{"Rec"};
 
     // Time window slider
     juce::Slider timeWindowSlider;
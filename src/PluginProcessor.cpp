@@ -1,9 +1,20 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 #include "Core/Configuration.h"
+#include "Core/RealtimeSanitizer.h"
+#include "Core/DspLoadMonitor.h"
+#include "Core/PluginState.h"
+#include "Core/TraceRecorder.h"
 
 using namespace vizasynth;
 
+namespace
+{
+    // Sample time for parameter changes made through scheduleParameterChange
+    // on this thread, -1 otherwise
+    thread_local juce::int64 scheduledParameterTime = -1;
+}
+
 //==============================================================================
 // VizASynthVoice Implementation
 //==============================================================================
@@ -72,45 +83,106 @@ void VizASynthVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int
     if (!isVoiceActive())
         return;
 
-    // Check if this is the active voice for probing
-    bool shouldProbe = (probeManager != nullptr) && (probeManager->getActiveVoice() == voiceIndex);
-    ProbePoint activeProbePoint = shouldProbe ? probeManager->getActiveProbe() : ProbePoint::Output;
+    VIZASYNTH_REALTIME_SCOPE("VizASynthVoice::renderNextBlock");
+    VIZASYNTH_DSP_STAGE(VoiceRender);
+    VIZASYNTH_TRACE_SCOPE("audio", "renderVoice");
+
+    // Check if this is the active voice for probing; with the lanes claimed
+    // every voice also copies its probed chunks into its own lane
+    bool shouldProbe = (probeManager != nullptr) && probeManager->isTapConsumed(ProbeRecorder::VoiceTap)
+                       && (probeManager->getActiveVoice() == voiceIndex);
+    const bool probeLane = (probeManager != nullptr) && probeManager->areLanesConsumed();
+    const bool collect = shouldProbe || probeLane;
+    ProbePoint activeProbePoint = collect ? probeManager->getActiveProbe() : ProbePoint::Output;
+
+    const int maxChunk = static_cast<int>(renderBuffer.size());
+    if (maxChunk == 0)
+        return;
 
-    // Process sample by sample to enable probing at different points
-    for (int sample = 0; sample < numSamples; ++sample)
+    while (numSamples > 0)
     {
-        // Generate oscillator sample
-        float oscOut = oscillator.processSample();
+        const int chunkSize = std::min(numSamples, maxChunk);
+        int rendered = 0;
+        int probed = 0;
+        bool finished = false;
+
+        // Process sample by sample into the voice's mono scratch block,
+        // collecting the probed signal to hand to the probe buffer in one copy
+        for (; rendered < chunkSize; ++rendered)
+        {
+            // Generate oscillator sample
+            float oscOut = oscillator.processSample();
+
+            // Probe oscillator output
+            if (collect && activeProbePoint == ProbePoint::Oscillator)
+                probeScratch[static_cast<size_t>(probed++)] = oscOut;
+
+            // Apply filter
+            float filtered = filter.processSample(0, oscOut);
+
+            // Probe post-filter
+            if (collect && activeProbePoint == ProbePoint::PostFilter)
+                probeScratch[static_cast<size_t>(probed++)] = filtered;
 
-        // Probe oscillator output
-        if (shouldProbe && activeProbePoint == ProbePoint::Oscillator)
-            probeManager->getProbeBuffer().push(oscOut);
+            // Apply envelope
+            float env = adsr.getNextSample();
 
-        // Apply filter
-        float filtered = filter.processSample(0, oscOut);
+            if (!adsr.isActive())
+            {
+                finished = true;
+                break;
+            }
+
+            float finalOut = filtered * env * velocity;
+            renderBuffer[static_cast<size_t>(rendered)] = finalOut;
+        }
+
+        // Probe the chunk (the final output probe reads the render block directly)
+        if (collect)
+        {
+            VIZASYNTH_DSP_STAGE(ProbeWrite);
+
+            const bool output = activeProbePoint == ProbePoint::Output;
+            const float* probedSamples = output ? renderBuffer.data() : probeScratch.data();
+            const int numProbed = output ? rendered : probed;
 
-        // Probe post-filter
-        if (shouldProbe && activeProbePoint == ProbePoint::PostFilter)
-            probeManager->getProbeBuffer().push(filtered);
+            if (shouldProbe && numProbed > 0)
+                probeManager->getProbeBuffer().push(probedSamples, numProbed);
 
-        // Apply envelope
-        float env = adsr.getNextSample();
+            if (probeLane)
+                probeManager->getVoiceLanes().write(voiceIndex, startSample, probedSamples, numProbed);
+        }
 
-        if (!adsr.isActive())
+        mixIntoBus(outputBuffer, startSample, rendered);
+
+        if (finished)
         {
             clearCurrentNote();
             return;
         }
 
-        float finalOut = filtered * env * velocity;
+        startSample += chunkSize;
+        numSamples -= chunkSize;
+    }
+}
 
-        // Probe final output
-        if (shouldProbe && activeProbePoint == ProbePoint::Output)
-            probeManager->getProbeBuffer().push(finalOut);
+void VizASynthVoice::mixIntoBus(juce::AudioBuffer<float>& bus, int startSample, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
 
-        // Write to output buffer (stereo)
-        for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel)
-            outputBuffer.addSample(channel, startSample + sample, finalOut);
+    // Mono bus: a single SIMD add. Stereo bus: one block-rate gain pair.
+    if (bus.getNumChannels() == 1)
+    {
+        juce::FloatVectorOperations::add(bus.getWritePointer(0, startSample),
+                                         renderBuffer.data(), numSamples);
+    }
+    else
+    {
+        juce::FloatVectorOperations::addWithMultiply(bus.getWritePointer(0, startSample),
+                                                     renderBuffer.data(), panGainLeft, numSamples);
+        juce::FloatVectorOperations::addWithMultiply(bus.getWritePointer(1, startSample),
+                                                     renderBuffer.data(), panGainRight, numSamples);
     }
 }
 
@@ -123,6 +195,9 @@ void VizASynthVoice::prepareToPlay(double sampleRate, int samplesPerBlock)
     spec.maximumBlockSize = samplesPerBlock;
     spec.numChannels = 1;
 
+    renderBuffer.assign(static_cast<size_t>(std::max(1, samplesPerBlock)), 0.0f);
+    probeScratch.assign(renderBuffer.size(), 0.0f);
+
     oscillator.prepare(sampleRate);
     filter.prepare(spec);
     filter.reset();
@@ -130,6 +205,17 @@ void VizASynthVoice::prepareToPlay(double sampleRate, int samplesPerBlock)
     adsr.setSampleRate(sampleRate);
 }
 
+void VizASynthVoice::resetState()
+{
+    clearCurrentNote();
+    oscillator.reset();
+    filter.reset();
+    adsr.reset();
+
+    if (probeManager != nullptr)
+        probeManager->clearVoiceFrequency(voiceIndex);
+}
+
 void VizASynthVoice::setOscillatorType(int type)
 {
     switch (type)
@@ -158,6 +244,14 @@ void VizASynthVoice::setFilterResonance(float resonance)
     filter.setResonance(resonance);
 }
 
+void VizASynthVoice::setPan(float pan)
+{
+    // Constant-power sine/cosine law, -3 dB at centre (see the header)
+    auto angle = (juce::jlimit(-1.0f, 1.0f, pan) + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+    panGainLeft = std::cos(angle);
+    panGainRight = std::sin(angle);
+}
+
 void VizASynthVoice::setADSR(float attack, float decay, float sustain, float release)
 {
     adsrParams.attack = attack;
@@ -202,20 +296,109 @@ VizASynthAudioProcessor::VizASynthAudioProcessor()
 #endif
 
     // Add voices to synthesizer
-    for (int i = 0; i < 8; ++i)
-    {
-        auto* voice = new VizASynthVoice();
-        voice->setVoiceIndex(i);
-        voice->setProbeManager(&probeManager);
-        synth.addVoice(voice);
-    }
+    setNumVoices(8);
 
     // Add sound
     synth.addSound(new VizASynthSound());
+
+    // Probe rings in shared memory for outside analysis tools, on request.
+    // Each instance gets its own segment; its name is logged for readers.
+    if (auto segment = juce::SystemStats::getEnvironmentVariable("VIZASYNTH_PROBE_SHM", {}); segment.isNotEmpty())
+    {
+        if (probeManager.enableSharedExport(segment))
+            juce::Logger::writeToLog("Probe export: " + probeManager.getSharedExport().getName());
+        else
+            juce::Logger::writeToLog("Probe export: cannot create a segment for " + segment);
+    }
+
+    masterVolumeParam = apvts.getRawParameterValue("masterVolume");
+    panParam = apvts.getRawParameterValue("pan");
+    spreadParam = apvts.getRawParameterValue("spread");
+
+    // Preset bank shipped next to the configuration, or a single Init program
+    if (!presetBank.load(configDir.getChildFile("presets.vzbank"), *this))
+        presetBank.loadDefaults(*this);
+
+    // Map parameters to the fields they drive and follow their changes
+    const std::pair<const char*, float SynthParameters::*> fields[] = {
+        {"oscType", &SynthParameters::oscType},
+        {"cutoff", &SynthParameters::cutoff},
+        {"resonance", &SynthParameters::resonance},
+        {"attack", &SynthParameters::attack},
+        {"decay", &SynthParameters::decay},
+        {"sustain", &SynthParameters::sustain},
+        {"release", &SynthParameters::release},
+        {"pan", &SynthParameters::pan},
+        {"spread", &SynthParameters::spread},
+        {"masterVolume", &SynthParameters::masterVolume},
+    };
+
+    // The effects bus reads its parameters through cached values, like pan and spread
+    const std::pair<const char*, float SynthParameters::*> effectFields[] = {
+        {"chorusEnabled", &SynthParameters::chorusEnabled},
+        {"chorusRate", &SynthParameters::chorusRate},
+        {"chorusDepth", &SynthParameters::chorusDepth},
+        {"chorusMix", &SynthParameters::chorusMix},
+        {"delayEnabled", &SynthParameters::delayEnabled},
+        {"delayTime", &SynthParameters::delayTime},
+        {"delayFeedback", &SynthParameters::delayFeedback},
+        {"delayMix", &SynthParameters::delayMix},
+        {"reverbEnabled", &SynthParameters::reverbEnabled},
+        {"reverbSize", &SynthParameters::reverbSize},
+        {"reverbDamping", &SynthParameters::reverbDamping},
+        {"reverbMix", &SynthParameters::reverbMix},
+    };
+
+    parameterFields.assign(static_cast<size_t>(getParameters().size()), nullptr);
+    auto mapField = [this](const char* paramId, float SynthParameters::* field)
+    {
+        if (const int index = PresetBank::findParameterIndex(*this, paramId); index >= 0)
+            parameterFields[static_cast<size_t>(index)] = field;
+    };
+
+    for (const auto& [paramId, field] : fields)
+        mapField(paramId, field);
+
+    for (const auto& [paramId, field] : effectFields)
+    {
+        mapField(paramId, field);
+        effectParameters.emplace_back(apvts.getRawParameterValue(paramId), field);
+    }
+
+    lastParameterValues = std::make_unique<std::atomic<float>[]>(parameterFields.size());
+    syncLastParameterValues();
+
+    for (auto* parameter : getParameters())
+        parameter->addListener(this);
+
+    rebuildProgramSnapshots();
 }
 
 VizASynthAudioProcessor::~VizASynthAudioProcessor()
 {
+    for (auto* parameter : getParameters())
+        parameter->removeListener(this);
+}
+
+//==============================================================================
+void VizASynthAudioProcessor::setNumVoices(int numVoices)
+{
+    synth.clearVoices();
+
+    for (int i = 0; i < juce::jmax(1, numVoices); ++i)
+    {
+        auto* voice = new VizASynthVoice();
+        voice->setVoiceIndex(i);
+        voice->setProbeManager(&probeManager);
+
+        // Voices added after prepareToPlay need their DSP prepared too
+        if (getSampleRate() > 0.0)
+            voice->prepareToPlay(getSampleRate(), getBlockSize());
+
+        synth.addVoice(voice);
+    }
+
+    probeManager.setNumVoices(synth.getNumVoices());
 }
 
 //==============================================================================
@@ -259,37 +442,402 @@ juce::AudioProcessorValueTreeState::ParameterLayout VizASynthAudioProcessor::cre
         juce::NormalisableRange<float>(0.001f, 5.0f, 0.001f, 0.5f), 0.3f,
         juce::AudioParameterFloatAttributes().withLabel("s")));
 
+    // Stereo placement
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "pan", "Pan",
+        juce::NormalisableRange<float>(-1.0f, 1.0f, 0.01f), 0.0f));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "spread", "Stereo Spread",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.0f));
+
     // Master volume (in dB)
     layout.add(std::make_unique<juce::AudioParameterFloat>(
         "masterVolume", "Master Volume",
         juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f), 0.0f,
         juce::AudioParameterFloatAttributes().withLabel("dB")));
 
+    // Effects bus (all off by default)
+    layout.add(std::make_unique<juce::AudioParameterBool>("chorusEnabled", "Chorus", false));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "chorusRate", "Chorus Rate",
+        juce::NormalisableRange<float>(0.05f, 5.0f, 0.01f, 0.5f), 0.8f,
+        juce::AudioParameterFloatAttributes().withLabel("Hz")));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "chorusDepth", "Chorus Depth",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.5f));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "chorusMix", "Chorus Mix",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.5f));
+
+    layout.add(std::make_unique<juce::AudioParameterBool>("delayEnabled", "Delay", false));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "delayTime", "Delay Time",
+        juce::NormalisableRange<float>(10.0f, 2000.0f, 1.0f, 0.5f), 375.0f,
+        juce::AudioParameterFloatAttributes().withLabel("ms")));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "delayFeedback", "Delay Feedback",
+        juce::NormalisableRange<float>(0.0f, 0.95f, 0.01f), 0.4f));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "delayMix", "Delay Mix",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.3f));
+
+    layout.add(std::make_unique<juce::AudioParameterBool>("reverbEnabled", "Reverb", false));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "reverbSize", "Reverb Size",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.6f));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "reverbDamping", "Reverb Damping",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.5f));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "reverbMix", "Reverb Mix",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.25f));
+
     return layout;
 }
 
 void VizASynthAudioProcessor::updateVoiceParameters()
 {
-    auto oscType = apvts.getRawParameterValue("oscType")->load();
-    auto cutoff = apvts.getRawParameterValue("cutoff")->load();
-    auto resonance = apvts.getRawParameterValue("resonance")->load();
-    auto attack = apvts.getRawParameterValue("attack")->load();
-    auto decay = apvts.getRawParameterValue("decay")->load();
-    auto sustain = apvts.getRawParameterValue("sustain")->load();
-    auto release = apvts.getRawParameterValue("release")->load();
+    // blockParameters carries over from block to block and is never reread
+    // from the parameter atomics: a parameter's atomic changes before its
+    // scheduled event is queued, so a block starting in between would play
+    // the new value early. Scheduled events, host automation (which arrives
+    // on this thread) and program switches update it instead.
+
+    // A change dropped by a full queue is only in the parameters
+    if (const auto dropped = eventQueue.getDroppedEventCount(); dropped != droppedEventsSeen)
+    {
+        droppedEventsSeen = dropped;
+        blockParameters = readParameters();
+    }
 
-    for (int i = 0; i < synth.getNumVoices(); ++i)
+    // Until the timer has copied a switched program into the parameters,
+    // the voices follow the program snapshot
+    if (const int unsynced = unsyncedProgram.load(); unsynced >= 0)
+        blockParameters = programSnapshots[static_cast<size_t>(unsynced)];
+
+    applyVoiceParameters(blockParameters);
+}
+
+VizASynthAudioProcessor::SynthParameters VizASynthAudioProcessor::readParameters() const
+{
+    SynthParameters parameters;
+    parameters.oscType = apvts.getRawParameterValue("oscType")->load();
+    parameters.cutoff = apvts.getRawParameterValue("cutoff")->load();
+    parameters.resonance = apvts.getRawParameterValue("resonance")->load();
+    parameters.attack = apvts.getRawParameterValue("attack")->load();
+    parameters.decay = apvts.getRawParameterValue("decay")->load();
+    parameters.sustain = apvts.getRawParameterValue("sustain")->load();
+    parameters.release = apvts.getRawParameterValue("release")->load();
+    parameters.pan = panParam->load();
+    parameters.spread = spreadParam->load();
+    parameters.masterVolume = masterVolumeParam->load();
+
+    for (const auto& [value, field] : effectParameters)
+        parameters.*field = value->load();
+
+    return parameters;
+}
+
+void VizASynthAudioProcessor::applyVoiceParameters(const SynthParameters& parameters)
+{
+    const int numVoices = synth.getNumVoices();
+
+    for (int i = 0; i < numVoices; ++i)
     {
         if (auto voice = dynamic_cast<VizASynthVoice*>(synth.getVoice(i)))
         {
-            voice->setOscillatorType(static_cast<int>(oscType));
-            voice->setFilterCutoff(cutoff);
-            voice->setFilterResonance(resonance);
-            voice->setADSR(attack, decay, sustain, release);
+            voice->setOscillatorType(static_cast<int>(parameters.oscType));
+            voice->setFilterCutoff(parameters.cutoff);
+            voice->setFilterResonance(parameters.resonance);
+            voice->setADSR(parameters.attack, parameters.decay, parameters.sustain, parameters.release);
+
+            // Spread voices evenly from left to right around the pan position
+            float offset = numVoices > 1 ? 2.0f * static_cast<float>(i) / static_cast<float>(numVoices - 1) - 1.0f
+                                         : 0.0f;
+            voice->setPan(parameters.pan + parameters.spread * offset);
+        }
+    }
+}
+
+void VizASynthAudioProcessor::applyEffectParameters(const SynthParameters& parameters)
+{
+    auto& chorus = effectsBus.getChorus();
+    chorus.setEnabled(parameters.chorusEnabled >= 0.5f);
+    chorus.setRate(parameters.chorusRate);
+    chorus.setDepth(parameters.chorusDepth);
+    chorus.setMix(parameters.chorusMix);
+
+    auto& delay = effectsBus.getDelay();
+    delay.setEnabled(parameters.delayEnabled >= 0.5f);
+    delay.setDelayMs(parameters.delayTime);
+    delay.setFeedback(parameters.delayFeedback);
+    delay.setMix(parameters.delayMix);
+
+    auto& reverb = effectsBus.getReverb();
+    reverb.setEnabled(parameters.reverbEnabled >= 0.5f);
+    reverb.setRoomSize(parameters.reverbSize);
+    reverb.setDamping(parameters.reverbDamping);
+    reverb.setMix(parameters.reverbMix);
+}
+
+void VizASynthAudioProcessor::beginEffectSegment(int startSample)
+{
+    // Changes on the same sample share a segment. Should the segments ever
+    // run out, the rest of the block's changes land at the last one rather
+    // than allocating on the audio thread.
+    if (!effectSegments.empty()
+        && (effectSegments.back().startSample == startSample || effectSegments.size() == effectSegments.capacity()))
+    {
+        effectSegments.back().parameters = blockParameters;
+        return;
+    }
+
+    effectSegments.push_back({startSample, blockParameters});
+}
+
+//==============================================================================
+// Programs
+//==============================================================================
+
+bool VizASynthAudioProcessor::loadPresetBank(const juce::File& bankFile)
+{
+    if (!presetBank.load(bankFile, *this))
+        return false;
+
+    rebuildProgramSnapshots();
+    return true;
+}
+
+void VizASynthAudioProcessor::rebuildProgramSnapshots()
+{
+    programSnapshots.clear();
+    programSnapshots.reserve(static_cast<size_t>(presetBank.getNumPrograms()));
+
+    for (int i = 0; i < presetBank.getNumPrograms(); ++i)
+        programSnapshots.push_back(decodeProgram(presetBank.getProgram(i).values));
+
+    requestedProgram.store(-1);
+    unsyncedProgram.store(-1);
+    currentProgram.store(0);
+    numPrograms.store(presetBank.getNumPrograms());
+
+    // The timer only has work once there is something to switch to
+    if (presetBank.getNumPrograms() > 1)
+        startTimerHz(20);
+    else
+        stopTimer();
+}
+
+VizASynthAudioProcessor::SynthParameters VizASynthAudioProcessor::decodeProgram(const std::vector<float>& values) const
+{
+    SynthParameters parameters;
+    for (size_t i = 0; i < parameterFields.size() && i < values.size(); ++i)
+        if (auto field = parameterFields[i])
+            parameters.*field = values[i];
+
+    return parameters;
+}
+
+//==============================================================================
+// Sample-accurate rendering
+//==============================================================================
+
+void VizASynthAudioProcessor::renderVoices(juce::AudioBuffer<float>& bus, const juce::MidiBuffer& midi, int numSamples)
+{
+    int position = 0;
+    int nextEvent = 0;
+
+    effectSegments.clear();
+    beginEffectSegment(0);
+
+    while (position < numSamples)
+    {
+        // Apply the parameter events landing here. Events closer than
+        // MinSubBlockSamples to the split are applied with it, so a burst of
+        // knob movement can't break the block into tiny renders.
+        int segmentEnd = numSamples;
+        bool changed = false;
+
+        for (; nextEvent < eventQueue.getNumDue(); ++nextEvent)
+        {
+            const auto& event = eventQueue.getPending(nextEvent);
+            if (event.type != TimedEvent::Type::Parameter)
+                continue;
+
+            if (const int offset = eventQueue.getBlockOffset(event); offset >= position + MinSubBlockSamples)
+            {
+                segmentEnd = offset;
+                break;
+            }
+
+            changed = applyParameterEvent(event) || changed;
+        }
+
+        if (changed)
+        {
+            applyVoiceParameters(blockParameters);
+            beginEffectSegment(position);
+        }
+
+        renderSegment(bus, midi, position, segmentEnd - position);
+        position = segmentEnd;
+    }
+}
+
+bool VizASynthAudioProcessor::applyParameterEvent(const TimedEvent& event)
+{
+    // A switched program owns the voices until the timer has synced it
+    auto field = parameterFields[static_cast<size_t>(event.parameterIndex)];
+    if (field == nullptr || unsyncedProgram.load() >= 0 || blockParameters.*field == event.value)
+        return false;
+
+    blockParameters.*field = event.value;
+    return true;
+}
+
+void VizASynthAudioProcessor::renderSegment(juce::AudioBuffer<float>& bus, const juce::MidiBuffer& midi,
+                                            int startSample, int numSamples)
+{
+    // Steady state: a single pass, untouched by the program fade
+    if (!programFade.isActive())
+    {
+        synth.renderNextBlock(bus, midi, startSample, numSamples);
+        return;
+    }
+
+    const int endSample = startSample + numSamples;
+    int position = startSample;
+
+    while (position < endSample)
+    {
+        // Swap the program in at the silent sample, then fade back up
+        if (programFade.isSilent() && pendingProgram >= 0)
+        {
+            blockParameters = programSnapshots[static_cast<size_t>(pendingProgram)];
+            applyVoiceParameters(blockParameters);
+            beginEffectSegment(position);
+
+            currentProgram.store(pendingProgram);
+
+            if (isNonRealtime())
+                syncProgramParameters(pendingProgram);
+            else
+                unsyncedProgram.store(pendingProgram);
+
+            pendingProgram = -1;
+            programFade.startFadeIn();
         }
+
+        // While fading out, split the block where the fade reaches silence
+        int segment = endSample - position;
+        if (programFade.getSamplesUntilSilent() > 0)
+            segment = juce::jmin(segment, programFade.getSamplesUntilSilent());
+
+        synth.renderNextBlock(bus, midi, position, segment);
+        programFade.process(bus, position, segment);
+        position += segment;
     }
 }
 
+void VizASynthAudioProcessor::timerCallback()
+{
+    // Copy a program the audio thread has switched to into the parameters,
+    // so the editor and host show it, then hand control back to them
+    const int program = unsyncedProgram.load();
+    if (program < 0)
+        return;
+
+    syncProgramParameters(program);
+
+    // A switch that landed meanwhile is picked up on the next tick
+    int expected = program;
+    unsyncedProgram.compare_exchange_strong(expected, -1);
+}
+
+void VizASynthAudioProcessor::syncProgramParameters(int program)
+{
+    const auto& values = presetBank.getProgram(program).values;
+    const auto& parameters = getParameters();
+
+    // The audio thread is already playing these values; don't schedule them
+    // (on the audio thread itself parameter changes are never scheduled)
+    syncingProgram.store(true);
+
+    for (int i = 0; i < parameters.size(); ++i)
+    {
+        if (auto* parameter = dynamic_cast<juce::RangedAudioParameter*>(parameters[i]))
+        {
+            const float normalised = parameter->convertTo0to1(values[static_cast<size_t>(i)]);
+            if (parameter->getValue() != normalised)
+                parameter->setValueNotifyingHost(normalised);
+        }
+    }
+
+    syncingProgram.store(false);
+}
+
+void VizASynthAudioProcessor::restoreProgramIndex(const juce::ValueTree& state)
+{
+    // The restored parameters already hold the program's values (and any
+    // edits made to it), so only the index is taken over; nothing switches
+    const int program = state.getProperty(CurrentProgramProperty, 0);
+    if (program < 0 || program >= numPrograms.load())
+        return;
+
+    requestedProgram.store(-1);
+    unsyncedProgram.store(-1);
+    cancelPendingProgram.store(true);
+    currentProgram.store(program);
+}
+
+void VizASynthAudioProcessor::restoreProperties(const juce::ValueTree& properties)
+{
+    // apvts.state belongs to the message thread; hosts may restore from any
+    // thread, so the properties wait there until the message thread runs
+    if (juce::MessageManager::existsAndIsCurrentThread())
+    {
+        {
+            const juce::ScopedLock lock(restoredPropertiesLock);
+            restoredProperties = {};
+        }
+
+        cancelPendingUpdate();
+        if (properties.isValid())
+            PluginState::applyProperties(apvts.state, properties);
+        return;
+    }
+
+    {
+        const juce::ScopedLock lock(restoredPropertiesLock);
+        restoredProperties = properties;
+    }
+
+    if (properties.isValid())
+        triggerAsyncUpdate();
+}
+
+void VizASynthAudioProcessor::handleAsyncUpdate()
+{
+    juce::ValueTree properties;
+    {
+        const juce::ScopedLock lock(restoredPropertiesLock);
+        std::swap(properties, restoredProperties);
+    }
+
+    if (properties.isValid())
+        PluginState::applyProperties(apvts.state, properties);
+}
+
 //==============================================================================
 const juce::String VizASynthAudioProcessor::getName() const
 {
@@ -318,32 +866,67 @@ double VizASynthAudioProcessor::getTailLengthSeconds() const
 
 int VizASynthAudioProcessor::getNumPrograms()
 {
-    return 1;
+    return numPrograms.load();
 }
 
 int VizASynthAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram.load();
 }
 
-void VizASynthAudioProcessor::setCurrentProgram(int)
+void VizASynthAudioProcessor::setCurrentProgram(int index)
 {
+    // O(1) and real-time safe from any thread: the next processed block
+    // fades out, swaps in the pre-decoded snapshot and fades back in
+    if (index >= 0 && index < numPrograms.load())
+        requestedProgram.store(index);
 }
 
-const juce::String VizASynthAudioProcessor::getProgramName(int)
+const juce::String VizASynthAudioProcessor::getProgramName(int index)
 {
+    if (index >= 0 && index < presetBank.getNumPrograms())
+        return presetBank.getProgram(index).name;
+
     return {};
 }
 
-void VizASynthAudioProcessor::changeProgramName(int, const juce::String&)
+void VizASynthAudioProcessor::changeProgramName(int index, const juce::String& newName)
 {
+    presetBank.setProgramName(index, newName);
 }
 
 //==============================================================================
 void VizASynthAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     synth.setCurrentPlaybackSampleRate(sampleRate);
-    probeManager.setSampleRate(sampleRate);
+    probeManager.prepare(sampleRate);
+    probeManager.getDspLoadMonitor().prepare(sampleRate);
+
+    // Snap the master gain to the current parameter value so playback
+    // doesn't start with a ramp from unity
+    outputStage.setTargetGainDecibels(masterVolumeParam->load());
+    outputStage.prepare(sampleRate);
+    programFade.prepare(sampleRate);
+
+    // Effects start in their current state, without fading in
+    blockParameters = readParameters();
+    applyEffectParameters(blockParameters);
+    effectsBus.prepare(sampleRate, samplesPerBlock);
+
+    // Anything scheduled against the old stream is dropped; the parameters
+    // read above already hold its values
+    eventQueue.prepare(sampleRate);
+    droppedEventsSeen = eventQueue.getDroppedEventCount();
+    syncLastParameterValues();
+
+    // Voices accumulate here; expansion to the host layout happens once per
+    // block. Sized with headroom, since hosts don't always keep to the block
+    // size they announce; longer blocks are rendered in chunks of this size.
+    voiceBus.setSize(2, juce::jmax(2 * samplesPerBlock, MinVoiceBusSamples));
+    chunkMidi.ensureSize(ChunkMidiBytes);
+
+    // One effect segment per render split of the longest block, plus a program swap
+    effectSegments.reserve(static_cast<size_t>(voiceBus.getNumSamples() / MinSubBlockSamples + 2));
 
     for (int i = 0; i < synth.getNumVoices(); ++i)
     {
@@ -356,6 +939,22 @@ void VizASynthAudioProcessor::releaseResources()
 {
 }
 
+void VizASynthAudioProcessor::reset()
+{
+    // Hard stop: no release tails, so an offline render or a host transport
+    // jump starts from silence
+    for (int i = 0; i < synth.getNumVoices(); ++i)
+    {
+        if (auto voice = dynamic_cast<VizASynthVoice*>(synth.getVoice(i)))
+            voice->resetState();
+    }
+
+    for (auto& velocity : noteVelocities)
+        velocity.store(0.0f);
+
+    effectsBus.reset();
+}
+
 bool VizASynthAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
     if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
@@ -379,68 +978,246 @@ std::vector<VizASynthAudioProcessor::NoteInfo> VizASynthAudioProcessor::getActiv
 
 void VizASynthAudioProcessor::addMidiMessage(const juce::MidiMessage& msg)
 {
-    juce::ScopedLock lock(midiLock);
-    injectedMidi.addEvent(msg, 0);
+    // Short messages only; the keyboard sends note on/off
+    if (msg.getRawDataSize() <= 3)
+        eventQueue.push(TimedEvent::midiEvent(getEventScheduleTime(), msg));
+}
+
+void VizASynthAudioProcessor::scheduleParameterChange(const juce::String& paramId, float value, juce::int64 sampleTime)
+{
+    auto* parameter = apvts.getParameter(paramId);
+    if (parameter == nullptr)
+        return;
+
+    scheduledParameterTime = sampleTime;
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    scheduledParameterTime = -1;
+}
+
+//==============================================================================
+// Event scheduling
+//==============================================================================
+
+juce::int64 VizASynthAudioProcessor::getEventScheduleTime() const
+{
+    // Offline renders don't run against the wall clock: apply at the next block
+    return isNonRealtime() ? eventQueue.getNextBlockStart() : eventQueue.getScheduleTime();
+}
+
+void VizASynthAudioProcessor::syncLastParameterValues()
+{
+    const auto& parameters = getParameters();
+    for (int i = 0; i < parameters.size(); ++i)
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameters[i]))
+            lastParameterValues[static_cast<size_t>(i)].store(ranged->convertFrom0to1(ranged->getValue()));
+}
+
+void VizASynthAudioProcessor::parameterValueChanged(int parameterIndex, float newValue)
+{
+    if (parameterIndex < 0 || parameterIndex >= static_cast<int>(parameterFields.size()))
+        return;
+
+    auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(getParameters()[parameterIndex]);
+    if (ranged == nullptr)
+        return;
+
+    const float value = ranged->convertFrom0to1(newValue);
+    const float previous = lastParameterValues[static_cast<size_t>(parameterIndex)].exchange(value);
+
+    const auto field = parameterFields[static_cast<size_t>(parameterIndex)];
+    if (field == nullptr)
+        return;
+
+    if (scheduledParameterTime >= 0)
+    {
+        eventQueue.push(TimedEvent::parameterEvent(scheduledParameterTime, parameterIndex, previous, value));
+        return;
+    }
+
+    // Host automation arrives on the audio thread between blocks and applies
+    // from the next block start
+    if (std::this_thread::get_id() == audioThreadId.load(std::memory_order_relaxed))
+    {
+        blockParameters.*field = value;
+        return;
+    }
+
+    // Program syncs copy values the audio thread is already playing;
+    // everything else is scheduled
+    if (syncingProgram.load() && juce::MessageManager::existsAndIsCurrentThread())
+        return;
+
+    eventQueue.push(TimedEvent::parameterEvent(getEventScheduleTime(), parameterIndex, previous, value));
 }
 
 void VizASynthAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    // A block longer than the voice bus is processed as consecutive shorter
+    // blocks rather than growing the bus on the audio thread
+    if (buffer.getNumSamples() > voiceBus.getNumSamples())
+    {
+        const int chunkSize = voiceBus.getNumSamples();
+
+        for (int start = 0; start < buffer.getNumSamples(); start += chunkSize)
+        {
+            const int count = juce::jmin(chunkSize, buffer.getNumSamples() - start);
+            juce::AudioBuffer<float> chunk(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, count);
+
+            chunkMidi.clear();
+            chunkMidi.addEvents(midiMessages, start, count, -start);
+            processBlock(chunk, chunkMidi);
+        }
+        return;
+    }
+
     juce::ScopedNoDenormals noDenormals;
+    VIZASYNTH_REALTIME_SCOPE("VizASynthAudioProcessor::processBlock");
+    VIZASYNTH_DSP_BLOCK(probeManager.getDspLoadMonitor(), buffer.getNumSamples());
+    VIZASYNTH_TRACE_SCOPE("audio", "processBlock");
 
-    // Merge injected MIDI messages
+    const int numSamples = buffer.getNumSamples();
+    audioThreadId.store(std::this_thread::get_id(), std::memory_order_relaxed);
+
+    // Collect the events due in this block; injected MIDI joins the host's at
+    // its offset and the Synthesiser splits its render there
     {
-        juce::ScopedLock lock(midiLock);
-        midiMessages.addEvents(injectedMidi, 0, buffer.getNumSamples(), 0);
-        injectedMidi.clear();
+        VIZASYNTH_DSP_STAGE(MidiMerge);
+        eventQueue.beginBlock(sampleClock, numSamples);
+        probeManager.setSampleClock(static_cast<uint64_t>(sampleClock));
+        probeManager.beginBlock();  // Nobody watching: the voices and mix skip probing
+        sampleClock += numSamples;
+
+        for (int i = 0; i < eventQueue.getNumDue(); ++i)
+        {
+            const auto& event = eventQueue.getPending(i);
+            if (event.type == TimedEvent::Type::Midi && event.midiSize > 0)
+                midiMessages.addEvent(event.midi, event.midiSize, eventQueue.getBlockOffset(event));
+        }
     }
 
     // Track note on/off for keyboard display
-    for (const auto metadata : midiMessages)
     {
-        auto msg = metadata.getMessage();
-        if (msg.isNoteOn())
-            noteVelocities[msg.getNoteNumber()].store(msg.getFloatVelocity());
-        else if (msg.isNoteOff())
-            noteVelocities[msg.getNoteNumber()].store(0.0f);
+        VIZASYNTH_DSP_STAGE(MidiMerge);
+        for (const auto metadata : midiMessages)
+        {
+            auto msg = metadata.getMessage();
+            if (msg.isNoteOn())
+                noteVelocities[msg.getNoteNumber()].store(msg.getFloatVelocity());
+            else if (msg.isNoteOff())
+                noteVelocities[msg.getNoteNumber()].store(0.0f);
+        }
     }
 
-    // Clear output buffer
-    buffer.clear();
-
     // Update voice parameters
-    updateVoiceParameters();
+    {
+        VIZASYNTH_DSP_STAGE(ParameterUpdate);
 
-    // Render synth
-    synth.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
+        // A restored state cancels a switch still fading out, and fades back in
+        if (cancelPendingProgram.exchange(false) && pendingProgram >= 0)
+        {
+            pendingProgram = -1;
+            programFade.startFadeIn();
+        }
 
-    // Apply master volume
-    float masterVolumeDb = apvts.getRawParameterValue("masterVolume")->load();
-    float masterGain = juce::Decibels::decibelsToGain(masterVolumeDb);
-    buffer.applyGain(masterGain);
+        // A program change fades out first; the switch happens at its silent point
+        if (const int requested = requestedProgram.exchange(-1); requested >= 0)
+            pendingProgram = requested;
 
-    // Calculate output level (RMS) and check for clipping
-    float peakLevel = 0.0f;
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
-    {
-        float channelPeak = buffer.getMagnitude(channel, 0, buffer.getNumSamples());
-        peakLevel = std::max(peakLevel, channelPeak);
+        if (pendingProgram >= 0 && !programFade.isFadingOut())
+            programFade.startFadeOut();
+
+        updateVoiceParameters();
     }
-    outputLevel.store(peakLevel);
-    if (peakLevel >= 1.0f)
-        clipping.store(true);
 
-    // Probe mixed output for mix mode visualization
-    // This captures the sum of all voices at the Output probe point
-    ProbePoint activeProbe = probeManager.getActiveProbe();
-    if (activeProbe == ProbePoint::Output)
+    // Voices write a single mono channel unless stereo placement is in use
+    // (decided at the block start; a pan change inside the block that needs
+    // the stereo bus takes effect from the next one). A program switching in
+    // during this block is placed on the bus it needs from its first sample.
+    const auto needsStereo = [](const SynthParameters& parameters) {
+        return parameters.pan != 0.0f || parameters.spread != 0.0f;
+    };
+    const bool stereoPlacement = buffer.getNumChannels() > 1
+                                 && (needsStereo(blockParameters)
+                                     || (pendingProgram >= 0 && needsStereo(programSnapshots[static_cast<size_t>(pendingProgram)])));
+
+    juce::AudioBuffer<float> bus(voiceBus.getArrayOfWritePointers(), stereoPlacement ? 2 : 1, numSamples);
+    bus.clear();
+
+    // Render synth, split at the scheduled parameter changes
+    renderVoices(bus, midiMessages, numSamples);
+    eventQueue.endBlock();
+
+    // A mono bus feeding a stereo host is a bus of centred voices: give it the
+    // pan law's centre gain so switching to stereo placement keeps the level
+    if (!stereoPlacement && buffer.getNumChannels() > 1)
+        juce::FloatVectorOperations::multiply(bus.getWritePointer(0), VizASynthVoice::PanCentreGain, numSamples);
+    probeManager.endBlock(numSamples);
+
+    // The mix probe captures the sum of all voices while anything (a panel at
+    // the Output probe point, the recorder, the export) reads it, or the
+    // effects bus when one of its probe points is active (the recorder then
+    // takes the output separately, below)
+    const ProbePoint activeProbe = probeManager.getActiveProbe();
+    ProbeBuffer* mixProbe = probeManager.isTapConsumed(ProbeRecorder::MixTap) ? &probeManager.getMixProbeBuffer()
+                                                                              : nullptr;
+
+    // Effects, with each render split's parameters from the sample it
+    // starts at. With all of them off for the whole block (and not probed)
+    // the bus is skipped and the voice bus goes straight to the output stage.
+    applyEffectParameters(effectSegments.front().parameters);
+
+    if (effectsBus.isActive() || effectSegments.size() > 1 || (mixProbe != nullptr && isEffectProbePoint(activeProbe)))
     {
-        const int numSamples = buffer.getNumSamples();
-        const float* channelData = buffer.getReadPointer(0);  // Left channel
-        for (int i = 0; i < numSamples; ++i)
+        VIZASYNTH_DSP_STAGE(Effects);
+
+        // The effects are stereo; a mono voice bus is widened in place
+        if (bus.getNumChannels() == 1)
+        {
+            juce::FloatVectorOperations::copy(voiceBus.getWritePointer(1), voiceBus.getReadPointer(0), numSamples);
+            bus.setDataToReferTo(voiceBus.getArrayOfWritePointers(), 2, numSamples);
+        }
+
+        for (size_t i = 0; i < effectSegments.size(); ++i)
+        {
+            const int start = effectSegments[i].startSample;
+            const int end = i + 1 < effectSegments.size() ? effectSegments[i + 1].startSample : numSamples;
+
+            applyEffectParameters(effectSegments[i].parameters);
+            effectsBus.process(bus.getWritePointer(0) + start, bus.getWritePointer(1) + start, end - start,
+                               isEffectProbePoint(activeProbe) ? mixProbe : nullptr, activeProbe);
+        }
+
+        // A mono host hears both sides
+        if (buffer.getNumChannels() == 1)
         {
-            probeManager.getMixProbeBuffer().push(channelData[i]);
+            juce::FloatVectorOperations::add(bus.getWritePointer(0), bus.getReadPointer(1), numSamples);
+            juce::FloatVectorOperations::multiply(bus.getWritePointer(0), 0.5f, numSamples);
         }
     }
+
+    // With an effect in the mix probe, the recorder's mix tap still gets the
+    // output, so its files always hold what the host heard
+    const bool recordOutputOnly = mixProbe != nullptr && isEffectProbePoint(activeProbe);
+    if (isEffectProbePoint(activeProbe))
+        mixProbe = nullptr;
+
+    // Expand to the host layout, apply master volume, meter and probe the mix
+    // in one pass
+    VIZASYNTH_DSP_STAGE(OutputStage);
+    outputStage.setTargetGainDecibels(blockParameters.masterVolume);  // As of the block end
+
+    auto metering = outputStage.process(bus, buffer, numSamples, mixProbe);
+
+    if (recordOutputOnly)
+    {
+        VIZASYNTH_DSP_STAGE(ProbeWrite);
+        probeManager.getMixProbeBuffer().record(buffer.getReadPointer(0), numSamples);
+    }
+
+    outputLevel.store(metering.maxPeak);
+    outputRmsLevel.store(metering.maxRms);
+    if (metering.clipped)
+        clipping.store(true);
 }
 
 //==============================================================================
@@ -457,18 +1234,49 @@ juce::AudioProcessorEditor* VizASynthAudioProcessor::createEditor()
 //==============================================================================
 void VizASynthAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
+    // Work on a copy: this may run on any host thread, and the live tree
+    // belongs to the message thread. Properties restored but not yet applied
+    // there are what the host last gave us, so they are what gets saved.
     auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    {
+        const juce::ScopedLock lock(restoredPropertiesLock);
+        if (restoredProperties.isValid())
+            PluginState::applyProperties(state, restoredProperties);
+    }
+
+    state.setProperty(CurrentProgramProperty, getCurrentProgram(), nullptr);
+    PluginState::write(*this, state, destData);
 }
 
 void VizASynthAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    // Binary fast path: parameter values are written straight to their
+    // atomics, which the audio thread picks up on its next block
+    if (PluginState::isBinaryState(data, sizeInBytes))
+    {
+        std::vector<PluginState::Value> values;
+        juce::ValueTree properties;
+        if (PluginState::read(data, sizeInBytes, values, properties))
+        {
+            PluginState::apply(*this, values);
+            restoreProperties(properties);
+            restoreProgramIndex(properties);
+        }
+        return;
+    }
+
+    // XML states saved by earlier versions
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 
     if (xmlState.get() != nullptr)
         if (xmlState->hasTagName(apvts.state.getType()))
-            apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+        {
+            // replaceState takes the APVTS lock; drop any binary restore still queued
+            const auto state = juce::ValueTree::fromXml(*xmlState);
+            restoreProperties({});
+            apvts.replaceState(state);
+            restoreProgramIndex(state);
+        }
 }
 
 //==============================================================================
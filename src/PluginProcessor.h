@@ -4,6 +4,12 @@
 #include <juce_dsp/juce_dsp.h>
 #include "Visualization/ProbeBuffer.h"
 #include "DSP/PolyBLEPOscillator.h"
+#include "DSP/OutputStage.h"
+#include "DSP/Effects/EffectsBus.h"
+#include "DSP/ProgramFade.h"
+#include "Core/PresetBank.h"
+#include "Core/EventQueue.h"
+#include <thread>
 
 //==============================================================================
 /**
@@ -23,12 +29,22 @@ public:
 
     void prepareToPlay(double sampleRate, int samplesPerBlock);
 
+    // Return oscillator, filter and envelope to their initial state
+    void resetState();
+
     // Parameter setters
     void setOscillatorType(int type);
     void setFilterCutoff(float cutoff);
     void setFilterResonance(float resonance);
     void setADSR(float attack, float decay, float sustain, float release);
 
+    // Stereo placement (-1 = hard left, 1 = hard right), applied as a block-rate gain pair.
+    // Sine/cosine constant-power law: unity on the near side at hard pan and
+    // PanCentreGain (-3 dB) on both sides at centre, so the total power, and
+    // with it the mix level, doesn't depend on pan or spread.
+    static constexpr float PanCentreGain = 0.70710678f;
+    void setPan(float pan);
+
     // Probe system
     void setProbeManager(vizasynth::ProbeManager* manager) { probeManager = manager; }
     void setVoiceIndex(int index) { voiceIndex = index; }
@@ -37,6 +53,9 @@ public:
     vizasynth::PolyBLEPOscillator& getOscillator() { return oscillator; }
 
 private:
+    // Add the rendered mono block to a mono or stereo voice bus
+    void mixIntoBus(juce::AudioBuffer<float>& bus, int startSample, int numSamples);
+
     vizasynth::PolyBLEPOscillator oscillator;
     juce::dsp::StateVariableTPTFilter<float> filter;
     juce::ADSR adsr;
@@ -46,6 +65,12 @@ private:
     int currentMidiNote = 0;
     float velocity = 0.0f;
 
+    // Mono render scratch, probe tap scratch and stereo placement gains
+    std::vector<float> renderBuffer;
+    std::vector<float> probeScratch;
+    float panGainLeft = PanCentreGain;
+    float panGainRight = PanCentreGain;
+
     // Probe system
     vizasynth::ProbeManager* probeManager = nullptr;
     int voiceIndex = 0;
@@ -68,7 +93,10 @@ public:
 /**
  * Main audio processor for Viz-A-Synth
  */
-class VizASynthAudioProcessor : public juce::AudioProcessor
+class VizASynthAudioProcessor : public juce::AudioProcessor,
+                                private juce::Timer,
+                                private juce::AsyncUpdater,
+                                private juce::AudioProcessorParameter::Listener
 {
 public:
     VizASynthAudioProcessor();
@@ -77,6 +105,7 @@ public:
     //==============================================================================
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
+    void reset() override;
 
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 
@@ -101,6 +130,10 @@ public:
     const juce::String getProgramName(int index) override;
     void changeProgramName(int index, const juce::String& newName) override;
 
+    // Replace the preset bank (message thread only, never while processBlock may run)
+    bool loadPresetBank(const juce::File& bankFile);
+    const vizasynth::PresetBank& getPresetBank() const { return presetBank; }
+
     //==============================================================================
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
@@ -114,6 +147,7 @@ public:
 
     // Level metering
     float getOutputLevel() const { return outputLevel.load(); }
+    float getOutputRmsLevel() const { return outputRmsLevel.load(); }
     bool isClipping() const { return clipping.load(); }
     void resetClipping() { clipping.store(false); }
 
@@ -121,9 +155,20 @@ public:
     struct NoteInfo { int note; float velocity; };
     std::vector<NoteInfo> getActiveNotes() const;
 
-    // Inject MIDI for virtual keyboard
+    // Inject MIDI for virtual keyboard (any thread but the audio thread),
+    // scheduled sample-accurately like parameter changes from the editor
     void addMidiMessage(const juce::MidiMessage& msg);
 
+    // Set a parameter (plain value) taking effect at a given sample of the
+    // processor's clock rather than one block ahead: offline renders and
+    // tests. From the audio thread only between blocks; a sample time that
+    // has already been rendered applies at the next block start.
+    void scheduleParameterChange(const juce::String& paramId, float value, juce::int64 sampleTime);
+
+    // Polyphony (message thread only, never while processBlock may run)
+    void setNumVoices(int numVoices);
+    int getNumVoices() const { return synth.getNumVoices(); }
+
     // Retrieve a specific voice by index
     VizASynthVoice* getVoice(int index) {
         if (index >= 0 && index < synth.getNumVoices()) {
@@ -133,24 +178,134 @@ public:
     }
 
 private:
+    //==============================================================================
+    // Everything the audio thread applies to the voices, read from the
+    // parameters or taken from a pre-decoded program
+    struct SynthParameters
+    {
+        float oscType = 0.0f;
+        float cutoff = 1000.0f;
+        float resonance = 0.707f;
+        float attack = 0.1f;
+        float decay = 0.1f;
+        float sustain = 0.8f;
+        float release = 0.3f;
+        float pan = 0.0f;
+        float spread = 0.0f;
+        float masterVolume = 0.0f;
+        float chorusEnabled = 0.0f;
+        float chorusRate = 0.8f;
+        float chorusDepth = 0.5f;
+        float chorusMix = 0.5f;
+        float delayEnabled = 0.0f;
+        float delayTime = 375.0f;
+        float delayFeedback = 0.4f;
+        float delayMix = 0.3f;
+        float reverbEnabled = 0.0f;
+        float reverbSize = 0.6f;
+        float reverbDamping = 0.5f;
+        float reverbMix = 0.25f;
+    };
+
     //==============================================================================
     juce::Synthesiser synth;
     juce::AudioProcessorValueTreeState apvts;
     vizasynth::ProbeManager probeManager;
 
+    // Master gain, metering and mix probe in a single pass
+    vizasynth::OutputStage outputStage;
+    std::atomic<float>* masterVolumeParam = nullptr;
+
+    // Mono (or pan-law stereo) bus the voices accumulate into, and the MIDI
+    // of one chunk when a host block is longer than the bus
+    static constexpr int MinVoiceBusSamples = 1024;
+    static constexpr int ChunkMidiBytes = 4096;
+    juce::AudioBuffer<float> voiceBus;
+    juce::MidiBuffer chunkMidi;
+    std::atomic<float>* panParam = nullptr;
+    std::atomic<float>* spreadParam = nullptr;
+
+    // Chorus, delay and reverb on the voice bus, before the output stage
+    vizasynth::EffectsBus effectsBus;
+    std::vector<std::pair<std::atomic<float>*, float SynthParameters::*>> effectParameters;
+
+    // The parameters in force from each split of the voice render, so the
+    // effects follow scheduled changes at the same samples as the voices.
+    // Reserved in prepareToPlay for a split every MinSubBlockSamples.
+    struct EffectSegment
+    {
+        int startSample = 0;
+        SynthParameters parameters;
+    };
+    std::vector<EffectSegment> effectSegments;
+
     // Level metering
     std::atomic<float> outputLevel{0.0f};
+    std::atomic<float> outputRmsLevel{0.0f};
     std::atomic<bool> clipping{false};
 
     // Active notes tracking
     std::array<std::atomic<float>, 128> noteVelocities{};
 
-    // MIDI injection queue
-    juce::MidiBuffer injectedMidi;
-    juce::CriticalSection midiLock;
+    // Timestamped MIDI and parameter changes from outside the audio thread.
+    // The audio thread splits its render at parameter events, at most every
+    // MinSubBlockSamples; closer events are applied together.
+    static constexpr int MinSubBlockSamples = 32;
+    vizasynth::EventQueue eventQueue;
+    juce::int64 sampleClock = 0;  // Audio thread: first sample of the next block
+    std::atomic<std::thread::id> audioThreadId{};
+    uint64_t droppedEventsSeen = 0;  // Audio thread: queue drop count at the last resync
+    std::atomic<bool> syncingProgram{false};
+
+    // Where each parameter (by index) lives in SynthParameters, and the last
+    // plain value seen for it, so every event carries the value it replaces
+    std::vector<float SynthParameters::*> parameterFields;
+    std::unique_ptr<std::atomic<float>[]> lastParameterValues;
+
+    // Programs: the bank and one snapshot per program, decoded when the bank
+    // loads. setCurrentProgram only publishes an index; the audio thread
+    // swaps the snapshot in at the silent point of a short fade, and the
+    // timer copies it into the parameters afterwards (offline renders, which
+    // may have no message loop, copy it on the audio thread right away).
+    static constexpr const char* CurrentProgramProperty = "currentProgram";  // Saved in the state tree
+    vizasynth::PresetBank presetBank;
+    std::vector<SynthParameters> programSnapshots;
+    std::atomic<int> numPrograms{1};
+    std::atomic<int> requestedProgram{-1};
+    std::atomic<int> currentProgram{0};
+    std::atomic<int> unsyncedProgram{-1};  // Switched on the audio thread, parameters not yet updated
+    int pendingProgram = -1;               // Audio thread: waiting for the fade to reach silence
+    std::atomic<bool> cancelPendingProgram{false};  // Set by a state restore, cleared by the audio thread
+    vizasynth::ProgramFade programFade;
+    SynthParameters blockParameters;
+
+    // Non-parameter state restored on a host thread, waiting for the message
+    // thread to put it into apvts.state (which the editor reads unlocked)
+    juce::CriticalSection restoredPropertiesLock;
+    juce::ValueTree restoredProperties;
 
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     void updateVoiceParameters();
+    SynthParameters readParameters() const;
+    SynthParameters decodeProgram(const std::vector<float>& values) const;
+    void applyVoiceParameters(const SynthParameters& parameters);
+    bool applyParameterEvent(const vizasynth::TimedEvent& event);
+    void renderVoices(juce::AudioBuffer<float>& bus, const juce::MidiBuffer& midi, int numSamples);
+    void renderSegment(juce::AudioBuffer<float>& bus, const juce::MidiBuffer& midi, int startSample, int numSamples);
+    void applyEffectParameters(const SynthParameters& parameters);
+    void beginEffectSegment(int startSample);
+    juce::int64 getEventScheduleTime() const;
+    void syncLastParameterValues();
+    void rebuildProgramSnapshots();
+    void syncProgramParameters(int program);
+    void restoreProgramIndex(const juce::ValueTree& state);
+    void restoreProperties(const juce::ValueTree& properties);
+    void timerCallback() override;
+    void handleAsyncUpdate() override;
+
+    // juce::AudioProcessorParameter::Listener
+    void parameterValueChanged(int parameterIndex, float newValue) override;
+    void parameterGestureChanged(int, bool) override {}
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VizASynthAudioProcessor)
 };
\ No newline at end of file
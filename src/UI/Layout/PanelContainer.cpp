@@ -14,6 +14,9 @@ static const char* getProbePointName(ProbePoint probe) {
         case ProbePoint::PostEnvelope: return "Post-Envelope";
         case ProbePoint::Output:       return "Output";
         case ProbePoint::Mix:          return "Mix";
+        case ProbePoint::Chorus:       return "Chorus";
+        case ProbePoint::Delay:        return "Delay";
+        case ProbePoint::Reverb:       return "Reverb";
         default:                       return "Output";
     }
 }
@@ -273,8 +276,9 @@ void PanelContainer::setPanelType(int row, int col, const std::string& panelType
             slot->removeChildComponent(slot->panel.get());
         }
 
-        // Add new panel
+        // Add new panel (panels with a layer painter render it off the message thread)
         slot->panel = std::move(newPanel);
+        slot->panel->setBackgroundRendering(true);
         slot->addAndMakeVisible(*slot->panel);
 
         // Update selector
@@ -443,6 +447,9 @@ void PanelContainer::updateProbeSelectorOptions(juce::ComboBox& selector)
     selector.addItem(getProbePointName(ProbePoint::PostEnvelope), static_cast<int>(ProbePoint::PostEnvelope) + 1);
     selector.addItem(getProbePointName(ProbePoint::Output), static_cast<int>(ProbePoint::Output) + 1);
     selector.addItem(getProbePointName(ProbePoint::Mix), static_cast<int>(ProbePoint::Mix) + 1);
+    selector.addItem(getProbePointName(ProbePoint::Chorus), static_cast<int>(ProbePoint::Chorus) + 1);
+    selector.addItem(getProbePointName(ProbePoint::Delay), static_cast<int>(ProbePoint::Delay) + 1);
+    selector.addItem(getProbePointName(ProbePoint::Reverb), static_cast<int>(ProbePoint::Reverb) + 1);
 
     // Default to Output
     selector.setSelectedId(static_cast<int>(ProbePoint::Output) + 1, juce::dontSendNotification);
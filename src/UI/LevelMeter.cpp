@@ -1,12 +1,22 @@
 #include "LevelMeter.h"
+#include "../Core/TraceRecorder.h"
 
 LevelMeter::LevelMeter()
 {
-    startTimerHz(30);
+    // The timer starts once the meter is showing
+}
+
+void LevelMeter::updateTimer()
+{
+    if (!isShowing())
+        stopTimer();
+    else if (!isTimerRunning())
+        startTimerHz(30);
 }
 
 void LevelMeter::timerCallback()
 {
+    VIZASYNTH_TRACE_SCOPE("timer", "LevelMeter::timerCallback");
     if (getLevelFunc)
     {
         currentLevel = getLevelFunc();
@@ -33,6 +43,7 @@ void LevelMeter::mouseDown(const juce::MouseEvent&)
 
 void LevelMeter::paint(juce::Graphics& g)
 {
+    VIZASYNTH_TRACE_SCOPE("paint", "levelMeter");
     auto& config = vizasynth::ConfigurationManager::getInstance();
     auto bounds = getLocalBounds().toFloat();
 
@@ -20,10 +20,15 @@ public:
     void paint(juce::Graphics& g) override;
     void resized() override {}
     void mouseDown(const juce::MouseEvent&) override;
+    void visibilityChanged() override { updateTimer(); }
+    void parentHierarchyChanged() override { updateTimer(); }
 
 private:
     void timerCallback() override;
 
+    // Poll the level only while the meter is on screen
+    void updateTimer();
+
     std::function<float()> getLevelFunc;
     std::function<bool()> isClippingFunc;
     std::function<void()> resetClipFunc;
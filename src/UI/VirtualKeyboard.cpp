@@ -1,4 +1,5 @@
 #include "VirtualKeyboard.h"
+#include "../Core/TraceRecorder.h"
 
 VirtualKeyboard::VirtualKeyboard()
 {
@@ -7,6 +8,7 @@ VirtualKeyboard::VirtualKeyboard()
 
 void VirtualKeyboard::timerCallback()
 {
+    VIZASYNTH_TRACE_SCOPE("timer", "VirtualKeyboard::timerCallback");
     if (getActiveNotes)
     {
         activeNotes.clear();
@@ -127,6 +129,7 @@ void VirtualKeyboard::mouseUp(const juce::MouseEvent&)
 
 void VirtualKeyboard::paint(juce::Graphics& g)
 {
+    VIZASYNTH_TRACE_SCOPE("paint", "keyboard");
     auto& config = vizasynth::ConfigurationManager::getInstance();
     auto bounds = getLocalBounds().toFloat();
 
@@ -0,0 +1,304 @@
+#include "CaptureReplay.h"
+#include <algorithm>
+#include <cstring>
+
+namespace vizasynth {
+
+namespace {
+
+struct DataSection
+{
+    int64_t offset = 0;
+    int64_t numSamples = 0;
+    double sampleRate = 0.0;
+};
+
+uint64_t readNumber(const unsigned char* data, int numBytes)
+{
+    uint64_t value = 0;
+    for (int i = numBytes; --i >= 0;)
+        value = (value << 8) | data[i];
+    return value;
+}
+
+// Accepts WAVEFORMATEX for IEEE float mono
+bool readFloatFormat(const unsigned char* format, int64_t size, DataSection& section)
+{
+    if (size < 16 || readNumber(format, 2) != 3 || readNumber(format + 2, 2) != 1 || readNumber(format + 14, 2) != 32)
+        return false;
+
+    section.sampleRate = static_cast<double>(readNumber(format + 4, 4));
+    return section.sampleRate > 0.0;
+}
+
+// RIFF WAV: fourCC chunks with 32-bit sizes, padded to even lengths
+bool findWaveData(const unsigned char* file, int64_t fileSize, DataSection& section)
+{
+    if (fileSize < 12 || std::memcmp(file, "RIFF", 4) != 0 || std::memcmp(file + 8, "WAVE", 4) != 0)
+        return false;
+
+    bool haveFormat = false;
+
+    for (int64_t chunk = 12; chunk + 8 <= fileSize;)
+    {
+        const auto size = static_cast<int64_t>(readNumber(file + chunk + 4, 4));
+        const auto body = chunk + 8;
+
+        if (std::memcmp(file + chunk, "fmt ", 4) == 0)
+            haveFormat = readFloatFormat(file + body, std::min(size, fileSize - body), section);
+
+        if (std::memcmp(file + chunk, "data", 4) == 0)
+        {
+            // Sizes saturate past 4 GB; the data then runs to the end of the file
+            const auto available = fileSize - body;
+            const auto bytes = size == 0xffffffff ? available : std::min(size, available);
+            section.offset = body;
+            section.numSamples = bytes / static_cast<int64_t>(sizeof(float));
+            return haveFormat;
+        }
+
+        chunk = body + size + (size & 1);
+    }
+
+    return false;
+}
+
+// Sony Wave64: GUID chunks with 64-bit sizes that include the 24-byte header
+bool findWave64Data(const unsigned char* file, int64_t fileSize, DataSection& section)
+{
+    static constexpr unsigned char riffGuid[16] = {'r', 'i', 'f', 'f', 0x2e, 0x91, 0xcf, 0x11,
+                                                   0xa5, 0xd6, 0x28, 0xdb, 0x04, 0xc1, 0x00, 0x00};
+    static constexpr unsigned char chunkSuffix[12] = {0xf3, 0xac, 0xd3, 0x11, 0x8c, 0xd1,
+                                                      0x00, 0xc0, 0x4f, 0x8e, 0xdb, 0x8a};
+
+    const auto isChunk = [&](int64_t offset, const char* fourCC) {
+        return std::memcmp(file + offset, fourCC, 4) == 0 && std::memcmp(file + offset + 4, chunkSuffix, 12) == 0;
+    };
+
+    if (fileSize < 40 || std::memcmp(file, riffGuid, 16) != 0 || !isChunk(24, "wave"))
+        return false;
+
+    bool haveFormat = false;
+
+    for (int64_t chunk = 40; chunk + 24 <= fileSize;)
+    {
+        const auto size = static_cast<int64_t>(readNumber(file + chunk + 16, 8));
+        const auto body = chunk + 24;
+
+        if (size < 24)
+            return false;
+
+        if (isChunk(chunk, "fmt "))
+            haveFormat = readFloatFormat(file + body, std::min(size - 24, fileSize - body), section);
+
+        if (isChunk(chunk, "data"))
+        {
+            section.offset = body;
+            section.numSamples = std::min(size - 24, fileSize - body) / static_cast<int64_t>(sizeof(float));
+            return haveFormat;
+        }
+
+        chunk += (size + 7) & ~static_cast<int64_t>(7);
+    }
+
+    return false;
+}
+
+} // namespace
+
+//==============================================================================
+// Files
+//==============================================================================
+
+CaptureReplay::CaptureReplay()
+    : juce::Thread("Capture replay")
+{
+    taps[ProbeRecorder::VoiceTap].buffer = &probes.getProbeBuffer();
+    taps[ProbeRecorder::MixTap].buffer = &probes.getMixProbeBuffer();
+}
+
+CaptureReplay::~CaptureReplay()
+{
+    close();
+}
+
+bool CaptureReplay::open(ProbeRecorder::Tap tap, const juce::File& file, double rawSampleRate)
+{
+    auto mapped = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+    const auto* data = static_cast<const unsigned char*>(mapped->getData());
+    const auto fileSize = static_cast<int64_t>(mapped->getSize());
+
+    if (data == nullptr)
+        return false;
+
+    DataSection section;
+
+    if (!findWaveData(data, fileSize, section) && !findWave64Data(data, fileSize, section))
+    {
+        if (!file.hasFileExtension(ProbeRecorder::getFileExtension(ProbeRecorder::Format::RawFloat)))
+            return false;
+
+        section.sampleRate = rawSampleRate;
+        section.numSamples = fileSize / static_cast<int64_t>(sizeof(float));
+    }
+
+    auto& slot = taps[static_cast<size_t>(tap)];
+    const bool otherTapOpen = std::any_of(taps.begin(), taps.end(), [&](const TapFile& t) {
+        return &t != &slot && t.file != nullptr;
+    });
+
+    if (otherTapOpen && section.sampleRate != sampleRate)
+        return false;
+
+    stopThread(1000);
+
+    slot.file = std::move(mapped);
+    slot.samples = reinterpret_cast<const char*>(data) + section.offset;
+    slot.numSamples = section.numSamples;
+
+    sampleRate = section.sampleRate;
+    lengthSamples = 0;
+    for (const auto& t : taps)
+        lengthSamples = std::max(lengthSamples, t.numSamples);
+
+    probes.prepare(sampleRate);
+    probes.setVoiceMode(isOpen(ProbeRecorder::MixTap) ? VoiceMode::Mix : VoiceMode::SingleVoice);
+
+    position.store(0);
+    seekTarget.store(0);
+    startThread();
+    return true;
+}
+
+bool CaptureReplay::openCapture(const juce::File& baseFile, double rawSampleRate)
+{
+    bool opened = false;
+
+    for (auto tap : {ProbeRecorder::VoiceTap, ProbeRecorder::MixTap})
+    {
+        for (auto format : {ProbeRecorder::Format::Wave64, ProbeRecorder::Format::Wave, ProbeRecorder::Format::RawFloat})
+        {
+            const auto file = ProbeRecorder::getTapFile(baseFile, tap, format);
+
+            if (file.existsAsFile() && open(tap, file, rawSampleRate))
+            {
+                opened = true;
+                break;
+            }
+        }
+    }
+
+    return opened;
+}
+
+void CaptureReplay::close()
+{
+    stopThread(1000);
+    playing.store(false);
+
+    for (auto& tap : taps)
+    {
+        tap.file.reset();
+        tap.samples = nullptr;
+        tap.numSamples = 0;
+    }
+
+    lengthSamples = 0;
+    position.store(0);
+}
+
+void CaptureReplay::setPositionSamples(int64_t samples)
+{
+    seekTarget.store(juce::jlimit<int64_t>(0, lengthSamples, samples));
+}
+
+//==============================================================================
+// Feeder thread
+//==============================================================================
+
+void CaptureReplay::run()
+{
+    double lastMs = juce::Time::getMillisecondCounterHiRes();
+    double pending = 0.0;  // Fractional samples carried between steps
+
+    while (!threadShouldExit())
+    {
+        const double nowMs = juce::Time::getMillisecondCounterHiRes();
+        const double elapsedSeconds = (nowMs - lastMs) * 0.001;
+        lastMs = nowMs;
+
+        if (const auto target = seekTarget.exchange(-1); target >= 0)
+        {
+            seekTo(target);
+            pending = 0.0;
+        }
+        else if (playing.load())
+        {
+            pending += elapsedSeconds * sampleRate * speed.load();
+            const auto step = static_cast<int64_t>(pending);
+            pending -= static_cast<double>(step);
+
+            if (step > 0)
+                advanceTo(std::min(position.load() + step, lengthSamples));
+
+            if (position.load() >= lengthSamples)
+                playing.store(false);
+        }
+
+        wait(StepMs);
+    }
+}
+
+void CaptureReplay::seekTo(int64_t target)
+{
+    for (auto& tap : taps)
+    {
+        if (tap.file == nullptr)
+            continue;
+
+        // The feeder is the only writer, so it may discard on the reader's behalf
+        tap.buffer->clear();
+        pushRange(tap, target - tap.buffer->getCapacity(), target);
+    }
+
+    position.store(target);
+}
+
+void CaptureReplay::advanceTo(int64_t target)
+{
+    const int64_t from = position.load();
+
+    for (auto& tap : taps)
+    {
+        if (tap.file == nullptr)
+            continue;
+
+        // Ahead of the reader (fast playback): drop its backlog rather than the newest samples
+        const int64_t capacity = tap.buffer->getCapacity();
+        const int64_t start = std::max(from, target - capacity);
+        if (target - start > capacity - tap.buffer->getAvailableSamples())
+            tap.buffer->clear();
+
+        pushRange(tap, start, target);
+    }
+
+    position.store(target);
+}
+
+void CaptureReplay::pushRange(TapFile& tap, int64_t from, int64_t to)
+{
+    from = juce::jlimit<int64_t>(0, tap.numSamples, from);
+    to = juce::jlimit<int64_t>(from, tap.numSamples, to);
+
+    // Copied out rather than pushed in place: other writers' data need not be float-aligned
+    while (from < to)
+    {
+        const auto count = static_cast<int>(std::min<int64_t>(to - from, ScratchSamples));
+        std::memcpy(scratch.data(), tap.samples + from * static_cast<int64_t>(sizeof(float)),
+                    static_cast<size_t>(count) * sizeof(float));
+        tap.buffer->push(scratch.data(), count);
+        from += count;
+    }
+}
+
+} // namespace vizasynth
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "ProbeBuffer.h"
+#include "ProbeRecorder.h"
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace vizasynth {
+
+/**
+ * CaptureReplay - Plays a recorded capture back into visualization panels
+ *
+ * Owns a ProbeManager of its own and feeds its probe buffers from capture
+ * files instead of the audio thread. Any panel built on that ProbeManager
+ * (e.g. PanelRegistry::createPanel(id, replay.getProbeManager())) reads the
+ * capture exactly as it would read live probes.
+ *
+ * Files are memory-mapped, so multi-gigabyte captures open instantly and
+ * only the pages around the play position are read from disk. Mono float32
+ * WAV and W64 files are read at their own sample rate; raw float32 files
+ * need the rate supplied. The voice tap feeds the single-voice buffer and
+ * the mix the mix buffer, as in the synth.
+ *
+ * A feeder thread advances the position in real time scaled by the speed
+ * (1 = as recorded). When it moves further than a probe ring holds in one
+ * step, or the reader has fallen behind, only the newest samples are kept,
+ * so fast playback always shows the current position. Seeking refills the rings
+ * with the history leading up to the new position, so a paused spectrum or
+ * harmonic view shows the signal at that point.
+ */
+class CaptureReplay : private juce::Thread
+{
+public:
+    CaptureReplay();
+    ~CaptureReplay() override;
+
+    //==========================================================================
+    // Files (message thread)
+    //==========================================================================
+
+    /**
+     * Map one tap's file. All taps must share a sample rate.
+     * @param rawSampleRate Rate of a headerless float32 file
+     */
+    bool open(ProbeRecorder::Tap tap, const juce::File& file, double rawSampleRate = 48000.0);
+
+    /**
+     * Open whichever tap files ProbeRecorder wrote for the capture named
+     * baseFile. @return true if at least one was found
+     */
+    bool openCapture(const juce::File& baseFile, double rawSampleRate = 48000.0);
+
+    void close();
+
+    bool isOpen(ProbeRecorder::Tap tap) const { return taps[static_cast<size_t>(tap)].file != nullptr; }
+
+    // The probe source to build panels on
+    ProbeManager& getProbeManager() { return probes; }
+
+    double getSampleRate() const { return sampleRate; }
+    int64_t getLengthSamples() const { return lengthSamples; }
+    double getLengthSeconds() const { return static_cast<double>(lengthSamples) / sampleRate; }
+
+    //==========================================================================
+    // Transport (any thread)
+    //==========================================================================
+
+    void play() { playing.store(true); }
+    void pause() { playing.store(false); }
+    bool isPlaying() const { return playing.load(); }
+
+    // Playback rate relative to real time (e.g. 4 for four times faster)
+    void setSpeed(double newSpeed) { speed.store(juce::jmax(0.0, newSpeed)); }
+    double getSpeed() const { return speed.load(); }
+
+    // Jump to a position; takes effect at the feeder's next step
+    void setPositionSeconds(double seconds) { setPositionSamples(static_cast<int64_t>(seconds * sampleRate)); }
+    void setPositionSamples(int64_t samples);
+    double getPositionSeconds() const { return static_cast<double>(position.load()) / sampleRate; }
+    int64_t getPositionSamples() const { return position.load(); }
+
+private:
+    static constexpr int StepMs = 10;
+    static constexpr int ScratchSamples = 4096;
+
+    struct TapFile
+    {
+        std::unique_ptr<juce::MemoryMappedFile> file;
+        const char* samples = nullptr;  // Float32 data, possibly unaligned
+        int64_t numSamples = 0;
+        ProbeBuffer* buffer = nullptr;
+    };
+
+    void run() override;
+    void seekTo(int64_t target);
+    void advanceTo(int64_t target);
+    void pushRange(TapFile& tap, int64_t from, int64_t to);
+
+    ProbeManager probes;
+    std::array<TapFile, ProbeRecorder::NumTaps> taps;
+    double sampleRate = 44100.0;
+    int64_t lengthSamples = 0;
+
+    std::atomic<bool> playing{false};
+    std::atomic<double> speed{1.0};
+    std::atomic<int64_t> position{0};
+    std::atomic<int64_t> seekTarget{-1};
+
+    std::array<float, ScratchSamples> scratch{};  // Feeder thread
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CaptureReplay)
+};
+
+} // namespace vizasynth
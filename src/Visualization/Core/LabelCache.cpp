@@ -0,0 +1,49 @@
+#include "LabelCache.h"
+
+namespace vizasynth {
+
+LabelCache::Label& LabelCache::getLabel(int id) {
+    jassert(id >= 0);
+
+    if (static_cast<size_t>(id) >= labels.size())
+        labels.resize(static_cast<size_t>(id) + 1);
+
+    return labels[static_cast<size_t>(id)];
+}
+
+void LabelCache::setText(Label& label, const juce::String& text) {
+    // A new value that reads the same (e.g. after rounding) keeps its layout
+    if (!label.formatted || text != label.text) {
+        label.text = text;
+        label.laidOut = false;
+    }
+
+    label.formatted = true;
+}
+
+void LabelCache::drawLabel(juce::Graphics& g, Label& label, juce::Rectangle<int> area,
+                           juce::Justification justification) {
+    if (label.text.isEmpty())
+        return;
+
+    const auto font = g.getCurrentFont();
+
+    if (!label.laidOut || font != label.font || area != label.area || justification != label.justification) {
+        // Same layout as Graphics::drawText
+        const auto bounds = area.toFloat();
+        label.glyphs.clear();
+        label.glyphs.addCurtailedLineOfText(font, label.text, 0.0f, 0.0f, bounds.getWidth(), true);
+        label.glyphs.justifyGlyphs(0, label.glyphs.getNumGlyphs(), bounds.getX(), bounds.getY(),
+                                   bounds.getWidth(), bounds.getHeight(), justification);
+
+        label.font = font;
+        label.area = area;
+        label.justification = justification;
+        label.laidOut = true;
+        ++layoutCount;
+    }
+
+    label.glyphs.draw(g);
+}
+
+} // namespace vizasynth
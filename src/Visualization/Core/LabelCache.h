@@ -0,0 +1,76 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <array>
+#include <vector>
+
+namespace vizasynth {
+
+/**
+ * LabelCache - Memoised text and glyph layout for panel overlays
+ *
+ * Each label has a fixed id and is drawn from the values its text is
+ * formatted from. The text is only formatted again when those values
+ * change, and only re-laid out when the resulting text, the font or the
+ * area changes, so a steady readout costs one comparison and a glyph draw
+ * per frame instead of string building and shaping.
+ *
+ * Message thread (renderOverlay, renderEquations and friends).
+ */
+class LabelCache {
+public:
+    static constexpr int MaxKeyValues = 4;
+
+    LabelCache() = default;
+
+    /**
+     * Draw label id in area like Graphics::drawText, with the current font
+     * and colour. format() returns the text and is called only when values
+     * differ from the last draw of this id.
+     */
+    template <typename Format, typename... Values>
+    void draw(juce::Graphics& g, int id, juce::Rectangle<int> area, juce::Justification justification,
+              Format&& format, Values... values) {
+        static_assert(sizeof...(Values) <= MaxKeyValues, "Too many key values for a label");
+
+        auto& label = getLabel(id);
+        const Key key{static_cast<double>(values)...};
+
+        if (!label.formatted || label.key != key) {
+            setText(label, format());
+            label.key = key;
+        }
+
+        drawLabel(g, label, area, justification);
+    }
+
+    /** Number of layouts done so far (for benchmarks and debugging). */
+    int getLayoutCount() const { return layoutCount; }
+
+    /** Forget every label, e.g. after the panel's fonts were reconfigured. */
+    void clear() { labels.clear(); }
+
+private:
+    using Key = std::array<double, MaxKeyValues>;
+
+    struct Label {
+        Key key{};
+        bool formatted = false;
+        bool laidOut = false;
+
+        juce::String text;
+        juce::Font font{juce::FontOptions{}};
+        juce::Rectangle<int> area;
+        juce::Justification justification{juce::Justification::left};
+        juce::GlyphArrangement glyphs;
+    };
+
+    Label& getLabel(int id);
+    void setText(Label& label, const juce::String& text);
+    void drawLabel(juce::Graphics& g, Label& label, juce::Rectangle<int> area, juce::Justification justification);
+
+    std::vector<Label> labels;
+    int layoutCount = 0;
+};
+
+} // namespace vizasynth
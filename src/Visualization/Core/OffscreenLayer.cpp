@@ -0,0 +1,146 @@
+#include "OffscreenLayer.h"
+#include "../../Core/TraceRecorder.h"
+#include <mutex>
+#include <optional>
+
+namespace vizasynth {
+
+//=============================================================================
+// Shared state (outlives the panel while a frame is in flight)
+//=============================================================================
+
+struct OffscreenLayer::State {
+    struct Request {
+        Painter painter;
+        int width = 0;
+        int height = 0;
+        float scale = 1.0f;
+    };
+
+    mutable std::mutex lock;
+    std::optional<Request> pending;  // Latest submission wins
+    bool rendering = false;
+
+    juce::Image front, back;
+    int frontWidth = 0;
+    int frontHeight = 0;
+    double lastRenderMs = 0.0;
+
+    juce::Component::SafePointer<juce::Component> owner;
+};
+
+/**
+ * One pool for all panels, sized to leave a core for the audio and message
+ * threads. Alive while any layer exists.
+ */
+class OffscreenLayer::RenderPool {
+public:
+    RenderPool()
+        : pool(juce::ThreadPoolOptions{}
+                   .withThreadName("Panel render")
+                   .withNumberOfThreads(juce::jmax(1, juce::SystemStats::getNumCpus() - 1))) {}
+
+    juce::ThreadPool pool;
+};
+
+//=============================================================================
+// OffscreenLayer
+//=============================================================================
+
+OffscreenLayer::OffscreenLayer(juce::Component& owner)
+    : state(std::make_shared<State>()) {
+    state->owner = &owner;
+}
+
+OffscreenLayer::~OffscreenLayer() {
+    // A frame still rendering keeps the state alive and finds the owner gone
+    std::lock_guard<std::mutex> guard(state->lock);
+    state->pending.reset();
+}
+
+void OffscreenLayer::submit(Painter painter, int width, int height, float scale) {
+    if (width <= 0 || height <= 0 || painter == nullptr)
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(state->lock);
+        state->pending = State::Request{std::move(painter), width, height, scale};
+
+        if (state->rendering)
+            return;
+
+        state->rendering = true;
+    }
+
+    pool->pool.addJob([s = state] { renderPending(s); });
+}
+
+bool OffscreenLayer::drawLatest(juce::Graphics& g, int width, int height) const {
+    std::lock_guard<std::mutex> guard(state->lock);
+
+    if (!state->front.isValid() || state->frontWidth != width || state->frontHeight != height)
+        return false;
+
+    g.drawImage(state->front, juce::Rectangle<float>(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height)));
+    return true;
+}
+
+double OffscreenLayer::getLastRenderMs() const {
+    std::lock_guard<std::mutex> guard(state->lock);
+    return state->lastRenderMs;
+}
+
+void OffscreenLayer::renderPending(const std::shared_ptr<State>& state) {
+    for (;;) {
+        State::Request request;
+        juce::Image target;
+
+        {
+            std::lock_guard<std::mutex> guard(state->lock);
+            if (!state->pending) {
+                state->rendering = false;
+                return;
+            }
+
+            request = std::move(*state->pending);
+            state->pending.reset();
+            target = state->back;
+        }
+
+        VIZASYNTH_TRACE_SCOPE("render", "OffscreenLayer::render");
+
+        const int pixelWidth = juce::roundToInt(static_cast<float>(request.width) * request.scale);
+        const int pixelHeight = juce::roundToInt(static_cast<float>(request.height) * request.scale);
+
+        if (!target.isValid() || target.getWidth() != pixelWidth || target.getHeight() != pixelHeight)
+            target = juce::Image(juce::Image::ARGB, pixelWidth, pixelHeight, true, juce::SoftwareImageType());
+        else
+            target.clear(target.getBounds());
+
+        const double start = juce::Time::getMillisecondCounterHiRes();
+
+        {
+            juce::Graphics g(target);
+            g.addTransform(juce::AffineTransform::scale(request.scale));
+            request.painter(g);
+        }
+
+        const double renderMs = juce::Time::getMillisecondCounterHiRes() - start;
+
+        {
+            std::lock_guard<std::mutex> guard(state->lock);
+            state->lastRenderMs = renderMs;
+            state->back = state->front;
+            state->front = target;
+            state->frontWidth = request.width;
+            state->frontHeight = request.height;
+        }
+
+        juce::MessageManager::callAsync([state] {
+            if (auto* component = state->owner.getComponent())
+                component->repaint();
+        });
+    }
+}
+
+} // namespace vizasynth
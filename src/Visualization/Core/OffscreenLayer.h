@@ -0,0 +1,62 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <functional>
+#include <memory>
+
+namespace vizasynth {
+
+/**
+ * OffscreenLayer - Renders a panel's dynamic layer on a worker thread
+ *
+ * The panel hands over a painter that owns a snapshot of everything it
+ * draws (copied on the message thread). A shared pool of render threads
+ * rasterises it into a software image, and paint() only composites the
+ * most recent finished image. Submissions made while a frame is still
+ * rendering replace each other, so a slow panel skips stale frames instead
+ * of queueing them.
+ *
+ * Frames are double buffered: the worker renders into the back image while
+ * the message thread may be drawing the front one.
+ */
+class OffscreenLayer {
+public:
+    /**
+     * Draws the layer in component coordinates. Runs on a render thread, so
+     * it must only touch data it captured.
+     */
+    using Painter = std::function<void(juce::Graphics&)>;
+
+    explicit OffscreenLayer(juce::Component& owner);
+    ~OffscreenLayer();
+
+    /**
+     * Queue a frame of the given logical size; the owner is repainted when
+     * it is ready.
+     */
+    void submit(Painter painter, int width, int height, float scale);
+
+    /**
+     * Composite the latest finished frame.
+     * @return false if no frame matching the current size is available yet
+     */
+    bool drawLatest(juce::Graphics& g, int width, int height) const;
+
+    /**
+     * How long the most recent frame took to render, in milliseconds.
+     */
+    double getLastRenderMs() const;
+
+private:
+    struct State;
+    class RenderPool;
+
+    static void renderPending(const std::shared_ptr<State>& state);
+
+    std::shared_ptr<State> state;
+    juce::SharedResourcePointer<RenderPool> pool;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OffscreenLayer)
+};
+
+} // namespace vizasynth
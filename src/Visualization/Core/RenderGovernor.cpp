@@ -0,0 +1,106 @@
+#include "RenderGovernor.h"
+#include "VisualizationPanel.h"
+#include <algorithm>
+
+namespace vizasynth {
+
+//=============================================================================
+// RenderQuality
+//=============================================================================
+
+const char* RenderQuality::getName() const {
+    switch (level) {
+        case 0:  return "Full";
+        case 1:  return "Reduced";
+        case 2:  return "NoFill";
+        case 3:  return "SlowUnfocused";
+        default: return "PixelLines";
+    }
+}
+
+//=============================================================================
+// RenderGovernor
+//=============================================================================
+
+RenderGovernor::RenderGovernor() = default;
+
+RenderGovernor::~RenderGovernor() {
+    stopTimer();
+}
+
+void RenderGovernor::addPanel(VisualizationPanel& panel) {
+    if (std::find(panels.begin(), panels.end(), &panel) != panels.end())
+        return;
+
+    panels.push_back(&panel);
+
+    if (!isTimerRunning())
+        startTimer(CheckIntervalMs);
+}
+
+void RenderGovernor::removePanel(VisualizationPanel& panel) {
+    panels.erase(std::remove(panels.begin(), panels.end(), &panel), panels.end());
+
+    if (panels.empty()) {
+        stopTimer();
+        lastFrameMs = 0.0;
+        checksWithHeadroom = 0;
+    }
+}
+
+juce::String RenderGovernor::getStatus() const {
+    juce::String status;
+    status << "frame " << juce::String(lastFrameMs, 2) << " / " << juce::String(targetFrameMs, 1) << " ms";
+
+    for (const auto* panel : panels)
+        status << "\n" << panel->getPanelType() << ": " << panel->getRenderQuality().getName()
+               << " (" << juce::String(panel->getLastFrameMs(), 2) << " ms)";
+
+    return status;
+}
+
+void RenderGovernor::timerCallback() {
+    double total = 0.0;
+    VisualizationPanel* costliest = nullptr;
+    VisualizationPanel* mostDegraded = nullptr;
+
+    for (auto* panel : panels) {
+        const double frameMs = panel->takeAverageFrameMs();
+        const int level = panel->getRenderQuality().level;
+        total += frameMs;
+
+        if (level < RenderQuality::MaxLevel && (costliest == nullptr || frameMs > costliest->getLastFrameMs()))
+            costliest = panel;
+
+        if (level > 0 && (mostDegraded == nullptr || level > mostDegraded->getRenderQuality().level))
+            mostDegraded = panel;
+
+        // Focus moves with the mouse
+        panel->updateRefreshRate();
+    }
+
+    lastFrameMs = total;
+
+    auto step = [](VisualizationPanel& panel, int delta) {
+        panel.setRenderQuality(panel.getRenderQuality().level + delta);
+        DBG("RenderGovernor: " << panel.getPanelType() << " -> " << panel.getRenderQuality().getName());
+    };
+
+    if (total > targetFrameMs) {
+        checksWithHeadroom = 0;
+        if (costliest != nullptr)
+            step(*costliest, 1);
+    }
+    else if (total < targetFrameMs * 0.5) {
+        // Restore slowly: a second of headroom per level
+        if (++checksWithHeadroom >= 1000 / CheckIntervalMs && mostDegraded != nullptr) {
+            checksWithHeadroom = 0;
+            step(*mostDegraded, -1);
+        }
+    }
+    else {
+        checksWithHeadroom = 0;
+    }
+}
+
+} // namespace vizasynth
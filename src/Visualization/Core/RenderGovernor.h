@@ -0,0 +1,77 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <vector>
+
+namespace vizasynth {
+
+class VisualizationPanel;
+
+/**
+ * RenderQuality - What a panel may spend on drawing at a governor level
+ *
+ * Levels are cumulative: each one keeps the savings of the levels below it.
+ *   0 Full          - full detail, anti-aliased paths
+ *   1 Reduced       - traces cut to about two vertices per pixel column
+ *   2 NoFill        - no fill under the spectrum
+ *   3 SlowUnfocused - panels without the mouse over them refresh at a third of the rate
+ *   4 PixelLines    - traces drawn as pixel-aligned column spans, not stroked paths
+ */
+struct RenderQuality {
+    static constexpr int MaxLevel = 4;
+
+    int level = 0;
+
+    bool reduceDetail() const { return level >= 1; }
+    bool fillSpectrum() const { return level < 2; }
+    bool slowWhenUnfocused() const { return level >= 3; }
+    bool pixelLines() const { return level >= 4; }
+
+    const char* getName() const;
+};
+
+/**
+ * RenderGovernor - Holds panel paint time to a per-frame budget
+ *
+ * Showing panels report how long each of their frames took, counting the
+ * worker-thread layer for panels rendered in the background. A few times a
+ * second the governor adds up the average frame cost of every panel; over
+ * budget it lowers the quality of the most expensive panel by one level,
+ * and with plenty of headroom for a while it restores the most degraded one.
+ * One step per check keeps it from oscillating.
+ *
+ * One governor for all panels, alive while any panel exists. Message thread.
+ */
+class RenderGovernor : private juce::Timer {
+public:
+    static constexpr double DefaultTargetFrameMs = 8.0;  // Of a 16.7 ms frame at 60 Hz
+    static constexpr int CheckIntervalMs = 250;
+
+    RenderGovernor();
+    ~RenderGovernor() override;
+
+    void addPanel(VisualizationPanel& panel);
+    void removePanel(VisualizationPanel& panel);
+
+    /** Total paint time per frame the panels together should stay under. */
+    void setTargetFrameMs(double milliseconds) { targetFrameMs = juce::jmax(0.5, milliseconds); }
+    double getTargetFrameMs() const { return targetFrameMs; }
+
+    /** Paint time per frame of all panels, averaged over the last check. */
+    double getFrameMs() const { return lastFrameMs; }
+
+    /** One line per panel with its level and cost, for debugging. */
+    juce::String getStatus() const;
+
+private:
+    void timerCallback() override;
+
+    std::vector<VisualizationPanel*> panels;
+    double targetFrameMs = DefaultTargetFrameMs;
+    double lastFrameMs = 0.0;
+    int checksWithHeadroom = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderGovernor)
+};
+
+} // namespace vizasynth
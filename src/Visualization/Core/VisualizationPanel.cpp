@@ -1,13 +1,18 @@
 #include "VisualizationPanel.h"
+#include "OffscreenLayer.h"
+#include "../../Core/TraceRecorder.h"
+#include <algorithm>
+#include <cmath>
 
 namespace vizasynth {
 
 VisualizationPanel::VisualizationPanel() {
-    startTimerHz(DefaultRefreshRateHz);
+    // The timer starts once the panel is showing (see updateShowing)
 }
 
 VisualizationPanel::~VisualizationPanel() {
     stopTimer();
+    renderGovernor->removePanel(*this);
 }
 
 //=============================================================================
@@ -76,35 +81,139 @@ juce::ValueTree VisualizationPanel::saveConfig() const {
     return config;
 }
 
+//=============================================================================
+// Background Rendering
+//=============================================================================
+
+void VisualizationPanel::setBackgroundRendering(bool enabled) {
+    if (enabled && offscreenLayer == nullptr && juce::SystemStats::getNumCpus() > 1)
+        offscreenLayer = std::make_unique<OffscreenLayer>(*this);
+    else if (!enabled)
+        offscreenLayer.reset();
+
+    repaint();
+}
+
+void VisualizationPanel::refreshDisplay() {
+    if (offscreenLayer != nullptr) {
+        if (auto painter = createLayerPainter()) {
+            offscreenLayer->submit(std::move(painter), getWidth(), getHeight(),
+                                   juce::Component::getApproximateScaleFactorForComponent(this));
+            return;
+        }
+    }
+
+    repaint();
+}
+
+//=============================================================================
+// Render Quality
+//=============================================================================
+
+void VisualizationPanel::setRenderQuality(int level) {
+    level = juce::jlimit(0, RenderQuality::MaxLevel, level);
+    if (level == renderQuality.level)
+        return;
+
+    renderQuality.level = level;
+    updateRefreshRate();
+    refreshDisplay();
+}
+
+double VisualizationPanel::takeAverageFrameMs() {
+    if (paintCount > 0) {
+        // A background layer costs its last render once per frame
+        lastFrameMs = paintMs / paintCount;
+        if (offscreenLayer != nullptr)
+            lastFrameMs += offscreenLayer->getLastRenderMs();
+    }
+    else {
+        lastFrameMs = 0.0;
+    }
+
+    paintMs = 0.0;
+    paintCount = 0;
+    return lastFrameMs;
+}
+
+void VisualizationPanel::updateRefreshRate() {
+    if (!showing)
+        return;
+
+    const int rateHz = renderQuality.slowWhenUnfocused() && !isMouseOver(true) ? UnfocusedRefreshRateHz
+                                                                             : DefaultRefreshRateHz;
+    if (getTimerInterval() != 1000 / rateHz)
+        startTimerHz(rateHz);
+}
+
 //=============================================================================
 // Component Overrides
 //=============================================================================
 
 void VisualizationPanel::paint(juce::Graphics& g) {
+    VIZASYNTH_TRACE_SCOPE("paint", getPanelType().c_str());
+    const double start = juce::Time::getMillisecondCounterHiRes();
+
     // Clear background
     g.fillAll(getBackgroundColour());
 
     // Render layers in order
     renderBackground(g);
-    renderVisualization(g);
+
+    // Composite the worker's latest frame; paint directly until one exists
+    if (offscreenLayer == nullptr || !offscreenLayer->drawLatest(g, getWidth(), getHeight()))
+        renderVisualization(g);
+
     renderOverlay(g);
 
     if (showEquations) {
         renderEquations(g);
     }
+
+    paintMs += juce::Time::getMillisecondCounterHiRes() - start;
+    ++paintCount;
 }
 
 void VisualizationPanel::resized() {
     // Default implementation - subclasses can override
 }
 
+void VisualizationPanel::visibilityChanged() {
+    updateShowing();
+}
+
+void VisualizationPanel::parentHierarchyChanged() {
+    updateShowing();
+}
+
+void VisualizationPanel::updateShowing() {
+    // Hidden panels, and panels in a closed editor, cost nothing
+    const bool nowShowing = isShowing();
+    if (nowShowing == showing)
+        return;
+
+    showing = nowShowing;
+
+    if (showing) {
+        updateRefreshRate();
+        renderGovernor->addPanel(*this);
+    }
+    else {
+        stopTimer();
+        renderGovernor->removePanel(*this);
+    }
+
+    showingChanged(showing);
+}
+
 //=============================================================================
 // Timer
 //=============================================================================
 
 void VisualizationPanel::timerCallback() {
+    VIZASYNTH_TRACE_SCOPE("timer", "VisualizationPanel::timerCallback");
     if (!frozen) {
-        repaint();
+        refreshDisplay();
     }
 }
 
@@ -169,6 +278,41 @@ void VisualizationPanel::drawGrid(juce::Graphics& g, juce::Rectangle<float> boun
     drawGrid(g, bounds, xMajorDivisions, yMajorDivisions, majorColour);
 }
 
+void VisualizationPanel::drawTrace(juce::Graphics& g, const juce::Path& path, float thickness, bool pixelLines) {
+    if (!pixelLines) {
+        g.strokePath(path, juce::PathStrokeType(thickness));
+        return;
+    }
+
+    // One vertical span per pixel column each segment crosses
+    juce::Path::Iterator segment(path);
+    float x0 = 0.0f, y0 = 0.0f;
+
+    while (segment.next()) {
+        if (segment.elementType == juce::Path::Iterator::startNewSubPath) {
+            x0 = segment.x1;
+            y0 = segment.y1;
+            continue;
+        }
+
+        if (segment.elementType != juce::Path::Iterator::lineTo)
+            continue;
+
+        const float x1 = segment.x1, y1 = segment.y1;
+        const float left = std::min(x0, x1), right = std::max(x0, x1);
+        auto yAt = [&](float x) { return right > left ? y0 + (y1 - y0) * (x - x0) / (x1 - x0) : y1; };
+
+        for (int column = static_cast<int>(std::floor(left)); column <= static_cast<int>(std::floor(right)); ++column) {
+            const float a = yAt(juce::jlimit(left, right, static_cast<float>(column)));
+            const float b = yAt(juce::jlimit(left, right, static_cast<float>(column + 1)));
+            g.drawVerticalLine(column, std::min(a, b), std::max(a, b) + 1.0f);
+        }
+
+        x0 = x1;
+        y0 = y1;
+    }
+}
+
 juce::Rectangle<float> VisualizationPanel::getVisualizationBounds() const {
     return getLocalBounds().toFloat().reduced(marginLeft, marginTop)
                                       .withTrimmedRight(marginRight - marginLeft)
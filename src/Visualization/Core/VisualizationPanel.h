@@ -3,8 +3,11 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "../../Core/Types.h"
 #include "../../Core/SignalNode.h"
+#include "LabelCache.h"
+#include "RenderGovernor.h"
 #include <string>
 #include <functional>
+#include <memory>
 
 namespace vizasynth {
 
@@ -13,6 +16,7 @@ class ProbeBuffer;
 class ProbeManager;
 class FilterNode;
 class OscillatorSource;
+class OffscreenLayer;
 
 /**
  * VisualizationPanel - Base class for all visualization components
@@ -22,7 +26,7 @@ class OscillatorSource;
  *   - Freeze/clear functionality
  *   - Sample rate awareness
  *   - Common rendering utilities (grid, etc.)
- *   - Timer-based updates
+ *   - Timer-based updates, running only while the panel is showing
  *   - Configuration loading/saving
  *
  * Visualization Types:
@@ -150,12 +154,61 @@ public:
      */
     virtual juce::ValueTree saveConfig() const;
 
+    //=========================================================================
+    // Background Rendering
+    //=========================================================================
+
+    /**
+     * Render the visualization layer on a worker thread.
+     * Only panels that provide a layer painter are affected; on single-core
+     * machines this stays off and the layer is painted on the message thread.
+     */
+    void setBackgroundRendering(bool enabled);
+
+    /**
+     * Check if the visualization layer is rendered on a worker thread.
+     */
+    bool isBackgroundRendering() const { return offscreenLayer != nullptr; }
+
+    //=========================================================================
+    // Render Quality
+    //=========================================================================
+
+    /**
+     * Quality the render governor currently allows this panel.
+     */
+    RenderQuality getRenderQuality() const { return renderQuality; }
+
+    /**
+     * Set the quality level directly (the governor steps it as paint time changes).
+     */
+    void setRenderQuality(int level);
+
+    /**
+     * Average paint time per frame since the last call, including the
+     * background layer; starts a new average.
+     */
+    double takeAverageFrameMs();
+
+    /**
+     * The average returned by the last takeAverageFrameMs().
+     */
+    double getLastFrameMs() const { return lastFrameMs; }
+
+    /**
+     * Run the refresh timer at the rate the quality allows: full rate with
+     * the mouse over the panel, slower elsewhere at reduced quality.
+     */
+    void updateRefreshRate();
+
     //=========================================================================
     // juce::Component Overrides
     //=========================================================================
 
     void paint(juce::Graphics& g) override final;
     void resized() override;
+    void visibilityChanged() override;
+    void parentHierarchyChanged() override;
 
     //=========================================================================
     // juce::Timer Override
@@ -192,6 +245,28 @@ protected:
      */
     virtual void renderEquations(juce::Graphics& g);
 
+    /**
+     * Called when the panel starts or stops showing on screen (its refresh
+     * timer has just been started or stopped). Panels reading probes
+     * release their claim here so the audio thread stops feeding them.
+     */
+    virtual void showingChanged(bool /*isNowShowing*/) {}
+
+    /**
+     * Painter for the visualization layer, run on a render thread.
+     * Subclasses that support background rendering return a painter that
+     * owns a snapshot of its data; the default (empty) keeps
+     * renderVisualization on the message thread.
+     */
+    using LayerPainter = std::function<void(juce::Graphics&)>;
+    virtual LayerPainter createLayerPainter() { return {}; }
+
+    /**
+     * Request a new frame: submits a layer snapshot when background
+     * rendering is on, otherwise repaints.
+     */
+    void refreshDisplay();
+
     //=========================================================================
     // Common Rendering Utilities
     //=========================================================================
@@ -212,6 +287,12 @@ protected:
                   juce::Colour majorColour = juce::Colour(0xff3d3d54),
                   juce::Colour minorColour = juce::Colour(0xff2d2d44));
 
+    /**
+     * Draw a polyline trace: stroked as an anti-aliased path, or (at
+     * PixelLines quality) as pixel-aligned vertical spans, one per column.
+     */
+    static void drawTrace(juce::Graphics& g, const juce::Path& path, float thickness, bool pixelLines);
+
     /**
      * Get the main visualization bounds (excluding margins/headers).
      */
@@ -253,6 +334,9 @@ protected:
     bool showEquations = false;
     ProbePoint currentProbePoint = ProbePoint::Output;
 
+    // Overlay text, laid out again only when its value changes
+    LabelCache labels;
+
     // Panel margins
     float marginTop = 25.0f;
     float marginBottom = 5.0f;
@@ -261,8 +345,21 @@ protected:
 
     // Refresh rate
     static constexpr int DefaultRefreshRateHz = 60;
+    static constexpr int UnfocusedRefreshRateHz = 20;  // At SlowUnfocused quality and below
 
 private:
+    void updateShowing();
+
+    std::unique_ptr<OffscreenLayer> offscreenLayer;
+    bool showing = false;
+
+    // Paint cost for the governor, which only watches showing panels
+    juce::SharedResourcePointer<RenderGovernor> renderGovernor;
+    RenderQuality renderQuality;
+    double paintMs = 0.0;
+    int paintCount = 0;
+    double lastFrameMs = 0.0;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VisualizationPanel)
 };
 
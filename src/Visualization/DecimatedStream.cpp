@@ -0,0 +1,90 @@
+#include "DecimatedStream.h"
+#include <algorithm>
+#include <cmath>
+
+namespace vizasynth {
+
+//==============================================================================
+// Writer
+//==============================================================================
+
+void DecimatedStream::write(const float* samples, int numSamples)
+{
+    // A new factor starts a fresh point
+    if (const int wanted = requestedFactor.load(std::memory_order_relaxed); wanted != factor)
+    {
+        factor = wanted;
+        count = 0;
+    }
+
+    if (factor <= 0)
+        return;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float sample = samples[i];
+
+        if (count == 0)
+        {
+            minimum = sample;
+            maximum = sample;
+            sumSquares = 0.0f;
+        }
+        else
+        {
+            minimum = std::min(minimum, sample);
+            maximum = std::max(maximum, sample);
+        }
+
+        sumSquares += sample * sample;
+
+        if (++count == factor)
+            emitPoint();
+    }
+}
+
+void DecimatedStream::emitPoint()
+{
+    const uint32_t write = writePosition.load(std::memory_order_relaxed);
+    count = 0;
+
+    if (write - readPosition.load(std::memory_order_acquire) >= static_cast<uint32_t>(Capacity))
+        return;
+
+    auto& point = points[write & Mask];
+    point.minimum = minimum;
+    point.maximum = maximum;
+    point.rms = std::sqrt(sumSquares / static_cast<float>(factor));
+
+    writePosition.store(write + 1, std::memory_order_release);
+}
+
+//==============================================================================
+// Reader
+//==============================================================================
+
+int DecimatedStream::pull(DecimatedPoint* destination, int maxPoints)
+{
+    const uint32_t read = readPosition.load(std::memory_order_relaxed);
+    const uint32_t available = writePosition.load(std::memory_order_acquire) - read;
+    const uint32_t toPull = std::min(available, static_cast<uint32_t>(std::max(0, maxPoints)));
+
+    for (uint32_t i = 0; i < toPull; ++i)
+        destination[i] = points[(read + i) & Mask];
+
+    readPosition.store(read + toPull, std::memory_order_release);
+    return static_cast<int>(toPull);
+}
+
+int DecimatedStream::getAvailablePoints() const
+{
+    return static_cast<int>(writePosition.load(std::memory_order_acquire)
+                            - readPosition.load(std::memory_order_acquire));
+}
+
+void DecimatedStream::clear()
+{
+    readPosition.store(writePosition.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+} // namespace vizasynth
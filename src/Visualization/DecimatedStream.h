@@ -0,0 +1,77 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace vizasynth {
+
+/**
+ * One decimated point: the extremes and RMS of a run of samples.
+ */
+struct DecimatedPoint
+{
+    float minimum = 0.0f;
+    float maximum = 0.0f;
+    float rms = 0.0f;
+};
+
+//==============================================================================
+/**
+ * Low-rate min/max/RMS stream reduced on the audio thread as samples are
+ * written to a probe.
+ *
+ * Panels that draw envelopes or long time spans only need a few hundred to
+ * a few thousand points per second. With a stream enabled they pull those
+ * points instead of full-rate audio, so the ring traffic and UI work scale
+ * with the display rate rather than the sample rate.
+ *
+ * Disabled (factor 0) by default, which costs the writer one relaxed load.
+ * Like ProbeBuffer, one reader at a time; full rings drop new points.
+ */
+class DecimatedStream
+{
+public:
+    static constexpr int Capacity = 4096;  // Points; a power of two
+
+    DecimatedStream() = default;
+
+    // Samples reduced into each point (0 disables the stream). Any thread;
+    // the writer picks it up at its next write and restarts the point.
+    void setFactor(int samplesPerPoint) { requestedFactor.store(juce::jmax(0, samplesPerPoint)); }
+    int getFactor() const { return requestedFactor.load(); }
+    bool isEnabled() const { return requestedFactor.load(std::memory_order_relaxed) > 0; }
+
+    // Audio thread: reduce samples into points
+    void write(const float* samples, int numSamples);
+
+    // UI thread: pull completed points, oldest first
+    int pull(DecimatedPoint* destination, int maxPoints);
+    int getAvailablePoints() const;
+
+    // Discard unread points (reader side)
+    void clear();
+
+private:
+    void emitPoint();
+
+    std::array<DecimatedPoint, Capacity> points{};
+    std::atomic<uint32_t> writePosition{0};
+    std::atomic<uint32_t> readPosition{0};
+    std::atomic<int> requestedFactor{0};
+
+    // Writer state: the point being accumulated
+    int factor = 0;
+    int count = 0;
+    float minimum = 0.0f;
+    float maximum = 0.0f;
+    float sumSquares = 0.0f;
+
+    static constexpr uint32_t Mask = Capacity - 1;
+    static_assert((Capacity & Mask) == 0, "Capacity must be a power of two");
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DecimatedStream)
+};
+
+} // namespace vizasynth
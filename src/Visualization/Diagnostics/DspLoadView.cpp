@@ -0,0 +1,291 @@
+#include "DspLoadView.h"
+#include "../../Core/TraceRecorder.h"
+#include "../Core/PanelRegistry.h"
+#include <algorithm>
+#include <cmath>
+
+namespace vizasynth {
+
+//==============================================================================
+DspLoadView::DspLoadView(ProbeManager& pm)
+    : probeManager(pm)
+{
+    marginLeft = 10.0f;
+    marginRight = 10.0f;
+}
+
+//==============================================================================
+void DspLoadView::clearTrace()
+{
+    probeManager.getDspLoadMonitor().reset();
+
+    rows.fill({});
+    blockHistogram.fill(0);
+    totalLoad = 0.0;
+    averageBlockSeconds = 0.0;
+    worstBlockLoad = 0.0;
+    xruns = 0;
+    hasPrevious = false;
+    repaint();
+}
+
+void DspLoadView::mouseDown(const juce::MouseEvent& /*event*/)
+{
+    clearTrace();
+}
+
+//==============================================================================
+void DspLoadView::timerCallback()
+{
+    VIZASYNTH_TRACE_SCOPE("timer", "DspLoadView::timerCallback");
+    if (frozen || ++ticksSinceUpdate < UpdateIntervalTicks)
+        return;
+
+    ticksSinceUpdate = 0;
+    updateFromSnapshot(probeManager.getDspLoadMonitor().getSnapshot());
+    repaint();
+}
+
+void DspLoadView::updateFromSnapshot(const DspLoadMonitor::Snapshot& snapshot)
+{
+    // Counters were reset (prepareToPlay or a click): start a new interval
+    if (hasPrevious && snapshot.processedSamples < previous.processedSamples)
+        hasPrevious = false;
+
+    ticksPerSecond = snapshot.ticksPerSecond;
+    worstBlockLoad = snapshot.worstBlockLoad;
+    xruns = snapshot.xruns;
+    blockHistogram = snapshot.block.histogram;
+
+    if (!hasPrevious) {
+        previous = snapshot;
+        hasPrevious = true;
+        return;
+    }
+
+    const auto samples = snapshot.processedSamples - previous.processedSamples;
+    const auto blocks = snapshot.block.calls - previous.block.calls;
+
+    // Audio not running: keep showing the last figures
+    if (samples == 0 || blocks == 0 || snapshot.sampleRate <= 0.0)
+        return;
+
+    const double realTime = static_cast<double>(samples) / snapshot.sampleRate;
+    const double blockTime = snapshot.block.totalSeconds - previous.block.totalSeconds;
+    double stageTime = 0.0;
+
+    for (int i = 0; i < DspLoadMonitor::NumStages; ++i) {
+        const auto& current = snapshot.stages[static_cast<size_t>(i)];
+        const auto& before = previous.stages[static_cast<size_t>(i)];
+        const double seconds = current.totalSeconds - before.totalSeconds;
+        const auto calls = current.calls - before.calls;
+
+        auto& row = rows[static_cast<size_t>(i)];
+        row.load = seconds / realTime;
+        row.averageCall = calls > 0 ? seconds / static_cast<double>(calls) : 0.0;
+        row.maxCall = current.maxSeconds;
+        stageTime += seconds;
+    }
+
+    auto& other = rows[static_cast<size_t>(DspLoadMonitor::NumStages)];
+    other.load = std::max(0.0, blockTime - stageTime) / realTime;
+    other.averageCall = std::max(0.0, blockTime - stageTime) / static_cast<double>(blocks);
+    other.maxCall = 0.0;
+
+    totalLoad = blockTime / realTime;
+    averageBlockSeconds = blockTime / static_cast<double>(blocks);
+    deadlineSeconds = realTime / static_cast<double>(blocks);
+
+    previous = snapshot;
+}
+
+//==============================================================================
+juce::Rectangle<float> DspLoadView::getBarsBounds() const
+{
+    auto bounds = getVisualizationBounds();
+    return bounds.removeFromTop(bounds.getHeight() * 0.55f);
+}
+
+juce::Rectangle<float> DspLoadView::getHistogramBounds() const
+{
+    auto bounds = getVisualizationBounds();
+    bounds.removeFromTop(bounds.getHeight() * 0.55f + 24.0f);
+    return bounds.withTrimmedBottom(14.0f);
+}
+
+juce::String DspLoadView::formatSeconds(double seconds)
+{
+    if (seconds >= 1.0e-3)
+        return juce::String(seconds * 1.0e3, 2) + " ms";
+    if (seconds >= 1.0e-6)
+        return juce::String(seconds * 1.0e6, 1) + " us";
+    return juce::String(juce::roundToInt(seconds * 1.0e9)) + " ns";
+}
+
+juce::Colour DspLoadView::getRowColour(int row)
+{
+    switch (row) {
+        case 0:  return juce::Colour(0xffff9500);  // MIDI merge - orange
+        case 1:  return juce::Colour(0xffffd54f);  // Parameters - yellow
+        case 2:  return juce::Colour(0xff00e5ff);  // Voices - cyan
+        case 3:  return juce::Colour(0xffff4081);  // Effects - pink
+        case 4:  return juce::Colour(0xff4caf50);  // Output stage - green
+        case 5:  return juce::Colour(0xffbb86fc);  // Probe writes - purple
+        default: return juce::Colour(0xff808080);  // Other - grey
+    }
+}
+
+//==============================================================================
+void DspLoadView::renderBackground(juce::Graphics& g)
+{
+    auto bars = getBarsBounds();
+    const float labelWidth = 90.0f;
+    auto scale = bars.withTrimmedLeft(labelWidth).withTrimmedRight(150.0f);
+
+    // Load grid: 0, 25, 50, 75, 100 % of real time
+    g.setFont(10.0f);
+    for (int percent = 0; percent <= 100; percent += 25) {
+        const float x = scale.getX() + scale.getWidth() * static_cast<float>(percent) / 100.0f;
+        g.setColour(percent == 100 ? juce::Colour(0xff5a2d2d) : juce::Colour(0xff2a2a2a));
+        g.drawVerticalLine(static_cast<int>(x), scale.getY(), scale.getBottom());
+    }
+
+    auto histogram = getHistogramBounds();
+    g.setColour(juce::Colour(0xff2a2a2a));
+    g.drawHorizontalLine(static_cast<int>(histogram.getBottom()), histogram.getX(), histogram.getRight());
+}
+
+void DspLoadView::renderVisualization(juce::Graphics& g)
+{
+    //--------------------------------------------------------------------------
+    // Per-stage load bars
+    //--------------------------------------------------------------------------
+    auto bars = getBarsBounds();
+    const float labelWidth = 90.0f;
+    const float statsWidth = 150.0f;
+    const float rowHeight = bars.getHeight() / static_cast<float>(NumRows);
+
+    g.setFont(11.0f);
+
+    for (int row = 0; row < NumRows; ++row) {
+        auto rowBounds = bars.removeFromTop(rowHeight).reduced(0.0f, 2.0f);
+        auto label = rowBounds.removeFromLeft(labelWidth);
+        auto stats = rowBounds.removeFromRight(statsWidth);
+        const auto& figures = rows[static_cast<size_t>(row)];
+
+        g.setColour(getTextColour());
+        g.drawText(row < DspLoadMonitor::NumStages
+                       ? juce::String(DspLoadMonitor::getStageName(static_cast<DspStage>(row)))
+                       : juce::String("Other"),
+                   label, juce::Justification::centredLeft);
+
+        const float fraction = static_cast<float>(juce::jlimit(0.0, 1.0, figures.load));
+        g.setColour(getRowColour(row));
+        g.fillRect(rowBounds.withWidth(rowBounds.getWidth() * fraction));
+
+        g.setColour(getDimTextColour());
+        juce::String text = juce::String(figures.load * 100.0, 1) + "%  "
+                          + formatSeconds(figures.averageCall);
+        if (figures.maxCall > 0.0)
+            text << " / " << formatSeconds(figures.maxCall);
+        g.drawText(text, stats.withTrimmedLeft(6.0f), juce::Justification::centredLeft);
+    }
+
+    //--------------------------------------------------------------------------
+    // Block time histogram (log2 buckets)
+    //--------------------------------------------------------------------------
+    auto histogram = getHistogramBounds();
+
+    int first = -1, last = -1;
+    uint32_t peak = 0;
+    for (int b = 0; b < DspLoadMonitor::NumBuckets; ++b) {
+        const auto count = blockHistogram[static_cast<size_t>(b)];
+        if (count == 0)
+            continue;
+        if (first < 0)
+            first = b;
+        last = b;
+        peak = std::max(peak, count);
+    }
+
+    // Always include the deadline bucket so the marker has somewhere to go
+    int deadlineBucket = -1;
+    if (deadlineSeconds > 0.0) {
+        deadlineBucket = juce::jlimit(0, DspLoadMonitor::NumBuckets - 1,
+                                      static_cast<int>(std::log2(deadlineSeconds * ticksPerSecond)));
+        first = first < 0 ? deadlineBucket : std::min(first, deadlineBucket);
+        last = std::max(last, deadlineBucket);
+    }
+
+    if (first < 0 || peak == 0)
+        return;
+
+    const int numBuckets = last - first + 1;
+    const float bucketWidth = histogram.getWidth() / static_cast<float>(numBuckets);
+
+    for (int b = first; b <= last; ++b) {
+        const auto count = blockHistogram[static_cast<size_t>(b)];
+        const float x = histogram.getX() + bucketWidth * static_cast<float>(b - first);
+
+        if (count > 0) {
+            // Log count scale so rare slow blocks stay visible
+            const float height = histogram.getHeight()
+                               * std::log1p(static_cast<float>(count)) / std::log1p(static_cast<float>(peak));
+            g.setColour(b > deadlineBucket && deadlineBucket >= 0 ? juce::Colour(0xffff5252)
+                                                                  : juce::Colour(0xff00e5ff).withAlpha(0.8f));
+            g.fillRect(x + 1.0f, histogram.getBottom() - height, bucketWidth - 2.0f, height);
+        }
+
+        if ((b - first) % 2 == 0) {
+            g.setColour(getDimTextColour());
+            g.setFont(9.0f);
+            g.drawText(formatSeconds(DspLoadMonitor::getBucketSeconds(b, ticksPerSecond)),
+                       static_cast<int>(x), static_cast<int>(histogram.getBottom() + 1.0f),
+                       static_cast<int>(bucketWidth * 2.0f), 12, juce::Justification::centredLeft);
+        }
+    }
+
+    // Deadline marker at its exact position within its bucket
+    if (deadlineBucket >= 0) {
+        const double bucketPosition = std::log2(deadlineSeconds * ticksPerSecond) - static_cast<double>(first);
+        const float x = histogram.getX() + bucketWidth * static_cast<float>(bucketPosition);
+        g.setColour(juce::Colour(0xffff5252));
+        g.drawVerticalLine(static_cast<int>(x), histogram.getY(), histogram.getBottom());
+        g.setFont(9.0f);
+        g.drawText("deadline", static_cast<int>(x) + 3, static_cast<int>(histogram.getY()),
+                   60, 12, juce::Justification::centredLeft);
+    }
+}
+
+void DspLoadView::renderOverlay(juce::Graphics& g)
+{
+    auto header = getLocalBounds().toFloat().removeFromTop(marginTop).reduced(marginLeft, 0.0f);
+
+    g.setColour(getTextColour());
+    g.setFont(12.0f);
+    g.drawText("DSP load " + juce::String(totalLoad * 100.0, 1) + "%  (block "
+                   + formatSeconds(averageBlockSeconds) + " of " + formatSeconds(deadlineSeconds) + ")",
+               header, juce::Justification::centredLeft);
+
+    g.setColour(xruns > 0 ? juce::Colour(0xffff5252) : getDimTextColour());
+    g.setFont(11.0f);
+    g.drawText("worst " + juce::String(worstBlockLoad * 100.0, 0) + "%   xruns "
+                   + juce::String(static_cast<juce::int64>(xruns)),
+               header, juce::Justification::centredRight);
+
+    auto histogram = getHistogramBounds();
+    g.setColour(getDimTextColour());
+    g.setFont(10.0f);
+    g.drawText("Block time histogram (click to reset)",
+               histogram.withY(histogram.getY() - 20.0f).withHeight(14.0f),
+               juce::Justification::centredLeft);
+}
+
+//==============================================================================
+REGISTER_PANEL("dspLoad", "DSP Load", DspLoadView, [] {
+    PanelCapabilities caps;
+    caps.supportsFreezing = true;
+    return caps;
+}())
+
+} // namespace vizasynth
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../Core/VisualizationPanel.h"
+#include "../ProbeBuffer.h"
+#include "../../Core/DspLoadMonitor.h"
+#include <array>
+
+namespace vizasynth {
+
+/**
+ * DSP Load visualization panel.
+ *
+ * Shows where the audio thread spends its time, read from the processor's
+ * DspLoadMonitor a few times per second:
+ * - One bar per stage giving its share of real time (100% = the whole
+ *   block duration), plus "Other" for time outside any stage
+ * - Average and worst time per call for each stage
+ * - Histogram of block processing times with the block deadline marked
+ * - Xrun count and the worst block load seen since the last reset
+ *
+ * Click the panel to reset the counters.
+ */
+class DspLoadView : public VisualizationPanel {
+public:
+    explicit DspLoadView(ProbeManager& probeManager);
+    ~DspLoadView() override = default;
+
+    //=========================================================================
+    // VisualizationPanel Interface
+    //=========================================================================
+
+    std::string getPanelType() const override { return "dspLoad"; }
+    std::string getDisplayName() const override { return "DSP Load"; }
+
+    PanelCapabilities getCapabilities() const override {
+        PanelCapabilities caps;
+        caps.supportsFreezing = true;
+        return caps;
+    }
+
+    void clearTrace() override;
+
+protected:
+    //=========================================================================
+    // VisualizationPanel Overrides
+    //=========================================================================
+
+    void renderBackground(juce::Graphics& g) override;
+    void renderVisualization(juce::Graphics& g) override;
+    void renderOverlay(juce::Graphics& g) override;
+
+    //=========================================================================
+    // juce::Component Overrides
+    //=========================================================================
+
+    void mouseDown(const juce::MouseEvent& event) override;
+
+    //=========================================================================
+    // Timer Override
+    //=========================================================================
+
+    void timerCallback() override;
+
+private:
+    static constexpr int NumRows = DspLoadMonitor::NumStages + 1;  // Stages + "Other"
+    static constexpr int UpdateIntervalTicks = 15;                 // ~4 Hz at 60 fps
+
+    /**
+     * Per-row figures for the last update interval.
+     */
+    struct RowStats {
+        double load = 0.0;         // Fraction of real time
+        double averageCall = 0.0;  // Seconds
+        double maxCall = 0.0;      // Seconds, since reset
+    };
+
+    /**
+     * Compute interval figures from the difference of two snapshots.
+     */
+    void updateFromSnapshot(const DspLoadMonitor::Snapshot& snapshot);
+
+    juce::Rectangle<float> getBarsBounds() const;
+    juce::Rectangle<float> getHistogramBounds() const;
+
+    static juce::String formatSeconds(double seconds);
+    static juce::Colour getRowColour(int row);
+
+    ProbeManager& probeManager;
+
+    DspLoadMonitor::Snapshot previous;
+    bool hasPrevious = false;
+    int ticksSinceUpdate = 0;
+
+    std::array<RowStats, NumRows> rows{};
+    std::array<uint32_t, DspLoadMonitor::NumBuckets> blockHistogram{};
+    double totalLoad = 0.0;
+    double ticksPerSecond = 1.0;
+    double averageBlockSeconds = 0.0;
+    double deadlineSeconds = 0.0;
+    double worstBlockLoad = 0.0;
+    uint64_t xruns = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DspLoadView)
+};
+
+} // namespace vizasynth
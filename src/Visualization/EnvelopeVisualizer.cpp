@@ -1,4 +1,5 @@
 #include "EnvelopeVisualizer.h"
+#include "../Core/TraceRecorder.h"
 
 namespace vizasynth {
 
@@ -18,7 +19,7 @@ EnvelopeVisualizer::EnvelopeVisualizer(juce::AudioProcessorValueTreeState& apvts
     lastSustain = getSustain();
     lastRelease = getRelease();
 
-    startTimerHz(RefreshRateHz);
+    // The timer starts once the view is showing
 }
 
 EnvelopeVisualizer::~EnvelopeVisualizer()
@@ -42,6 +43,7 @@ void EnvelopeVisualizer::parameterChanged(const juce::String& /*parameterID*/, f
 //==============================================================================
 void EnvelopeVisualizer::paint(juce::Graphics& g)
 {
+    VIZASYNTH_TRACE_SCOPE("paint", "envelope");
     auto& config = ConfigurationManager::getInstance();
     auto bounds = getLocalBounds().toFloat().reduced(2);
 
@@ -65,8 +67,27 @@ void EnvelopeVisualizer::resized()
 }
 
 //==============================================================================
+void EnvelopeVisualizer::visibilityChanged()
+{
+    updateTimer();
+}
+
+void EnvelopeVisualizer::parentHierarchyChanged()
+{
+    updateTimer();
+}
+
+void EnvelopeVisualizer::updateTimer()
+{
+    if (!isShowing())
+        stopTimer();
+    else if (!isTimerRunning())
+        startTimerHz(RefreshRateHz);
+}
+
 void EnvelopeVisualizer::timerCallback()
 {
+    VIZASYNTH_TRACE_SCOPE("timer", "EnvelopeVisualizer::timerCallback");
     if (currentState == EnvelopeState::Idle)
         return;
 
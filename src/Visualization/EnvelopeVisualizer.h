@@ -22,6 +22,8 @@ public:
 
     void paint(juce::Graphics& g) override;
     void resized() override;
+    void visibilityChanged() override;
+    void parentHierarchyChanged() override;
 
     // Trigger envelope animation (call on note-on)
     void triggerEnvelope();
@@ -35,6 +37,9 @@ public:
 private:
     void timerCallback() override;
 
+    // Run the playhead timer only while the view is on screen
+    void updateTimer();
+
     // Parameter listener callback
     void parameterChanged(const juce::String& parameterID, float newValue) override;
 
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "../../Core/SharedResourceCache.h"
+#include <juce_dsp/juce_dsp.h>
+#include <memory>
+#include <string>
+
+namespace vizasynth {
+
+/**
+ * FFT plan and Hann window for one transform size.
+ *
+ * Both are only read once built (JUCE's transforms and windowing are
+ * const), so every spectrum and harmonic panel in the process, on any
+ * thread, shares one copy through SharedResourceCache.
+ */
+struct FFTTables {
+    explicit FFTTables(int order)
+        : fft(order),
+          window(static_cast<size_t>(1 << order), juce::dsp::WindowingFunction<float>::hann) {}
+
+    static std::shared_ptr<const FFTTables> get(int order) {
+        return SharedResourceCache::getInstance().get<FFTTables>("hann/" + std::to_string(order), [order] {
+            return std::make_unique<FFTTables>(order);
+        });
+    }
+
+    const juce::dsp::FFT fft;
+    const juce::dsp::WindowingFunction<float> window;
+};
+
+} // namespace vizasynth
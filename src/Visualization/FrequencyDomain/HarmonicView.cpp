@@ -1,4 +1,6 @@
 #include "HarmonicView.h"
+#include "../../Core/TraceRecorder.h"
+#include "../Core/PanelRegistry.h"
 #include <cmath>
 
 namespace vizasynth {
@@ -13,6 +15,9 @@ HarmonicView::HarmonicView(ProbeManager& pm)
     frozenMagnitudes.fill(MinDB);
 
     sampleRate = static_cast<float>(probeManager.getSampleRate());
+
+    // A full FFT frame must fit between two pulls
+    probeManager.requireHistory(0.0, FFTSize);
 }
 
 //==============================================================================
@@ -40,6 +45,9 @@ juce::Colour HarmonicView::getProbeColour(ProbePoint probe)
         case ProbePoint::PostEnvelope: return juce::Colour(0xff4caf50);  // Green
         case ProbePoint::Output:       return juce::Colour(0xff00e5ff);  // Cyan
         case ProbePoint::Mix:          return juce::Colour(0xffffffff);  // White
+        case ProbePoint::Chorus:       return juce::Colour(0xffff4081);  // Pink
+        case ProbePoint::Delay:        return juce::Colour(0xffffd54f);  // Amber
+        case ProbePoint::Reverb:       return juce::Colour(0xff448aff);  // Blue
     }
     return juce::Colours::white;
 }
@@ -60,11 +68,12 @@ void HarmonicView::renderBackground(juce::Graphics& g)
     // dB axis labels on the right
     g.setColour(juce::Colours::grey.darker());
     g.setFont(10.0f);
-    for (float dB = -60.0f; dB <= 0.0f; dB += 20.0f) {
+    for (int i = 0; i < 4; ++i) {
+        const float dB = -60.0f + 20.0f * static_cast<float>(i);
         float y = bounds.getY() + bounds.getHeight() * (1.0f - (dB - MinDB) / (MaxDB - MinDB));
-        g.drawText(juce::String(static_cast<int>(dB)),
-                   static_cast<int>(bounds.getRight() + 2),
-                   static_cast<int>(y - 6), 30, 12, juce::Justification::centredLeft);
+        labels.draw(g, DecibelAxisLabel + i,
+                    {static_cast<int>(bounds.getRight() + 2), static_cast<int>(y - 6), 30, 12},
+                    juce::Justification::centredLeft, [dB] { return juce::String(static_cast<int>(dB)); });
     }
 }
 
@@ -112,10 +121,11 @@ void HarmonicView::renderVisualization(juce::Graphics& g)
         float x = startX + i * (barWidth + barSpacing);
 
         // Harmonic number label
-        juce::String label = (i == 0) ? "f\u2080" : juce::String(harmonicNum);
-        g.drawText(label,
-                   static_cast<int>(x), static_cast<int>(bounds.getBottom() + 2),
-                   static_cast<int>(barWidth), 14, juce::Justification::centred);
+        labels.draw(g, HarmonicAxisLabel + i,
+                    {static_cast<int>(x), static_cast<int>(bounds.getBottom() + 2), static_cast<int>(barWidth), 14},
+                    juce::Justification::centred, [i, harmonicNum] {
+            return (i == 0) ? "f\u2080" : juce::String(harmonicNum);
+        });
     }
 }
 
@@ -199,7 +209,8 @@ void HarmonicView::renderOverlay(juce::Graphics& g)
 {
     auto fullBounds = getLocalBounds().toFloat();
     auto bounds = getVisualizationBounds();
-    auto probeColour = getProbeColour(probeManager.getActiveProbe());
+    const auto activeProbe = probeManager.getActiveProbe();
+    auto probeColour = getProbeColour(activeProbe);
 
     float displayFundamental = frozen ? frozenFundamental : smoothedFundamental;
 
@@ -207,29 +218,34 @@ void HarmonicView::renderOverlay(juce::Graphics& g)
     g.setColour(probeColour);
     g.setFont(12.0f);
 
-    juce::String probeText;
-    switch (probeManager.getActiveProbe()) {
-        case ProbePoint::Oscillator:   probeText = "OSC"; break;
-        case ProbePoint::PostFilter:   probeText = "FILT"; break;
-        case ProbePoint::PostEnvelope: probeText = "ENV"; break;
-        case ProbePoint::Output:       probeText = "OUT"; break;
-        case ProbePoint::Mix:          probeText = "MIX"; break;
-    }
-    g.drawText(probeText, static_cast<int>(fullBounds.getRight() - 50),
-               static_cast<int>(fullBounds.getY() + 5), 45, 15,
-               juce::Justification::centredRight);
+    labels.draw(g, ProbeLabel,
+                {static_cast<int>(fullBounds.getRight() - 50), static_cast<int>(fullBounds.getY() + 5), 45, 15},
+                juce::Justification::centredRight, [activeProbe] {
+        switch (activeProbe) {
+            case ProbePoint::Oscillator:   return juce::String("OSC");
+            case ProbePoint::PostFilter:   return juce::String("FILT");
+            case ProbePoint::PostEnvelope: return juce::String("ENV");
+            case ProbePoint::Output:       return juce::String("OUT");
+            case ProbePoint::Mix:          return juce::String("MIX");
+            case ProbePoint::Chorus:       return juce::String("CHO");
+            case ProbePoint::Delay:        return juce::String("DLY");
+            case ProbePoint::Reverb:       return juce::String("REV");
+        }
+        return juce::String();
+    }, static_cast<int>(activeProbe));
 
     // Draw "HARMONICS" label
     g.setColour(juce::Colours::grey);
-    g.drawText("HARMONICS", static_cast<int>(fullBounds.getX() + 5),
-               static_cast<int>(fullBounds.getY() + 5), 90, 15, juce::Justification::centredLeft);
+    labels.draw(g, TitleLabel,
+                {static_cast<int>(fullBounds.getX() + 5), static_cast<int>(fullBounds.getY() + 5), 90, 15},
+                juce::Justification::centredLeft, [] { return juce::String("HARMONICS"); });
 
     // Draw frozen indicator
     if (frozen) {
         g.setColour(juce::Colours::red.withAlpha(0.8f));
-        g.drawText("FROZEN", static_cast<int>(fullBounds.getCentreX() - 30),
-                   static_cast<int>(fullBounds.getY() + 5), 60, 15,
-                   juce::Justification::centred);
+        labels.draw(g, FrozenLabel,
+                    {static_cast<int>(fullBounds.getCentreX() - 30), static_cast<int>(fullBounds.getY() + 5), 60, 15},
+                    juce::Justification::centred, [] { return juce::String("FROZEN"); });
     }
 
     // Display fundamental frequency info (only if we have a signal)
@@ -237,26 +253,27 @@ void HarmonicView::renderOverlay(juce::Graphics& g)
         g.setColour(getTextColour());
         g.setFont(11.0f);
 
-        // Note name with cents deviation
-        juce::String noteName = frequencyToNoteName(displayFundamental);
-        float cents = frequencyToCentsDeviation(displayFundamental);
-        juce::String centsStr = (cents >= 0 ? "+" : "") + juce::String(static_cast<int>(cents)) + "c";
+        const int halfWidth = static_cast<int>(bounds.getWidth() / 2);
 
-        // Frequency and note display
-        auto freqVal = FrequencyValue::fromHz(displayFundamental, sampleRate);
-        juce::String freqInfo = "f\u2080 = " + juce::String(displayFundamental, 1) + " Hz (" +
-                                 noteName + " " + centsStr + ")";
+        // Frequency and note display, with cents deviation
+        labels.draw(g, FundamentalLabel,
+                    {static_cast<int>(bounds.getX()), static_cast<int>(bounds.getY() - 15), halfWidth, 12},
+                    juce::Justification::centredLeft, [displayFundamental] {
+            juce::String noteName = frequencyToNoteName(displayFundamental);
+            float cents = frequencyToCentsDeviation(displayFundamental);
+            juce::String centsStr = (cents >= 0 ? "+" : "") + juce::String(static_cast<int>(cents)) + "c";
 
-        g.drawText(freqInfo, static_cast<int>(bounds.getX()),
-                   static_cast<int>(bounds.getY() - 15),
-                   static_cast<int>(bounds.getWidth() / 2), 12, juce::Justification::centredLeft);
+            return "f\u2080 = " + juce::String(displayFundamental, 1) + " Hz (" +
+                   noteName + " " + centsStr + ")";
+        }, displayFundamental);
 
         // Show normalized frequency
         g.setColour(getDimTextColour());
-        g.drawText(freqVal.toNormalizedString(),
-                   static_cast<int>(bounds.getX() + bounds.getWidth() / 2),
-                   static_cast<int>(bounds.getY() - 15),
-                   static_cast<int>(bounds.getWidth() / 2), 12, juce::Justification::centredRight);
+        labels.draw(g, NormalizedLabel,
+                    {static_cast<int>(bounds.getX() + bounds.getWidth() / 2), static_cast<int>(bounds.getY() - 15), halfWidth, 12},
+                    juce::Justification::centredRight, [this, displayFundamental] {
+            return juce::String(FrequencyValue::fromHz(displayFundamental, sampleRate).toNormalizedString());
+        }, displayFundamental, sampleRate);
     }
 
     // Voice indicator (only show in single voice mode)
@@ -264,10 +281,10 @@ void HarmonicView::renderOverlay(juce::Graphics& g)
         int activeVoice = probeManager.getActiveVoice();
         if (activeVoice >= 0) {
             g.setColour(juce::Colours::grey);
-            g.drawText("Voice " + juce::String(activeVoice + 1) + "/8",
-                       static_cast<int>(fullBounds.getX() + 5),
-                       static_cast<int>(bounds.getBottom() - 15), 80, 15,
-                       juce::Justification::centredLeft);
+            labels.draw(g, VoiceLabel,
+                        {static_cast<int>(fullBounds.getX() + 5), static_cast<int>(bounds.getBottom() - 15), 80, 15},
+                        juce::Justification::centredLeft,
+                        [activeVoice] { return "Voice " + juce::String(activeVoice + 1) + "/8"; }, activeVoice);
         }
     }
 
@@ -277,10 +294,11 @@ void HarmonicView::renderOverlay(juce::Graphics& g)
     // Draw sample rate info
     g.setColour(getDimTextColour());
     g.setFont(10.0f);
-    juce::String fsText = "fs: " + formatSampleRate(sampleRate);
-    g.drawText(fsText, static_cast<int>(bounds.getX()),
-               static_cast<int>(fullBounds.getBottom() - 15),
-               static_cast<int>(bounds.getWidth()), 12, juce::Justification::centred);
+    labels.draw(g, SampleRateLabel,
+                {static_cast<int>(bounds.getX()), static_cast<int>(fullBounds.getBottom() - 15),
+                 static_cast<int>(bounds.getWidth()), 12},
+                juce::Justification::centred, [this] { return "fs: " + juce::String(formatSampleRate(sampleRate)); },
+                sampleRate);
 }
 
 void HarmonicView::renderEquations(juce::Graphics& g)
@@ -295,8 +313,9 @@ void HarmonicView::renderEquations(juce::Graphics& g)
     g.setFont(11.0f);
 
     // Show Fourier series equation
-    juce::String equation = "x(t) = \u03A3 A\u2099 sin(n\u03C9\u2080t + \u03C6\u2099)";
-    g.drawText(equation, bounds.reduced(8), juce::Justification::centred);
+    labels.draw(g, EquationLabel, bounds.reduced(8).toNearestInt(), juce::Justification::centred, [] {
+        return juce::String("x(t) = \u03A3 A\u2099 sin(n\u03C9\u2080t + \u03C6\u2099)");
+    });
 }
 
 void HarmonicView::resized()
@@ -323,11 +342,14 @@ void HarmonicView::mouseDown(const juce::MouseEvent& event)
 //==============================================================================
 void HarmonicView::timerCallback()
 {
+    VIZASYNTH_TRACE_SCOPE("timer", "HarmonicView::timerCallback");
     // Don't process if not visible - prevents stealing data from other visualizers
     if (!isVisible()) {
         return;
     }
 
+    probeConsumer.claim(getActiveBuffer());
+
     sampleRate = static_cast<float>(probeManager.getSampleRate());
 
     if (frozen) {
@@ -355,7 +377,7 @@ void HarmonicView::timerCallback()
     }
 
     // Pull available samples from the appropriate probe buffer
-    std::vector<float> tempBuffer(ProbeBuffer::BufferSize);
+    std::vector<float> tempBuffer(static_cast<size_t>(getActiveBuffer().getCapacity()));
     int numPulled = getActiveBuffer().pull(tempBuffer.data(),
                                            static_cast<int>(tempBuffer.size()));
 
@@ -383,18 +405,24 @@ void HarmonicView::timerCallback()
     repaint();
 }
 
+void HarmonicView::showingChanged(bool isNowShowing)
+{
+    if (!isNowShowing)
+        probeConsumer.release();
+}
+
 void HarmonicView::processFFT()
 {
     // Copy samples and apply window
     std::copy(inputBuffer.begin(), inputBuffer.begin() + FFTSize, fftInput.begin());
-    window.multiplyWithWindowingTable(fftInput.data(), FFTSize);
+    fftTables->window.multiplyWithWindowingTable(fftInput.data(), FFTSize);
 
     // Prepare FFT buffer
     std::fill(fftOutput.begin(), fftOutput.end(), 0.0f);
     std::copy(fftInput.begin(), fftInput.end(), fftOutput.begin());
 
     // Perform FFT
-    fft.performFrequencyOnlyForwardTransform(fftOutput.data());
+    fftTables->fft.performFrequencyOnlyForwardTransform(fftOutput.data());
 
     // Store magnitude spectrum
     for (size_t i = 0; i < FFTSize / 2; ++i) {
@@ -466,8 +494,10 @@ void HarmonicView::extractHarmonics(float fundamental)
 //==============================================================================
 ProbeBuffer& HarmonicView::getActiveBuffer()
 {
-    if (probeManager.getVoiceMode() == VoiceMode::Mix &&
-        probeManager.getActiveProbe() == ProbePoint::Output) {
+    // The effects bus is only ever probed through the mix buffer
+    const auto activeProbe = probeManager.getActiveProbe();
+    if (isEffectProbePoint(activeProbe) ||
+        (probeManager.getVoiceMode() != VoiceMode::SingleVoice && activeProbe == ProbePoint::Output)) {
         return probeManager.getMixProbeBuffer();
     }
     return probeManager.getProbeBuffer();
@@ -486,7 +516,7 @@ void HarmonicView::drawVoiceModeToggle(juce::Graphics& g, juce::Rectangle<float>
     mixButtonBounds = juce::Rectangle<float>(startX, startY, buttonWidth, buttonHeight);
     voiceButtonBounds = juce::Rectangle<float>(startX + buttonWidth + spacing, startY, buttonWidth, buttonHeight);
 
-    bool isMixMode = probeManager.getVoiceMode() == VoiceMode::Mix;
+    bool isMixMode = probeManager.getVoiceMode() != VoiceMode::SingleVoice;
 
     g.setColour(isMixMode ? juce::Colour(0xff4a4a4a) : juce::Colour(0xff2a2a2a));
     g.fillRoundedRectangle(mixButtonBounds, 3.0f);
@@ -535,4 +565,13 @@ float HarmonicView::frequencyToCentsDeviation(float frequency)
     return (semitones - static_cast<float>(roundedSemitones)) * 100.0f;
 }
 
+//==============================================================================
+REGISTER_PANEL("harmonic", "Harmonic View", HarmonicView, [] {
+    PanelCapabilities caps;
+    caps.needsProbeBuffer = true;
+    caps.supportsFreezing = true;
+    caps.supportsEquations = true;
+    return caps;
+}())
+
 } // namespace vizasynth
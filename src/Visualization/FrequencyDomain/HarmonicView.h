@@ -3,6 +3,7 @@
 #include "../Core/VisualizationPanel.h"
 #include "../ProbeBuffer.h"
 #include "../../Core/FrequencyValue.h"
+#include "FFTTables.h"
 #include "../../Core/Types.h"
 #include <juce_dsp/juce_dsp.h>
 #include <vector>
@@ -107,8 +108,25 @@ protected:
     //=========================================================================
 
     void timerCallback() override;
+    void showingChanged(bool isNowShowing) override;
 
 private:
+    /**
+     * Overlay and axis label ids in the label cache.
+     */
+    enum OverlayLabel {
+        ProbeLabel,
+        TitleLabel,
+        FrozenLabel,
+        FundamentalLabel,
+        NormalizedLabel,
+        VoiceLabel,
+        SampleRateLabel,
+        EquationLabel,
+        DecibelAxisLabel,                  // One per dB tick
+        HarmonicAxisLabel = DecibelAxisLabel + 4  // One per bar
+    };
+
     /**
      * Process FFT and extract harmonics.
      */
@@ -151,10 +169,10 @@ private:
     static float frequencyToCentsDeviation(float frequency);
 
     ProbeManager& probeManager;
+    ProbeManager::Consumer probeConsumer{probeManager};  // Keeps the tap being read live
 
     // FFT
-    juce::dsp::FFT fft{FFTOrder};
-    juce::dsp::WindowingFunction<float> window{FFTSize, juce::dsp::WindowingFunction<float>::hann};
+    std::shared_ptr<const FFTTables> fftTables = FFTTables::get(FFTOrder);  // Shared process-wide
 
     // Buffers
     std::array<float, FFTSize> fftInput{};
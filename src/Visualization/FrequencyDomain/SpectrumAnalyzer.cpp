@@ -1,4 +1,6 @@
 #include "SpectrumAnalyzer.h"
+#include "../../Core/TraceRecorder.h"
+#include "../Core/PanelRegistry.h"
 #include <cmath>
 
 namespace vizasynth {
@@ -13,6 +15,9 @@ SpectrumAnalyzer::SpectrumAnalyzer(ProbeManager& pm)
     frozenSpectrum.fill(MinDB);
 
     sampleRate = static_cast<float>(probeManager.getSampleRate());
+
+    // A full FFT frame must fit between two pulls
+    probeManager.requireHistory(0.0, FFTSize);
 }
 
 //==============================================================================
@@ -22,12 +27,13 @@ void SpectrumAnalyzer::setFrozen(bool freeze)
         frozenSpectrum = smoothedSpectrum;
     }
     frozen = freeze;
+    refreshDisplay();
 }
 
 void SpectrumAnalyzer::clearTrace()
 {
     frozenSpectrum.fill(MinDB);
-    repaint();
+    refreshDisplay();
 }
 
 juce::Colour SpectrumAnalyzer::getProbeColour(ProbePoint probe)
@@ -38,6 +44,9 @@ juce::Colour SpectrumAnalyzer::getProbeColour(ProbePoint probe)
         case ProbePoint::PostEnvelope: return juce::Colour(0xff4caf50);  // Green
         case ProbePoint::Output:       return juce::Colour(0xff00e5ff);  // Cyan
         case ProbePoint::Mix:          return juce::Colour(0xffffffff);  // White
+        case ProbePoint::Chorus:       return juce::Colour(0xffff4081);  // Pink
+        case ProbePoint::Delay:        return juce::Colour(0xffffd54f);  // Amber
+        case ProbePoint::Reverb:       return juce::Colour(0xff448aff);  // Blue
     }
     return juce::Colours::white;
 }
@@ -77,67 +86,93 @@ void SpectrumAnalyzer::renderBackground(juce::Graphics& g)
         std::make_pair(20000.0f, "20k")
     };
 
-    for (const auto& [freq, label] : freqLabels) {
+    for (size_t i = 0; i < freqLabels.size(); ++i) {
+        const auto& [freq, label] = freqLabels[i];
         float x = frequencyToX(freq, bounds);
-        g.drawText(label, static_cast<int>(x - 15), static_cast<int>(bounds.getBottom() + 2),
-                   30, 12, juce::Justification::centred);
+        labels.draw(g, FrequencyAxisLabel + static_cast<int>(i),
+                    {static_cast<int>(x - 15), static_cast<int>(bounds.getBottom() + 2), 30, 12},
+                    juce::Justification::centred, [text = label] { return juce::String(text); });
     }
 
     // dB labels
-    for (float dB = -80.0f; dB <= 0.0f; dB += 20.0f) {
+    for (int i = 0; i < 5; ++i) {
+        const float dB = -80.0f + 20.0f * static_cast<float>(i);
         float y = magnitudeToY(dB, bounds);
-        g.drawText(juce::String(static_cast<int>(dB)), static_cast<int>(bounds.getRight() + 2),
-                   static_cast<int>(y - 6), 25, 12, juce::Justification::centredLeft);
+        labels.draw(g, DecibelAxisLabel + i,
+                    {static_cast<int>(bounds.getRight() + 2), static_cast<int>(y - 6), 25, 12},
+                    juce::Justification::centredLeft, [dB] { return juce::String(static_cast<int>(dB)); });
     }
 }
 
 void SpectrumAnalyzer::renderVisualization(juce::Graphics& g)
 {
-    auto bounds = getVisualizationBounds();
-    auto probeColour = getProbeColour(probeManager.getActiveProbe());
+    paintFrame(g, captureFrame());
+}
+
+VisualizationPanel::LayerPainter SpectrumAnalyzer::createLayerPainter()
+{
+    return [frame = captureFrame()](juce::Graphics& g) { paintFrame(g, frame); };
+}
 
+SpectrumAnalyzer::SpectrumFrame SpectrumAnalyzer::captureFrame() const
+{
+    SpectrumFrame frame;
+    frame.bounds = getVisualizationBounds();
+    frame.magnitudes = frozen ? frozenSpectrum : smoothedSpectrum;
+    frame.colour = getProbeColour(probeManager.getActiveProbe());
+    frame.sampleRate = sampleRate;
+    frame.quality = getRenderQuality();
+    return frame;
+}
+
+void SpectrumAnalyzer::paintFrame(juce::Graphics& g, const SpectrumFrame& frame)
+{
     // Draw Nyquist marker
-    drawNyquistMarker(g, bounds);
+    drawNyquistMarker(g, frame);
 
     // Draw spectrum
-    if (frozen) {
-        drawSpectrum(g, bounds, frozenSpectrum, probeColour);
-    } else {
-        drawSpectrum(g, bounds, smoothedSpectrum, probeColour);
-    }
+    drawSpectrum(g, frame);
 }
 
 void SpectrumAnalyzer::renderOverlay(juce::Graphics& g)
 {
     auto fullBounds = getLocalBounds().toFloat();
     auto bounds = getVisualizationBounds();
-    auto probeColour = getProbeColour(probeManager.getActiveProbe());
+    const auto activeProbe = probeManager.getActiveProbe();
+    auto probeColour = getProbeColour(activeProbe);
 
     // Draw probe indicator
     g.setColour(probeColour);
     g.setFont(12.0f);
 
-    juce::String probeText;
-    switch (probeManager.getActiveProbe()) {
-        case ProbePoint::Oscillator:   probeText = "OSC"; break;
-        case ProbePoint::PostFilter:   probeText = "FILT"; break;
-        case ProbePoint::PostEnvelope: probeText = "ENV"; break;
-        case ProbePoint::Output:       probeText = "OUT"; break;
-        case ProbePoint::Mix:          probeText = "MIX"; break;
-    }
-    g.drawText(probeText, static_cast<int>(fullBounds.getRight() - 50), static_cast<int>(fullBounds.getY() + 5), 45, 15,
-               juce::Justification::centredRight);
+    labels.draw(g, ProbeLabel,
+                {static_cast<int>(fullBounds.getRight() - 50), static_cast<int>(fullBounds.getY() + 5), 45, 15},
+                juce::Justification::centredRight, [activeProbe] {
+        switch (activeProbe) {
+            case ProbePoint::Oscillator:   return juce::String("OSC");
+            case ProbePoint::PostFilter:   return juce::String("FILT");
+            case ProbePoint::PostEnvelope: return juce::String("ENV");
+            case ProbePoint::Output:       return juce::String("OUT");
+            case ProbePoint::Mix:          return juce::String("MIX");
+            case ProbePoint::Chorus:       return juce::String("CHO");
+            case ProbePoint::Delay:        return juce::String("DLY");
+            case ProbePoint::Reverb:       return juce::String("REV");
+        }
+        return juce::String();
+    }, static_cast<int>(activeProbe));
 
     // Draw "SPECTRUM" label
     g.setColour(juce::Colours::grey);
-    g.drawText("SPECTRUM", static_cast<int>(fullBounds.getX() + 5), static_cast<int>(fullBounds.getY() + 5),
-               80, 15, juce::Justification::centredLeft);
+    labels.draw(g, TitleLabel,
+                {static_cast<int>(fullBounds.getX() + 5), static_cast<int>(fullBounds.getY() + 5), 80, 15},
+                juce::Justification::centredLeft, [] { return juce::String("SPECTRUM"); });
 
     // Draw frozen indicator
     if (frozen) {
         g.setColour(juce::Colours::red.withAlpha(0.8f));
-        g.drawText("FROZEN", static_cast<int>(fullBounds.getCentreX() - 30), static_cast<int>(fullBounds.getY() + 5), 60, 15,
-                   juce::Justification::centred);
+        labels.draw(g, FrozenLabel,
+                    {static_cast<int>(fullBounds.getCentreX() - 30), static_cast<int>(fullBounds.getY() + 5), 60, 15},
+                    juce::Justification::centred, [] { return juce::String("FROZEN"); });
     }
 
     // Voice indicator (only show in single voice mode)
@@ -145,9 +180,10 @@ void SpectrumAnalyzer::renderOverlay(juce::Graphics& g)
         int activeVoice = probeManager.getActiveVoice();
         if (activeVoice >= 0) {
             g.setColour(juce::Colours::grey);
-            g.drawText("Voice " + juce::String(activeVoice + 1) + "/8",
-                       static_cast<int>(fullBounds.getX() + 5), static_cast<int>(bounds.getBottom() - 15), 80, 15,
-                       juce::Justification::centredLeft);
+            labels.draw(g, VoiceLabel,
+                        {static_cast<int>(fullBounds.getX() + 5), static_cast<int>(bounds.getBottom() - 15), 80, 15},
+                        juce::Justification::centredLeft,
+                        [activeVoice] { return "Voice " + juce::String(activeVoice + 1) + "/8"; }, activeVoice);
         }
     }
 
@@ -157,10 +193,13 @@ void SpectrumAnalyzer::renderOverlay(juce::Graphics& g)
     // Draw sample rate and FFT info
     g.setColour(getDimTextColour());
     g.setFont(10.0f);
-    juce::String fsText = "fs: " + formatSampleRate(sampleRate);
-    juce::String binText = "FFT: " + juce::String(FFTSize) + " pts";
-    g.drawText(fsText + " | " + binText, static_cast<int>(bounds.getX()), static_cast<int>(bounds.getY() - 15),
-               static_cast<int>(bounds.getWidth()), 12, juce::Justification::centred);
+    labels.draw(g, InfoLabel,
+                {static_cast<int>(bounds.getX()), static_cast<int>(bounds.getY() - 15), static_cast<int>(bounds.getWidth()), 12},
+                juce::Justification::centred, [this] {
+        juce::String fsText = "fs: " + formatSampleRate(sampleRate);
+        juce::String binText = "FFT: " + juce::String(FFTSize) + " pts";
+        return fsText + " | " + binText;
+    }, sampleRate);
 }
 
 void SpectrumAnalyzer::renderEquations(juce::Graphics& g)
@@ -175,17 +214,17 @@ void SpectrumAnalyzer::renderEquations(juce::Graphics& g)
     g.setFont(11.0f);
 
     // Show DFT equation
-    juce::String equation = "X[k] = sum(x[n] * e^(-j*2*pi*k*n/N))";
-    g.drawText(equation, bounds.reduced(8), juce::Justification::centred);
+    labels.draw(g, EquationLabel, bounds.reduced(8).toNearestInt(), juce::Justification::centred,
+                [] { return juce::String("X[k] = sum(x[n] * e^(-j*2*pi*k*n/N))"); });
 
     // Show bin width
     float binWidth = sampleRate / FFTSize;
     g.setFont(10.0f);
     g.setColour(getDimTextColour());
-    g.drawText("Bin width: " + juce::String(binWidth, 1) + " Hz",
-               static_cast<int>(bounds.getX() + 8), static_cast<int>(bounds.getBottom() - 18),
-               static_cast<int>(bounds.getWidth() - 16), 14,
-               juce::Justification::left);
+    labels.draw(g, BinWidthLabel,
+                {static_cast<int>(bounds.getX() + 8), static_cast<int>(bounds.getBottom() - 18),
+                 static_cast<int>(bounds.getWidth() - 16), 14},
+                juce::Justification::left, [binWidth] { return "Bin width: " + juce::String(binWidth, 1) + " Hz"; }, binWidth);
 }
 
 void SpectrumAnalyzer::resized()
@@ -200,22 +239,25 @@ void SpectrumAnalyzer::mouseDown(const juce::MouseEvent& event)
     if (mixButtonBounds.contains(pos)) {
         probeManager.setVoiceMode(VoiceMode::Mix);
         inputBuffer.clear();
-        repaint();
+        refreshDisplay();
     }
     else if (voiceButtonBounds.contains(pos)) {
         probeManager.setVoiceMode(VoiceMode::SingleVoice);
         inputBuffer.clear();
-        repaint();
+        refreshDisplay();
     }
 }
 
 //==============================================================================
 void SpectrumAnalyzer::timerCallback()
 {
+    VIZASYNTH_TRACE_SCOPE("timer", "SpectrumAnalyzer::timerCallback");
     // Don't process if not visible - prevents stealing data from other visualizers
     if (!isVisible())
         return;
 
+    probeConsumer.claim(getActiveBuffer());
+
     sampleRate = static_cast<float>(probeManager.getSampleRate());
 
     if (frozen) {
@@ -223,7 +265,7 @@ void SpectrumAnalyzer::timerCallback()
     }
 
     // Pull available samples from the appropriate probe buffer
-    std::vector<float> tempBuffer(ProbeBuffer::BufferSize);
+    std::vector<float> tempBuffer(static_cast<size_t>(getActiveBuffer().getCapacity()));
     int numPulled = getActiveBuffer().pull(tempBuffer.data(),
                                            static_cast<int>(tempBuffer.size()));
 
@@ -234,25 +276,31 @@ void SpectrumAnalyzer::timerCallback()
 
         // Process FFT when we have enough samples
         while (inputBuffer.size() >= static_cast<size_t>(FFTSize)) {
-            processFFT();
+            processFFT(inputBuffer.data());
             // Remove processed samples (with 50% overlap)
             inputBuffer.erase(inputBuffer.begin(), inputBuffer.begin() + FFTSize / 2);
         }
     }
 
-    repaint();
+    refreshDisplay();
 }
 
-void SpectrumAnalyzer::processFFT()
+void SpectrumAnalyzer::showingChanged(bool isNowShowing)
 {
-    std::copy(inputBuffer.begin(), inputBuffer.begin() + FFTSize, fftInput.begin());
+    if (!isNowShowing)
+        probeConsumer.release();
+}
 
-    window.multiplyWithWindowingTable(fftInput.data(), FFTSize);
+void SpectrumAnalyzer::processFFT(const float* samples)
+{
+    std::copy(samples, samples + FFTSize, fftInput.begin());
+
+    fftTables->window.multiplyWithWindowingTable(fftInput.data(), FFTSize);
 
     std::fill(fftOutput.begin(), fftOutput.end(), 0.0f);
     std::copy(fftInput.begin(), fftInput.end(), fftOutput.begin());
 
-    fft.performFrequencyOnlyForwardTransform(fftOutput.data());
+    fftTables->fft.performFrequencyOnlyForwardTransform(fftOutput.data());
 
     for (size_t i = 0; i < FFTSize / 2; ++i) {
         float magnitude = fftOutput[i];
@@ -274,22 +322,39 @@ void SpectrumAnalyzer::processFFT()
 //==============================================================================
 ProbeBuffer& SpectrumAnalyzer::getActiveBuffer()
 {
-    if (probeManager.getVoiceMode() == VoiceMode::Mix &&
-        probeManager.getActiveProbe() == ProbePoint::Output) {
+    // The effects bus is only ever probed through the mix buffer
+    const auto activeProbe = probeManager.getActiveProbe();
+    if (isEffectProbePoint(activeProbe) ||
+        (probeManager.getVoiceMode() != VoiceMode::SingleVoice && activeProbe == ProbePoint::Output)) {
         return probeManager.getMixProbeBuffer();
     }
     return probeManager.getProbeBuffer();
 }
 
-void SpectrumAnalyzer::drawSpectrum(juce::Graphics& g, juce::Rectangle<float> bounds,
-                                     const std::array<float, FFTSize / 2>& magnitudes,
-                                     juce::Colour colour)
+void SpectrumAnalyzer::drawSpectrum(juce::Graphics& g, const SpectrumFrame& frame)
 {
-    float binWidth = sampleRate / FFTSize;
+    auto bounds = frame.bounds;
+    const auto& magnitudes = frame.magnitudes;
+    auto colour = frame.colour;
+    float binWidth = frame.sampleRate / FFTSize;
 
     juce::Path spectrumPath;
     bool pathStarted = false;
 
+    auto addPoint = [&](float x, float y) {
+        if (!pathStarted) {
+            spectrumPath.startNewSubPath(x, y);
+            pathStarted = true;
+        } else {
+            spectrumPath.lineTo(x, y);
+        }
+    };
+
+    // Reduced detail: one point per pixel column, at the column's peak
+    const bool reduceDetail = frame.quality.reduceDetail();
+    int column = -1;
+    float columnX = 0.0f, columnY = 0.0f;
+
     for (size_t i = 1; i < FFTSize / 2; ++i) {
         float freq = static_cast<float>(i) * binWidth;
 
@@ -299,32 +364,48 @@ void SpectrumAnalyzer::drawSpectrum(juce::Graphics& g, juce::Rectangle<float> bo
         float x = frequencyToX(freq, bounds);
         float y = magnitudeToY(magnitudes[i], bounds);
 
-        if (!pathStarted) {
-            spectrumPath.startNewSubPath(x, y);
-            pathStarted = true;
-        } else {
-            spectrumPath.lineTo(x, y);
+        if (!reduceDetail) {
+            addPoint(x, y);
+            continue;
+        }
+
+        if (static_cast<int>(x) == column) {
+            columnY = std::min(columnY, y);
+            continue;
         }
+
+        if (column >= 0)
+            addPoint(columnX, columnY);
+
+        column = static_cast<int>(x);
+        columnX = x;
+        columnY = y;
     }
 
+    if (column >= 0)
+        addPoint(columnX, columnY);
+
     if (pathStarted) {
         // Create filled version
-        juce::Path filledPath = spectrumPath;
-        filledPath.lineTo(bounds.getRight(), bounds.getBottom());
-        filledPath.lineTo(bounds.getX(), bounds.getBottom());
-        filledPath.closeSubPath();
-
-        g.setColour(colour.withAlpha(0.2f));
-        g.fillPath(filledPath);
+        if (frame.quality.fillSpectrum()) {
+            juce::Path filledPath = spectrumPath;
+            filledPath.lineTo(bounds.getRight(), bounds.getBottom());
+            filledPath.lineTo(bounds.getX(), bounds.getBottom());
+            filledPath.closeSubPath();
+
+            g.setColour(colour.withAlpha(0.2f));
+            g.fillPath(filledPath);
+        }
 
         g.setColour(colour);
-        g.strokePath(spectrumPath, juce::PathStrokeType(1.5f));
+        drawTrace(g, spectrumPath, 1.5f, frame.quality.pixelLines());
     }
 }
 
-void SpectrumAnalyzer::drawNyquistMarker(juce::Graphics& g, juce::Rectangle<float> bounds)
+void SpectrumAnalyzer::drawNyquistMarker(juce::Graphics& g, const SpectrumFrame& frame)
 {
-    float nyquist = sampleRate / 2.0f;
+    auto bounds = frame.bounds;
+    float nyquist = frame.sampleRate / 2.0f;
 
     if (nyquist <= MaxFrequency) {
         float x = frequencyToX(nyquist, bounds);
@@ -343,14 +424,14 @@ void SpectrumAnalyzer::drawNyquistMarker(juce::Graphics& g, juce::Rectangle<floa
         g.setFont(10.0f);
         g.setColour(juce::Colours::red.withAlpha(0.7f));
 
-        auto nyquistFreq = FrequencyValue::fromHz(nyquist, sampleRate);
+        auto nyquistFreq = FrequencyValue::fromHz(nyquist, frame.sampleRate);
         g.drawText("Nyquist (" + nyquistFreq.toNormalizedString() + ")",
                    static_cast<int>(x - 50), static_cast<int>(bounds.getY() + 15),
                    100, 12, juce::Justification::centred);
     }
 }
 
-float SpectrumAnalyzer::frequencyToX(float freq, juce::Rectangle<float> bounds) const
+float SpectrumAnalyzer::frequencyToX(float freq, juce::Rectangle<float> bounds)
 {
     float logMin = std::log10(MinFrequency);
     float logMax = std::log10(MaxFrequency);
@@ -360,7 +441,7 @@ float SpectrumAnalyzer::frequencyToX(float freq, juce::Rectangle<float> bounds)
     return bounds.getX() + normalized * bounds.getWidth();
 }
 
-float SpectrumAnalyzer::magnitudeToY(float dB, juce::Rectangle<float> bounds) const
+float SpectrumAnalyzer::magnitudeToY(float dB, juce::Rectangle<float> bounds)
 {
     float normalized = (dB - MinDB) / (MaxDB - MinDB);
     return bounds.getBottom() - normalized * bounds.getHeight();
@@ -379,7 +460,7 @@ void SpectrumAnalyzer::drawVoiceModeToggle(juce::Graphics& g, juce::Rectangle<fl
     mixButtonBounds = juce::Rectangle<float>(startX, startY, buttonWidth, buttonHeight);
     voiceButtonBounds = juce::Rectangle<float>(startX + buttonWidth + spacing, startY, buttonWidth, buttonHeight);
 
-    bool isMixMode = probeManager.getVoiceMode() == VoiceMode::Mix;
+    bool isMixMode = probeManager.getVoiceMode() != VoiceMode::SingleVoice;
 
     g.setColour(isMixMode ? juce::Colour(0xff4a4a4a) : juce::Colour(0xff2a2a2a));
     g.fillRoundedRectangle(mixButtonBounds, 3.0f);
@@ -393,4 +474,13 @@ void SpectrumAnalyzer::drawVoiceModeToggle(juce::Graphics& g, juce::Rectangle<fl
     g.drawText("Voice", voiceButtonBounds, juce::Justification::centred);
 }
 
+//==============================================================================
+REGISTER_PANEL("spectrum", "Spectrum Analyzer", SpectrumAnalyzer, [] {
+    PanelCapabilities caps;
+    caps.needsProbeBuffer = true;
+    caps.supportsFreezing = true;
+    caps.supportsEquations = true;
+    return caps;
+}())
+
 } // namespace vizasynth
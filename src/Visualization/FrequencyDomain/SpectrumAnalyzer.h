@@ -3,6 +3,7 @@
 #include "../Core/VisualizationPanel.h"
 #include "../ProbeBuffer.h"
 #include "../../Core/FrequencyValue.h"
+#include "FFTTables.h"
 #include <juce_dsp/juce_dsp.h>
 #include <vector>
 #include <array>
@@ -55,6 +56,21 @@ public:
      */
     float getSmoothingFactor() const { return smoothingFactor; }
 
+    //=========================================================================
+    // Analysis
+    //=========================================================================
+
+    /**
+     * Window and transform one frame, updating the magnitude and smoothed spectra.
+     * @param samples FFTSize input samples
+     */
+    void processFFT(const float* samples);
+
+    /**
+     * Get the magnitude spectrum (dB) of the most recent frame.
+     */
+    const std::array<float, FFTSize / 2>& getMagnitudeSpectrum() const { return magnitudeSpectrum; }
+
     //=========================================================================
     // Probe Color (static for use by other components)
     //=========================================================================
@@ -83,23 +99,61 @@ protected:
     //=========================================================================
 
     void timerCallback() override;
+    void showingChanged(bool isNowShowing) override;
+
+    //=========================================================================
+    // Background Rendering
+    //=========================================================================
+
+    LayerPainter createLayerPainter() override;
 
 private:
     /**
-     * Process FFT on buffered samples.
+     * Overlay and axis label ids in the label cache.
+     */
+    enum OverlayLabel {
+        ProbeLabel,
+        TitleLabel,
+        FrozenLabel,
+        VoiceLabel,
+        InfoLabel,
+        EquationLabel,
+        BinWidthLabel,
+        FrequencyAxisLabel,                 // One per frequency tick
+        DecibelAxisLabel = FrequencyAxisLabel + 4  // One per dB tick
+    };
+
+    /**
+     * Everything the spectrum layer draws, copied on the message thread so
+     * it can be painted on a render thread.
+     */
+    struct SpectrumFrame {
+        juce::Rectangle<float> bounds;
+        std::array<float, FFTSize / 2> magnitudes{};
+        juce::Colour colour;
+        float sampleRate = 44100.0f;
+        RenderQuality quality;
+    };
+
+    /**
+     * Snapshot the current (or frozen) spectrum.
+     */
+    SpectrumFrame captureFrame() const;
+
+    /**
+     * Paint the spectrum layer (Nyquist marker and spectrum).
      */
-    void processFFT();
+    static void paintFrame(juce::Graphics& g, const SpectrumFrame& frame);
 
     /**
      * Draw the spectrum path.
      */
-    void drawSpectrum(juce::Graphics& g, juce::Rectangle<float> bounds,
-                      const std::array<float, FFTSize / 2>& magnitudes, juce::Colour colour);
+    static void drawSpectrum(juce::Graphics& g, const SpectrumFrame& frame);
 
     /**
      * Draw Nyquist frequency marker.
      */
-    void drawNyquistMarker(juce::Graphics& g, juce::Rectangle<float> bounds);
+    static void drawNyquistMarker(juce::Graphics& g, const SpectrumFrame& frame);
 
     /**
      * Draw voice mode toggle buttons.
@@ -109,12 +163,12 @@ private:
     /**
      * Convert frequency to X position (logarithmic).
      */
-    float frequencyToX(float freq, juce::Rectangle<float> bounds) const;
+    static float frequencyToX(float freq, juce::Rectangle<float> bounds);
 
     /**
      * Convert magnitude (dB) to Y position.
      */
-    float magnitudeToY(float dB, juce::Rectangle<float> bounds) const;
+    static float magnitudeToY(float dB, juce::Rectangle<float> bounds);
 
     /**
      * Get the appropriate probe buffer based on voice mode.
@@ -122,10 +176,10 @@ private:
     ProbeBuffer& getActiveBuffer();
 
     ProbeManager& probeManager;
+    ProbeManager::Consumer probeConsumer{probeManager};  // Keeps the tap being read live
 
     // FFT
-    juce::dsp::FFT fft{FFTOrder};
-    juce::dsp::WindowingFunction<float> window{FFTSize, juce::dsp::WindowingFunction<float>::hann};
+    std::shared_ptr<const FFTTables> fftTables = FFTTables::get(FFTOrder);  // Shared process-wide
 
     // Buffers
     std::array<float, FFTSize> fftInput{};
@@ -1,27 +1,203 @@
 #include "ProbeBuffer.h"
+#include <cmath>
 #include <limits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+ #include <emmintrin.h>
+ #define VIZASYNTH_PROBE_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+ #include <arm_neon.h>
+ #define VIZASYNTH_PROBE_NEON 1
+#endif
 
 namespace vizasynth {
 
+namespace {
+
+template <typename T>
+void storeMax(std::atomic<T>& target, T value)
+{
+    for (T current = target.load(); value > current && !target.compare_exchange_weak(current, value);)
+    {
+    }
+}
+
+//==============================================================================
+// Int16 conversion, eight samples per step with a scalar tail
+
+void encodeInt16(const float* source, int16_t* destination, int numSamples, float multiplier)
+{
+    int i = 0;
+
+#if VIZASYNTH_PROBE_SSE2
+    const __m128 gain = _mm_set1_ps(multiplier);
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        const __m128i low = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(source + i), gain));
+        const __m128i high = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(source + i + 4), gain));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packs_epi32(low, high));
+    }
+#elif VIZASYNTH_PROBE_NEON
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        const int32x4_t low = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(source + i), multiplier));
+        const int32x4_t high = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(source + i + 4), multiplier));
+        vst1q_s16(destination + i, vcombine_s16(vqmovn_s32(low), vqmovn_s32(high)));
+    }
+#endif
+
+    for (; i < numSamples; ++i)
+        destination[i] = static_cast<int16_t>(juce::jlimit(-32768.0f, 32767.0f, std::nearbyint(source[i] * multiplier)));
+}
+
+void decodeInt16(const int16_t* source, float* destination, int numSamples, float scale)
+{
+    int i = 0;
+
+#if VIZASYNTH_PROBE_SSE2
+    const __m128 gain = _mm_set1_ps(scale);
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        const __m128i codes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(codes, codes), 16);
+        const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(codes, codes), 16);
+        _mm_storeu_ps(destination + i, _mm_mul_ps(_mm_cvtepi32_ps(low), gain));
+        _mm_storeu_ps(destination + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), gain));
+    }
+#elif VIZASYNTH_PROBE_NEON
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        const int16x8_t codes = vld1q_s16(source + i);
+        vst1q_f32(destination + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(codes))), scale));
+        vst1q_f32(destination + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(codes))), scale));
+    }
+#endif
+
+    for (; i < numSamples; ++i)
+        destination[i] = static_cast<float>(source[i]) * scale;
+}
+
+} // namespace
+
 //==============================================================================
 // ProbeBuffer Implementation
 //==============================================================================
 
 ProbeBuffer::ProbeBuffer()
 {
-    buffer.fill(0.0f);
+    allocate(DefaultCapacity);
 }
 
-void ProbeBuffer::push(const float* samples, int numSamples)
+std::unique_ptr<ProbeBuffer::Ring> ProbeBuffer::createRing(int minSamples) const
 {
-    const auto scope = fifo.write(numSamples);
+    const int capacity = juce::nextPowerOfTwo(juce::jlimit(EncodeBlockSize, MaxCapacity, minSamples));
+
+    auto newRing = std::make_unique<Ring>();
+    newRing->mask = static_cast<uint64_t>(capacity - 1);
 
-    if (scope.blockSize1 > 0)
-        std::copy(samples, samples + scope.blockSize1, buffer.begin() + scope.startIndex1);
+    // Zeroed
+    if (format == SampleFormat::Int16)
+    {
+        newRing->codes = std::make_unique<int16_t[]>(static_cast<size_t>(capacity));
+        newRing->scales = std::make_unique<float[]>(static_cast<size_t>(capacity / EncodeBlockSize));
+    }
+    else
+    {
+        newRing->storage = std::make_unique<float[]>(static_cast<size_t>(capacity));
+        newRing->samples = newRing->storage.get();
+    }
 
-    if (scope.blockSize2 > 0)
-        std::copy(samples + scope.blockSize1, samples + scope.blockSize1 + scope.blockSize2,
-                  buffer.begin() + scope.startIndex2);
+    return newRing;
+}
+
+void ProbeBuffer::allocate(int minSamples)
+{
+    const juce::SpinLock::ScopedLockType lock(readerLock);
+
+    // External rings have a fixed size and positions that readers follow
+    if (external)
+        return;
+
+    nextRing.store(nullptr);
+    rings.clear();
+    rings.push_back(createRing(minSamples));
+    ring.store(rings.back().get(), std::memory_order_release);
+    newestCapacity.store(static_cast<int>(rings.back()->mask + 1));
+
+    writePosition->store(0);
+    readPosition.store(0);
+    numPending = 0;
+}
+
+void ProbeBuffer::reserve(int minSamples)
+{
+    const juce::SpinLock::ScopedLockType lock(readerLock);
+
+    if (external || minSamples <= getCapacity())
+        return;
+
+    // The writer takes the ring over between two pushes, so every position
+    // from its firstPosition on is written to the new ring and every one
+    // before it to an old one. A ring still waiting is replaced (and kept).
+    rings.push_back(createRing(minSamples));
+    newestCapacity.store(static_cast<int>(rings.back()->mask + 1));
+    nextRing.store(rings.back().get(), std::memory_order_release);
+}
+
+ProbeBuffer::Ring* ProbeBuffer::takeNextRing()
+{
+    auto* current = ring.load(std::memory_order_relaxed);
+
+    if (nextRing.load(std::memory_order_relaxed) == nullptr)
+        return current;
+
+    if (auto* next = nextRing.exchange(nullptr, std::memory_order_acquire))
+    {
+        // Positions carry on; they only ever wrap with the mask
+        next->firstPosition = writePosition->load(std::memory_order_relaxed);
+        ring.store(next, std::memory_order_release);
+        current = next;
+    }
+
+    return current;
+}
+
+uint64_t ProbeBuffer::getReadStart(const Ring& current) const
+{
+    return std::max(readPosition.load(std::memory_order_acquire), current.firstPosition);
+}
+
+void ProbeBuffer::useExternalStorage(float* samples, int capacity, std::atomic<uint64_t>* writeIndex)
+{
+    jassert(juce::isPowerOfTwo(capacity));
+
+    const juce::SpinLock::ScopedLockType lock(readerLock);
+
+    auto externalRing = std::make_unique<Ring>();
+    externalRing->samples = samples;
+    externalRing->mask = static_cast<uint64_t>(capacity - 1);
+
+    nextRing.store(nullptr);
+    rings.clear();
+    rings.push_back(std::move(externalRing));
+    ring.store(rings.back().get(), std::memory_order_release);
+    newestCapacity.store(capacity);
+
+    writePosition = writeIndex;
+    readPosition.store(writeIndex->load());
+    external = true;
+}
+
+int ProbeBuffer::getCapacity() const
+{
+    return newestCapacity.load();
+}
+
+void ProbeBuffer::push(const float* samples, int numSamples)
+{
+    record(samples, numSamples);
+    pushUnrecorded(samples, numSamples);
 }
 
 void ProbeBuffer::push(float sample)
@@ -29,37 +205,170 @@ void ProbeBuffer::push(float sample)
     push(&sample, 1);
 }
 
+void ProbeBuffer::record(const float* samples, int numSamples)
+{
+    if (recordStage != nullptr && recordStage->isActive())
+        recordStage->write(samples, numSamples);
+}
+
+void ProbeBuffer::pushUnrecorded(const float* samples, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
+
+    if (decimated.isEnabled())
+        decimated.write(samples, numSamples);
+
+    auto* current = takeNextRing();
+
+    if (current->codes != nullptr)
+    {
+        pushEncoded(*current, samples, numSamples);
+        return;
+    }
+
+    const uint64_t capacity = current->mask + 1;
+    const uint64_t write = writePosition->load(std::memory_order_relaxed);
+
+    // A private ring drops what doesn't fit. An exported ring always takes
+    // the newest samples, so outside readers never stall on the UI.
+    uint64_t toWrite = std::min(static_cast<uint64_t>(numSamples), capacity);
+    if (external)
+        samples += static_cast<uint64_t>(numSamples) - toWrite;
+    else
+        toWrite = std::min(toWrite, capacity - std::min(write - getReadStart(*current), capacity));
+
+    const uint64_t start = write & current->mask;
+    const uint64_t first = std::min(toWrite, capacity - start);
+    std::copy(samples, samples + first, current->samples + start);
+    std::copy(samples + first, samples + toWrite, current->samples);
+
+    writePosition->store(write + toWrite, std::memory_order_release);
+}
+
+void ProbeBuffer::pushEncoded(Ring& current, const float* samples, int numSamples)
+{
+    // Positions and capacities are whole blocks, so a block never wraps
+    const uint64_t capacity = current.mask + 1;
+    uint64_t write = writePosition->load(std::memory_order_relaxed);
+    const uint64_t used = std::min(write - getReadStart(current), capacity);
+    uint64_t space = capacity - used;
+
+    while (numSamples > 0)
+    {
+        const float* block = samples;
+
+        if (numPending == 0 && numSamples >= EncodeBlockSize)
+        {
+            samples += EncodeBlockSize;
+            numSamples -= EncodeBlockSize;
+        }
+        else
+        {
+            const int count = std::min(numSamples, EncodeBlockSize - numPending);
+            std::copy(samples, samples + count, pendingBlock.data() + numPending);
+            samples += count;
+            numSamples -= count;
+            numPending += count;
+
+            if (numPending < EncodeBlockSize)
+                break;
+
+            block = pendingBlock.data();
+            numPending = 0;
+        }
+
+        // Full: drop the block
+        if (space < static_cast<uint64_t>(EncodeBlockSize))
+            continue;
+
+        const auto range = juce::FloatVectorOperations::findMinAndMax(block, EncodeBlockSize);
+        const float peak = std::max(-range.getStart(), range.getEnd());
+        const bool audible = peak > 1.0e-30f;
+
+        const uint64_t start = write & current.mask;
+        current.scales[start / EncodeBlockSize] = audible ? peak / 32767.0f : 0.0f;
+        encodeInt16(block, current.codes.get() + start, EncodeBlockSize, audible ? 32767.0f / peak : 0.0f);
+
+        write += EncodeBlockSize;
+        space -= EncodeBlockSize;
+    }
+
+    writePosition->store(write, std::memory_order_release);
+}
+
+void ProbeBuffer::readEncoded(const Ring& current, uint64_t read, uint64_t count, float* destination)
+{
+    // One run per block, each decoded with its block's scale
+    while (count > 0)
+    {
+        const uint64_t start = read & current.mask;
+        const uint64_t run = std::min(count, static_cast<uint64_t>(EncodeBlockSize) - start % EncodeBlockSize);
+
+        decodeInt16(current.codes.get() + start, destination, static_cast<int>(run),
+                    current.scales[start / EncodeBlockSize]);
+
+        read += run;
+        count -= run;
+        destination += run;
+    }
+}
+
 int ProbeBuffer::pull(float* destination, int maxSamples)
 {
-    const auto available = fifo.getNumReady();
-    const auto toPull = std::min(available, maxSamples);
+    const juce::SpinLock::ScopedLockType lock(readerLock);
 
-    if (toPull == 0)
+    // The write position first: the samples it covers are in this ring or
+    // one the writer took over later, whose positions start further on
+    const uint64_t write = writePosition->load(std::memory_order_acquire);
+    auto* current = ring.load(std::memory_order_acquire);
+    const uint64_t capacity = current->mask + 1;
+
+    // Grown ring: the reader follows from its first sample. Overrun by an
+    // exported ring: skip to the oldest sample still there.
+    uint64_t read = getReadStart(*current);
+    if (read >= write)
+    {
+        readPosition.store(read, std::memory_order_release);
         return 0;
+    }
+
+    if (write - read > capacity)
+        read = write - capacity;
 
-    const auto scope = fifo.read(toPull);
+    const uint64_t toPull = std::min(write - read, static_cast<uint64_t>(std::max(0, maxSamples)));
 
-    if (scope.blockSize1 > 0)
-        std::copy(buffer.begin() + scope.startIndex1,
-                  buffer.begin() + scope.startIndex1 + scope.blockSize1,
-                  destination);
+    if (toPull == 0)
+        return 0;
+
+    if (current->codes != nullptr)
+    {
+        readEncoded(*current, read, toPull, destination);
+        readPosition.store(read + toPull, std::memory_order_release);
+        return static_cast<int>(toPull);
+    }
 
-    if (scope.blockSize2 > 0)
-        std::copy(buffer.begin() + scope.startIndex2,
-                  buffer.begin() + scope.startIndex2 + scope.blockSize2,
-                  destination + scope.blockSize1);
+    const uint64_t start = read & current->mask;
+    const uint64_t first = std::min(toPull, capacity - start);
+    std::copy(current->samples + start, current->samples + start + first, destination);
+    std::copy(current->samples, current->samples + (toPull - first), destination + first);
 
-    return toPull;
+    readPosition.store(read + toPull, std::memory_order_release);
+    return static_cast<int>(toPull);
 }
 
 int ProbeBuffer::getAvailableSamples() const
 {
-    return fifo.getNumReady();
+    const uint64_t write = writePosition->load(std::memory_order_acquire);
+    const uint64_t read = getReadStart(*ring.load(std::memory_order_acquire));
+    const uint64_t available = write > read ? write - read : 0;
+    return static_cast<int>(std::min(available, static_cast<uint64_t>(getCapacity())));
 }
 
 void ProbeBuffer::clear()
 {
-    fifo.reset();
+    const juce::SpinLock::ScopedLockType lock(readerLock);
+    readPosition.store(writePosition->load(std::memory_order_acquire), std::memory_order_release);
 }
 
 //==============================================================================
@@ -68,14 +377,170 @@ void ProbeBuffer::clear()
 
 ProbeManager::ProbeManager()
 {
+    probeBuffer.setRecordStage(&recorder.getStage(ProbeRecorder::VoiceTap));
+    mixProbeBuffer.setRecordStage(&recorder.getStage(ProbeRecorder::MixTap));
+
+    if (juce::SystemStats::getEnvironmentVariable("VIZASYNTH_PROBE_FORMAT", {}).equalsIgnoreCase("int16"))
+        setSampleFormat(ProbeBuffer::SampleFormat::Int16);
+}
+
+void ProbeManager::prepare(double rate)
+{
+    setSampleRate(rate);
+    sharedExport.setSampleRate(rate);
+
+    const int samples = getRequiredHistorySamples(rate);
+    probeBuffer.allocate(samples);
+    mixProbeBuffer.allocate(samples);
+    voiceLanes.allocate(numVoiceLanes, rate);
+}
+
+void ProbeManager::setSampleFormat(ProbeBuffer::SampleFormat format)
+{
+    probeBuffer.setSampleFormat(format);
+    mixProbeBuffer.setSampleFormat(format);
+
+    const int samples = getRequiredHistorySamples(getSampleRate());
+    probeBuffer.allocate(samples);
+    mixProbeBuffer.allocate(samples);
+}
+
+void ProbeManager::setNumVoices(int numVoices)
+{
+    numVoiceLanes = numVoices;
+    voiceLanes.allocate(numVoiceLanes, getSampleRate());
+}
+
+void ProbeManager::requireHistory(double seconds, int minSamples)
+{
+    storeMax(requiredHistorySeconds, seconds);
+    storeMax(requiredHistorySamples, minSamples);
+
+    const int samples = getRequiredHistorySamples(getSampleRate());
+    probeBuffer.reserve(samples);
+    mixProbeBuffer.reserve(samples);
+}
+
+bool ProbeManager::enableSharedExport(const juce::String& segmentName)
+{
+    if (!sharedExport.create(segmentName, probeBuffer, mixProbeBuffer))
+        return false;
+
+    sharedExport.setSampleRate(getSampleRate());
+    sharedExport.setProbePoint(getActiveProbe());
+
+    // Outside readers can't be counted, so the export keeps both taps live
+    addConsumer(ProbeRecorder::VoiceTap);
+    addConsumer(ProbeRecorder::MixTap);
+    return true;
+}
+
+bool ProbeManager::startRecording(const juce::File& baseFile, const ProbeRecorder::Options& options)
+{
+    if (!recorder.start(baseFile, getSampleRate(), options))
+        return false;
+
+    recordingClaims = {options.voice, options.mix};
+    for (auto tap : {ProbeRecorder::VoiceTap, ProbeRecorder::MixTap})
+        if (recordingClaims[tap])
+            addConsumer(tap);
+
+    return true;
+}
+
+void ProbeManager::stopRecording()
+{
+    recorder.stop();
+
+    for (auto tap : {ProbeRecorder::VoiceTap, ProbeRecorder::MixTap})
+        if (std::exchange(recordingClaims[tap], false))
+            removeConsumer(tap);
+}
+
+//==============================================================================
+// Consumers
+//==============================================================================
+
+void ProbeManager::addConsumer(ProbeRecorder::Tap tap)
+{
+    addClaim(tap);
+}
+
+void ProbeManager::removeConsumer(ProbeRecorder::Tap tap)
+{
+    removeClaim(tap);
+}
+
+void ProbeManager::addClaim(int tap)
+{
+    const juce::SpinLock::ScopedLockType lock(consumerLock);
+
+    if (consumerCounts[static_cast<size_t>(tap)]++ == 0)
+        consumedTaps.fetch_or(1u << tap, std::memory_order_release);
+}
+
+void ProbeManager::removeClaim(int tap)
+{
+    const juce::SpinLock::ScopedLockType lock(consumerLock);
+
+    jassert(consumerCounts[static_cast<size_t>(tap)] > 0);
+    if (--consumerCounts[static_cast<size_t>(tap)] == 0)
+        consumedTaps.fetch_and(~(1u << tap), std::memory_order_release);
+}
+
+bool ProbeManager::hasConsumers(ProbeRecorder::Tap tap) const
+{
+    return (consumedTaps.load() & (1u << tap)) != 0;
+}
+
+void ProbeManager::Consumer::claim(const ProbeBuffer& buffer)
+{
+    claim(&buffer == &manager.getMixProbeBuffer() ? ProbeRecorder::MixTap : ProbeRecorder::VoiceTap);
+}
+
+void ProbeManager::Consumer::claimLanes()
+{
+    claim(LanesTap);
+}
+
+void ProbeManager::Consumer::claim(int tap)
+{
+    if (tap == claimedTap)
+        return;
+
+    release();
+    manager.addClaim(tap);
+    claimedTap = tap;
+}
+
+void ProbeManager::Consumer::release()
+{
+    if (claimedTap < 0)
+        return;
+
+    manager.removeClaim(claimedTap);
+    claimedTap = -1;
+}
+
+int ProbeManager::getRequiredHistorySamples(double rate) const
+{
+    const auto timed = static_cast<int>(std::ceil(requiredHistorySeconds.load() * rate));
+    return std::max(timed, requiredHistorySamples.load());
 }
 
 void ProbeManager::setActiveProbe(ProbePoint probe)
 {
-    if (activeProbe.load() != probe)
+    const ProbePoint previous = activeProbe.load();
+    if (previous != probe)
     {
         activeProbe.store(probe);
         probeBuffer.clear();
+
+        // The mix buffer carries the effects bus while one of its points is active
+        if (isEffectProbePoint(previous) || isEffectProbePoint(probe))
+            mixProbeBuffer.clear();
+
+        sharedExport.setProbePoint(probe);
     }
 }
 
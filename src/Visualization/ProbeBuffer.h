@@ -2,8 +2,15 @@
 
 #include <juce_audio_basics/juce_audio_basics.h>
 #include "../Core/Types.h"
+#include "../Core/DspLoadMonitor.h"
+#include "DecimatedStream.h"
+#include "ProbeRecorder.h"
+#include "SharedProbeExport.h"
+#include "VoiceLanes.h"
 #include <array>
 #include <atomic>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace vizasynth {
@@ -11,31 +18,122 @@ namespace vizasynth {
 //==============================================================================
 /**
  * Lock-free circular buffer for passing audio samples from audio thread to UI thread.
- * Uses JUCE's AbstractFifo for thread-safe index management.
+ *
+ * The ring is a power of two long so positions wrap with a mask. It is sized
+ * from a history length in time by ProbeManager, so it holds the same span
+ * at every sample rate. When full, new samples are dropped.
+ *
+ * Samples are stored as float32, or as int16 with one scale per block of
+ * EncodeBlockSize samples to halve the ring's memory traffic. Int16 rings
+ * publish whole blocks only, so the newest partial block waits for the next
+ * push.
  */
 class ProbeBuffer
 {
 public:
-    static constexpr int BufferSize = 8192;
+    static constexpr int DefaultCapacity = 8192;
+    static constexpr int MaxCapacity = 1 << 20;
+    static constexpr int EncodeBlockSize = 32;  // Samples sharing one int16 scale
+
+    enum class SampleFormat
+    {
+        Float32,
+        Int16  // Scaled per block to the block's peak
+    };
 
     ProbeBuffer();
 
+    // Storage format used from the next allocate(). Exported rings stay float32.
+    void setSampleFormat(SampleFormat newFormat) { format = newFormat; }
+    SampleFormat getSampleFormat() const { return format; }
+
+    // Size the ring for at least minSamples (rounded up to a power of two).
+    // Reallocates, so only while nothing pushes (prepareToPlay).
+    void allocate(int minSamples);
+
+    // Grow the ring while the audio thread may be pushing; never shrinks.
+    // The writer switches to the new ring at its next push, and the reader
+    // follows from the first sample written there: samples still unread in
+    // the old ring are lost. Old rings are kept alive until the next allocate().
+    void reserve(int minSamples);
+
+    int getCapacity() const;
+
+    // Put the ring in externally owned memory of a fixed power-of-two size
+    // (the shared-memory export), publishing the write position through
+    // writeIndex. The ring then overwrites instead of dropping when full.
+    // Message thread, before prepareToPlay.
+    void useExternalStorage(float* samples, int capacity, std::atomic<uint64_t>* writeIndex);
+
     // Audio thread: push samples into the buffer
     void push(const float* samples, int numSamples);
     void push(float sample);
 
+    // Audio thread: push samples that the record stage must not get (a
+    // signal standing in for the tap, e.g. an effect probe point in the mix
+    // buffer), and feed the record stage on its own
+    void pushUnrecorded(const float* samples, int numSamples);
+    void record(const float* samples, int numSamples);
+
     // UI thread: pull samples from the buffer
     int pull(float* destination, int maxSamples);
 
     // Get number of available samples to read
     int getAvailableSamples() const;
 
-    // Clear all samples (call from audio thread when switching probe points)
+    // Discard unread samples (reader side, e.g. when switching probe points)
     void clear();
 
+    // Optional min/max/RMS stream reduced from everything pushed here
+    DecimatedStream& getDecimatedStream() { return decimated; }
+
+    // Recorder staging ring that receives everything pushed here while it
+    // is active. Message thread, before anything pushes.
+    void setRecordStage(ProbeRecorder::Stage* stage) { recordStage = stage; }
+
 private:
-    juce::AbstractFifo fifo{BufferSize};
-    std::array<float, BufferSize> buffer{};
+    struct Ring
+    {
+        std::unique_ptr<float[]> storage;  // Null for external and int16 rings
+        float* samples = nullptr;
+        std::unique_ptr<int16_t[]> codes;  // Int16 rings only
+        std::unique_ptr<float[]> scales;   // One per EncodeBlockSize codes
+        uint64_t mask = 0;
+        uint64_t firstPosition = 0;        // Write position when the writer took the ring over
+    };
+
+    std::unique_ptr<Ring> createRing(int minSamples) const;
+
+    // Writer: switch to a ring handed over by reserve()
+    Ring* takeNextRing();
+
+    // Oldest position that can still be read from a ring
+    uint64_t getReadStart(const Ring& current) const;
+
+    void pushEncoded(Ring& current, const float* samples, int numSamples);
+    static void readEncoded(const Ring& current, uint64_t read, uint64_t count, float* destination);
+
+    std::atomic<Ring*> ring{nullptr};      // Stored by the writer, or by allocate() while nothing pushes
+    std::atomic<Ring*> nextRing{nullptr};  // Grown by reserve(), waiting for the writer
+    std::atomic<int> newestCapacity{0};    // Of the newest ring, current or waiting
+    std::vector<std::unique_ptr<Ring>> rings;  // Newest ring last, retired ones before it
+
+    // Positions count samples since allocation and wrap with the mask
+    std::atomic<uint64_t> ownWritePosition{0};
+    std::atomic<uint64_t>* writePosition = &ownWritePosition;
+    std::atomic<uint64_t> readPosition{0};
+    bool external = false;
+    SampleFormat format = SampleFormat::Float32;
+
+    // Writer's partial block for int16 rings
+    std::array<float, EncodeBlockSize> pendingBlock{};
+    int numPending = 0;
+
+    // Taken by the reader and when resizing; never by the audio thread
+    juce::SpinLock readerLock;
+
+    DecimatedStream decimated;
+    ProbeRecorder::Stage* recordStage = nullptr;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProbeBuffer)
 };
@@ -64,10 +162,17 @@ public:
     void setActiveVoice(int voiceIndex);
     int getActiveVoice() const;
 
-    // Voice mode (Mix vs SingleVoice)
+    // Voice mode (Mix, SingleVoice or Overlay)
     void setVoiceMode(VoiceMode mode);
     VoiceMode getVoiceMode() const;
 
+    // A lane per voice slot, filled while a consumer claims them (Overlay)
+    VoiceLanes& getVoiceLanes() { return voiceLanes; }
+
+    // Size the lanes for the synth's polyphony. Message thread, never while
+    // the audio thread may be writing (as for prepare).
+    void setNumVoices(int numVoices);
+
     // Frequency tracking (for single-cycle view)
     void setActiveFrequency(float freq) { activeFrequency.store(freq); }
     float getActiveFrequency() const { return activeFrequency.load(); }
@@ -76,6 +181,89 @@ public:
     void setSampleRate(double rate) { sampleRate.store(rate); }
     double getSampleRate() const { return sampleRate.load(); }
 
+    // Set the sample rate and size the probe rings and lanes for it (prepareToPlay)
+    void prepare(double rate);
+
+    // Store the voice and mix rings as float32 or block-scaled int16. Set from
+    // VIZASYNTH_PROBE_FORMAT=int16 at construction. Reallocates the rings, so
+    // only while nothing pushes (as for prepare).
+    void setSampleFormat(ProbeBuffer::SampleFormat format);
+    ProbeBuffer::SampleFormat getSampleFormat() const { return probeBuffer.getSampleFormat(); }
+
+    // History a consumer needs buffered between two pulls, as a duration
+    // and/or a sample count (e.g. an FFT frame). The rings grow to the
+    // largest requirement right away and are sized for it at every prepare.
+    static constexpr double DefaultHistorySeconds = 0.1;
+    void requireHistory(double seconds, int minSamples = 0);
+    int getHistoryCapacity() const { return probeBuffer.getCapacity(); }
+
+    // Mirror the probe rings into a POSIX shared-memory segment for outside
+    // readers (see SharedProbeLayout.h). Message thread, before prepare.
+    bool enableSharedExport(const juce::String& segmentName);
+    const SharedProbeExport& getSharedExport() const { return sharedExport; }
+
+    // Streams the voice tap and the mix to disk (see ProbeRecorder)
+    ProbeRecorder& getRecorder() { return recorder; }
+    const ProbeRecorder& getRecorder() const { return recorder; }
+
+    // Record through the recorder, claiming the recorded taps until stopped
+    bool startRecording(const juce::File& baseFile, const ProbeRecorder::Options& options = ProbeRecorder::Options());
+    void stopRecording();
+
+    //==========================================================================
+    // Consumers
+    //==========================================================================
+
+    /**
+     * A reader's claim on one tap (the voice tap, the mix or the per-voice
+     * lanes). While a tap has no claims the audio thread does no probe work
+     * for it, which is the usual state with the editor closed. Claims are
+     * counted, so panels, the recorder and the shared-memory export can
+     * hold them together. Message thread.
+     */
+    class Consumer
+    {
+    public:
+        explicit Consumer(ProbeManager& owner) : manager(owner) {}
+        ~Consumer() { release(); }
+
+        // Claim the tap the buffer belongs to, or the lanes, dropping any other claim
+        void claim(const ProbeBuffer& buffer);
+        void claimLanes();
+        void release();
+
+    private:
+        void claim(int tap);
+
+        ProbeManager& manager;
+        int claimedTap = -1;
+
+        JUCE_DECLARE_NON_COPYABLE(Consumer)
+    };
+
+    void addConsumer(ProbeRecorder::Tap tap);
+    void removeConsumer(ProbeRecorder::Tap tap);
+    bool hasConsumers(ProbeRecorder::Tap tap) const;
+
+    // Audio thread: read the claims once at the start of each block; the
+    // voices and the output stage then test this snapshot
+    void beginBlock() { blockTaps = consumedTaps.load(std::memory_order_acquire); }
+    bool isTapConsumed(ProbeRecorder::Tap tap) const { return (blockTaps & (1u << tap)) != 0; }
+    bool areLanesConsumed() const { return (blockTaps & (1u << LanesTap)) != 0; }
+
+    // Audio thread: after the voices have rendered, publish the lanes
+    void endBlock(int numSamples) {
+        if (areLanesConsumed())
+            voiceLanes.endBlock(numSamples);
+    }
+
+    // Audio thread: publish the block's start on the sample clock to readers
+    void setSampleClock(uint64_t sampleClock) {
+        voiceLanes.beginBlock(sampleClock);
+        if (sharedExport.isActive())
+            sharedExport.setSampleClock(sampleClock);
+    }
+
     // Frequency management for voices
     void setVoiceFrequency(int voiceIndex, float frequency);
     void clearVoiceFrequency(int voiceIndex);
@@ -84,7 +272,11 @@ public:
     // Get all active voice frequencies (for mix mode waveform generation)
     std::vector<float> getActiveFrequencies() const;
 
+    // Audio-thread stage timing, shared with the DSP load panel
+    DspLoadMonitor& getDspLoadMonitor() { return dspLoadMonitor; }
+
 private:
+    ProbeRecorder recorder;         // Declared before the rings that feed it
     ProbeBuffer probeBuffer;        // Single voice probe buffer
     ProbeBuffer mixProbeBuffer;     // Mixed output probe buffer
     std::atomic<ProbePoint> activeProbe{ProbePoint::Output};
@@ -93,10 +285,34 @@ private:
     std::atomic<float> activeFrequency{440.0f};        // For single-cycle view
     std::atomic<double> sampleRate{44100.0};
 
+    int getRequiredHistorySamples(double rate) const;
+    std::atomic<double> requiredHistorySeconds{DefaultHistorySeconds};
+    std::atomic<int> requiredHistorySamples{0};
+
     // Track frequencies for each voice (for mix mode lowest frequency calculation)
     static constexpr int MaxVoices = 8;
     std::array<std::atomic<float>, MaxVoices> voiceFrequencies{};
 
+    DspLoadMonitor dspLoadMonitor;
+
+    VoiceLanes voiceLanes;
+    int numVoiceLanes = 0;
+
+    // Claims per tap, the lanes counting as one after the recorder's taps;
+    // the mask has a bit set for each tap with any
+    static constexpr int LanesTap = ProbeRecorder::NumTaps;
+    void addClaim(int tap);
+    void removeClaim(int tap);
+
+    juce::SpinLock consumerLock;
+    std::array<int, ProbeRecorder::NumTaps + 1> consumerCounts{};
+    std::atomic<uint32_t> consumedTaps{0};
+    uint32_t blockTaps = 0;  // Audio thread's snapshot
+    std::array<bool, ProbeRecorder::NumTaps> recordingClaims{};
+
+    // Declared after the rings it backs
+    SharedProbeExport sharedExport;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProbeManager)
 };
 
@@ -0,0 +1,551 @@
+#include "ProbeRecorder.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if !JUCE_WINDOWS
+ #include <fcntl.h>
+ #include <unistd.h>
+#endif
+
+namespace vizasynth {
+
+namespace {
+
+constexpr uint64_t StagingMask = ProbeRecorder::StagingCapacity - 1;
+constexpr size_t IoAlignment = 4096;  // O_DIRECT buffer, offset and length alignment
+
+static_assert((ProbeRecorder::StagingCapacity & StagingMask) == 0, "StagingCapacity must be a power of two");
+static_assert(ProbeRecorder::BlockBytes % IoAlignment == 0 && ProbeRecorder::HeaderBytes % IoAlignment == 0,
+              "File writes must stay aligned for O_DIRECT");
+
+struct AlignedFree
+{
+    void operator()(char* block) const { std::free(block); }
+};
+
+using AlignedBlock = std::unique_ptr<char, AlignedFree>;
+
+//==============================================================================
+// File headers (little-endian, mono float32, padded to HeaderBytes)
+//==============================================================================
+
+struct HeaderWriter
+{
+    char* data;
+    size_t offset = 0;
+
+    void bytes(const void* source, size_t size)
+    {
+        std::memcpy(data + offset, source, size);
+        offset += size;
+    }
+
+    void tag(const char* fourCC) { bytes(fourCC, 4); }
+
+    void number(uint64_t value, int numBytes)
+    {
+        for (int i = 0; i < numBytes; ++i)
+            data[offset++] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+
+    // Sony Wave64 chunk GUIDs: the RIFF fourCC followed by a fixed suffix
+    void guid(const char* fourCC)
+    {
+        static constexpr unsigned char riffSuffix[12] = {0x2e, 0x91, 0xcf, 0x11, 0xa5, 0xd6,
+                                                         0x28, 0xdb, 0x04, 0xc1, 0x00, 0x00};
+        static constexpr unsigned char chunkSuffix[12] = {0xf3, 0xac, 0xd3, 0x11, 0x8c, 0xd1,
+                                                          0x00, 0xc0, 0x4f, 0x8e, 0xdb, 0x8a};
+        tag(fourCC);
+        bytes(std::strcmp(fourCC, "riff") == 0 ? riffSuffix : chunkSuffix, 12);
+    }
+
+    // WAVEFORMATEX for IEEE float mono
+    void floatFormat(uint32_t sampleRate)
+    {
+        number(3, 2);  // WAVE_FORMAT_IEEE_FLOAT
+        number(1, 2);
+        number(sampleRate, 4);
+        number(static_cast<uint64_t>(sampleRate) * sizeof(float), 4);
+        number(sizeof(float), 2);
+        number(32, 2);
+        number(0, 2);
+    }
+};
+
+void buildHeader(char* header, ProbeRecorder::Format format, double sampleRate, uint64_t dataBytes)
+{
+    constexpr size_t headerBytes = ProbeRecorder::HeaderBytes;
+
+    std::memset(header, 0, headerBytes);
+    HeaderWriter out{header};
+
+    const auto rate = static_cast<uint32_t>(std::lround(sampleRate));
+    const uint64_t fileBytes = headerBytes + dataBytes;
+
+    if (format == ProbeRecorder::Format::Wave)
+    {
+        // 32-bit sizes saturate past 4 GB; most readers then use the file length
+        const auto size32 = [](uint64_t size) { return std::min<uint64_t>(size, 0xffffffffu); };
+        constexpr size_t dataChunk = headerBytes - 8;
+
+        out.tag("RIFF");
+        out.number(size32(fileBytes - 8), 4);
+        out.tag("WAVE");
+
+        out.tag("fmt ");
+        out.number(18, 4);
+        out.floatFormat(rate);
+
+        out.tag("fact");
+        out.number(4, 4);
+        out.number(size32(dataBytes / sizeof(float)), 4);
+
+        out.tag("JUNK");
+        out.number(dataChunk - out.offset - 4, 4);
+
+        out.offset = dataChunk;
+        out.tag("data");
+        out.number(size32(dataBytes), 4);
+    }
+    else if (format == ProbeRecorder::Format::Wave64)
+    {
+        // Chunk sizes include the 24-byte chunk header; chunks are 8-byte aligned
+        constexpr size_t dataChunk = headerBytes - 24;
+
+        out.guid("riff");
+        out.number(fileBytes, 8);
+        out.guid("wave");
+
+        out.guid("fmt ");
+        out.number(24 + 18, 8);
+        out.floatFormat(rate);
+        out.offset = (out.offset + 7) & ~static_cast<size_t>(7);
+
+        const size_t junkChunk = out.offset;
+        out.guid("junk");
+        out.number(dataChunk - junkChunk, 8);
+
+        out.offset = dataChunk;
+        out.guid("data");
+        out.number(24 + dataBytes, 8);
+    }
+
+    jassert(format == ProbeRecorder::Format::RawFloat || out.offset == headerBytes);
+}
+
+#if !JUCE_WINDOWS
+bool writeFully(int fd, const char* data, size_t size, int64_t offset)
+{
+    while (size > 0)
+    {
+        const auto written = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        data += written;
+        size -= static_cast<size_t>(written);
+        offset += written;
+    }
+
+    return true;
+}
+#endif
+
+} // namespace
+
+//==============================================================================
+// Staging ring
+//==============================================================================
+
+void ProbeRecorder::Stage::write(const float* samples, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
+
+    const uint64_t write = writePosition.load(std::memory_order_relaxed);
+    const uint64_t space = StagingCapacity - (write - readPosition.load(std::memory_order_acquire));
+    const uint64_t toWrite = std::min(static_cast<uint64_t>(numSamples), space);
+
+    if (toWrite < static_cast<uint64_t>(numSamples))
+        dropped.fetch_add(static_cast<uint64_t>(numSamples) - toWrite, std::memory_order_relaxed);
+
+    const uint64_t start = write & StagingMask;
+    const uint64_t first = std::min(toWrite, StagingCapacity - start);
+    std::copy(samples, samples + first, ring.get() + start);
+    std::copy(samples + first, samples + toWrite, ring.get());
+
+    writePosition.store(write + toWrite, std::memory_order_release);
+}
+
+//==============================================================================
+// Writer thread
+//==============================================================================
+
+/**
+ * Drains the staging rings into block-sized buffers and writes each full
+ * block at the end of its tap's file. Headers are finished on exit.
+ */
+class ProbeRecorder::Writer : public juce::Thread
+{
+public:
+    Writer(ProbeRecorder& r, Format f, double rate, bool reserve)
+        : juce::Thread("Probe recorder"), recorder(r), format(f), sampleRate(rate), preallocate(reserve)
+    {
+    }
+
+    ~Writer() override
+    {
+        // Only reached with files still open if start() gave up
+        for (auto& output : outputs)
+            closeFile(output);
+    }
+
+    bool open(Tap tap, const juce::File& file, bool directIO)
+    {
+#if JUCE_WINDOWS
+        juce::ignoreUnused(tap, file, directIO);
+        return false;
+#else
+        auto& output = outputs[static_cast<size_t>(tap)];
+        const auto path = file.getFullPathName();
+        const int flags = O_WRONLY | O_CREAT | O_TRUNC;
+
+ #if JUCE_LINUX
+        // Not every file system takes O_DIRECT (tmpfs doesn't); fall back to buffered
+        if (directIO)
+        {
+            output.fd = ::open(path.toRawUTF8(), flags | O_DIRECT, 0644);
+            output.directIO = output.fd >= 0;
+        }
+ #else
+        juce::ignoreUnused(directIO);
+ #endif
+
+        if (output.fd < 0)
+            output.fd = ::open(path.toRawUTF8(), flags, 0644);
+
+        if (output.fd < 0)
+            return false;
+
+        output.block.reset(static_cast<char*>(std::aligned_alloc(IoAlignment, BlockBytes)));
+        output.stage = &recorder.getStage(tap);
+        output.recorded = &recorder.recorded[static_cast<size_t>(tap)];
+        output.dataOffset = format == Format::RawFloat ? 0 : HeaderBytes;
+
+        if (output.block == nullptr)
+            return false;
+
+        // Placeholder header; the sizes are filled in when the recording stops
+        if (format != Format::RawFloat)
+        {
+            buildHeader(output.block.get(), format, sampleRate, 0);
+            if (!writeFully(output.fd, output.block.get(), HeaderBytes, 0))
+                return false;
+        }
+
+        return true;
+#endif
+    }
+
+    void run() override
+    {
+        // Keep going without a pause while whole blocks are waiting
+        while (!threadShouldExit())
+            if (!drainAll())
+                wait(20);
+
+        drainAll();
+
+        for (auto& output : outputs)
+            finish(output);
+    }
+
+private:
+    struct Output
+    {
+        int fd = -1;
+        Stage* stage = nullptr;
+        std::atomic<uint64_t>* recorded = nullptr;
+        AlignedBlock block;
+        size_t blockFill = 0;     // Bytes
+        int64_t dataOffset = 0;   // Where the samples start
+        uint64_t dataBytes = 0;   // Written so far, in whole blocks until finish()
+        int64_t reservedEnd = 0;  // End of the fallocated region
+        bool directIO = false;
+        bool failed = false;
+    };
+
+    // Returns true if any tap wrote a block
+    bool drainAll()
+    {
+        bool wroteBlock = false;
+
+        for (auto& output : outputs)
+            if (output.fd >= 0)
+                wroteBlock = drain(output) || wroteBlock;
+
+        return wroteBlock;
+    }
+
+    bool drain(Output& output)
+    {
+        auto& stage = *output.stage;
+        const uint64_t write = stage.writePosition.load(std::memory_order_acquire);
+        uint64_t read = stage.readPosition.load(std::memory_order_relaxed);
+        bool wroteBlock = false;
+
+        if (output.failed)
+        {
+            stage.dropped.fetch_add(write - read);
+            stage.readPosition.store(write, std::memory_order_release);
+            return false;
+        }
+
+        while (read != write)
+        {
+            const uint64_t space = (BlockBytes - output.blockFill) / sizeof(float);
+            const uint64_t start = read & StagingMask;
+            const uint64_t count = std::min({write - read, space, StagingCapacity - start});
+
+            std::memcpy(output.block.get() + output.blockFill, stage.ring.get() + start, count * sizeof(float));
+            output.blockFill += count * sizeof(float);
+            read += count;
+            stage.readPosition.store(read, std::memory_order_release);
+
+            if (output.blockFill == static_cast<size_t>(BlockBytes))
+            {
+                writeBlock(output);
+                wroteBlock = true;
+            }
+        }
+
+        return wroteBlock;
+    }
+
+    void writeBlock(Output& output)
+    {
+#if !JUCE_WINDOWS
+        const int64_t offset = output.dataOffset + static_cast<int64_t>(output.dataBytes);
+        reserve(output, offset + BlockBytes);
+
+        if (writeFully(output.fd, output.block.get(), BlockBytes, offset))
+        {
+            output.dataBytes += BlockBytes;
+            output.recorded->fetch_add(BlockBytes / sizeof(float));
+        }
+        else
+        {
+            fail(output, BlockBytes / sizeof(float));
+        }
+
+        output.blockFill = 0;
+#else
+        juce::ignoreUnused(output);
+#endif
+    }
+
+    // Extend the fallocated region in large steps so the file stays contiguous
+    void reserve(Output& output, int64_t end)
+    {
+#if JUCE_LINUX
+        if (!preallocate || end <= output.reservedEnd)
+            return;
+
+        const int64_t length = std::max(PreallocateBytes, end - output.reservedEnd);
+        if (::posix_fallocate(output.fd, static_cast<off_t>(output.reservedEnd), static_cast<off_t>(length)) == 0)
+            output.reservedEnd += length;
+        else
+            preallocate = false;  // Unsupported here; plain appends still work
+#else
+        juce::ignoreUnused(output, end);
+#endif
+    }
+
+    // A failed write stops the tap; what it would have recorded counts as dropped
+    void fail(Output& output, uint64_t lostSamples)
+    {
+        output.failed = true;
+        output.stage->active.store(false, std::memory_order_release);
+        output.stage->dropped.fetch_add(lostSamples);
+        recorder.writeError.store(true);
+    }
+
+    void finish(Output& output)
+    {
+#if !JUCE_WINDOWS
+        if (output.fd < 0)
+            return;
+
+ #if JUCE_LINUX
+        // The tail and header aren't whole aligned blocks
+        if (output.directIO)
+            ::fcntl(output.fd, F_SETFL, ::fcntl(output.fd, F_GETFL) & ~O_DIRECT);
+ #endif
+
+        if (output.blockFill > 0 && !output.failed)
+        {
+            const int64_t offset = output.dataOffset + static_cast<int64_t>(output.dataBytes);
+
+            if (writeFully(output.fd, output.block.get(), output.blockFill, offset))
+            {
+                output.dataBytes += output.blockFill;
+                output.recorded->fetch_add(output.blockFill / sizeof(float));
+            }
+            else
+            {
+                fail(output, output.blockFill / sizeof(float));
+            }
+        }
+
+        // Give back the preallocated space past the last sample
+        const auto fileBytes = output.dataOffset + static_cast<int64_t>(output.dataBytes);
+        if (::ftruncate(output.fd, static_cast<off_t>(fileBytes)) != 0)
+            recorder.writeError.store(true);
+
+        if (format != Format::RawFloat)
+        {
+            buildHeader(output.block.get(), format, sampleRate, output.dataBytes);
+            if (!writeFully(output.fd, output.block.get(), HeaderBytes, 0))
+                recorder.writeError.store(true);
+        }
+
+        closeFile(output);
+#else
+        juce::ignoreUnused(output);
+#endif
+    }
+
+    static void closeFile(Output& output)
+    {
+#if !JUCE_WINDOWS
+        if (output.fd >= 0)
+            ::close(output.fd);
+#endif
+        output.fd = -1;
+    }
+
+    ProbeRecorder& recorder;
+    const Format format;
+    const double sampleRate;
+    bool preallocate;
+    std::array<Output, NumTaps> outputs;
+};
+
+//==============================================================================
+// ProbeRecorder
+//==============================================================================
+
+ProbeRecorder::ProbeRecorder() = default;
+
+ProbeRecorder::~ProbeRecorder()
+{
+    stop();
+}
+
+bool ProbeRecorder::start(const juce::File& baseFile, double sampleRate, const Options& options)
+{
+#if JUCE_WINDOWS
+    juce::ignoreUnused(baseFile, sampleRate, options);
+    return false;
+#else
+    if (writer != nullptr || !(options.voice || options.mix))
+        return false;
+
+    baseFile.getParentDirectory().createDirectory();
+
+    auto newWriter = std::make_unique<Writer>(*this, options.format, sampleRate, options.preallocate);
+    const std::array<bool, NumTaps> wanted{options.voice, options.mix};
+
+    for (size_t t = 0; t < NumTaps; ++t)
+    {
+        if (!wanted[t])
+            continue;
+
+        files[t] = getTapFile(baseFile, static_cast<Tap>(t), options.format);
+
+        if (!newWriter->open(static_cast<Tap>(t), files[t], options.directIO))
+            return false;
+    }
+
+    // Staging rings are allocated once and never freed, so a push that raced
+    // the active flag can never write into released memory
+    for (size_t t = 0; t < NumTaps; ++t)
+    {
+        auto& stage = stages[t];
+
+        if (stage.ring == nullptr)
+            stage.ring = std::make_unique<float[]>(StagingCapacity);  // Zeroed, so the pages are mapped
+
+        stage.readPosition.store(stage.writePosition.load());
+        stage.dropped.store(0);
+        recorded[t].store(0);
+    }
+
+    writeError.store(false);
+    writer = std::move(newWriter);
+
+    for (size_t t = 0; t < NumTaps; ++t)
+        stages[t].active.store(wanted[t], std::memory_order_release);
+
+    writer->startThread();
+    return true;
+#endif
+}
+
+void ProbeRecorder::stop()
+{
+    if (writer == nullptr)
+        return;
+
+    for (auto& stage : stages)
+        stage.active.store(false, std::memory_order_release);
+
+    // Never time out: the writer must finish the headers and close the files
+    writer->signalThreadShouldExit();
+    writer->notify();
+    writer->waitForThreadToExit(-1);
+    writer.reset();
+}
+
+uint64_t ProbeRecorder::getDroppedSamples() const
+{
+    uint64_t total = 0;
+    for (const auto& stage : stages)
+        total += stage.dropped.load();
+    return total;
+}
+
+juce::String ProbeRecorder::getFileExtension(Format format)
+{
+    switch (format)
+    {
+        case Format::Wave:     return ".wav";
+        case Format::Wave64:   return ".w64";
+        case Format::RawFloat: return ".f32";
+    }
+
+    return {};
+}
+
+juce::File ProbeRecorder::getTapFile(const juce::File& baseFile, Tap tap, Format format)
+{
+    const char* suffix = tap == VoiceTap ? "-voice" : "-mix";
+    return baseFile.getSiblingFile(baseFile.getFileName() + suffix + getFileExtension(format));
+}
+
+juce::File ProbeRecorder::createDefaultCaptureFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+        .getChildFile("VizASynth Captures")
+        .getChildFile("capture-" + juce::Time::getCurrentTime().formatted("%Y-%m-%d_%H-%M-%S"));
+}
+
+} // namespace vizasynth
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace vizasynth {
+
+/**
+ * ProbeRecorder - Streams probe taps to disk for long captures
+ *
+ * The audio thread's only part in a recording is a copy into a staging ring
+ * (one per tap) as it pushes to the probe buffers. A background writer
+ * thread drains the rings into 1 MiB blocks and writes each tap's file
+ * sequentially, one whole block at a time. On Linux the file is reserved
+ * with fallocate ahead of the writer, and O_DIRECT can bypass the page
+ * cache. An hour of a 48 kHz tap is about 690 MB.
+ *
+ * If the disk falls behind for longer than a staging ring holds (about 45 s
+ * at 44.1 kHz), new samples are dropped and counted; the file simply skips
+ * them. The voice tap records the selected probe point of the active voice
+ * while it sounds, so its file is the concatenation of those stretches. The
+ * mix tap always records the output, even while the mix probe shows one of
+ * the effects.
+ *
+ * WAV and W64 files are mono float32 with the header padded to 4096 bytes,
+ * so the samples start at a fixed, page-aligned offset and the file can be
+ * memory-mapped as a float array. Raw files are bare float32 samples.
+ * Unavailable on Windows (start() returns false).
+ */
+class ProbeRecorder
+{
+public:
+    enum class Format { Wave, Wave64, RawFloat };
+
+    enum Tap
+    {
+        VoiceTap,
+        MixTap,
+        NumTaps
+    };
+
+    static constexpr int StagingCapacity = 1 << 21;     // Samples per tap; a power of two
+    static constexpr int BlockBytes = 1 << 20;           // Size of each file write
+    static constexpr int HeaderBytes = 4096;             // WAV/W64 header, padded
+    static constexpr int64_t PreallocateBytes = 1 << 26; // Reserved ahead of the writer
+
+    struct Options
+    {
+        Format format = Format::Wave64;
+        bool voice = true;          // Record the voice tap
+        bool mix = true;            // Record the mix
+        bool preallocate = true;    // fallocate ahead of the writer (Linux)
+        bool directIO = false;      // O_DIRECT, where the file system allows it (Linux)
+    };
+
+    /**
+     * Staging ring between the audio thread and the writer for one tap.
+     * ProbeBuffer writes everything it is pushed into its stage while the
+     * stage is active.
+     */
+    class Stage
+    {
+    public:
+        Stage() = default;
+
+        bool isActive() const { return active.load(std::memory_order_acquire); }
+
+        // Audio thread: copy samples in, dropping what doesn't fit
+        void write(const float* samples, int numSamples);
+
+    private:
+        friend class ProbeRecorder;
+
+        std::unique_ptr<float[]> ring;  // Allocated once, never freed before the recorder
+        std::atomic<uint64_t> writePosition{0};
+        std::atomic<uint64_t> readPosition{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<bool> active{false};
+
+        JUCE_DECLARE_NON_COPYABLE(Stage)
+    };
+
+    ProbeRecorder();
+    ~ProbeRecorder();
+
+    Stage& getStage(Tap tap) { return stages[static_cast<size_t>(tap)]; }
+
+    //==========================================================================
+    // Capture control (message thread)
+    //==========================================================================
+
+    /**
+     * Start recording the chosen taps. Each tap goes to its own file named
+     * after baseFile plus "-voice" or "-mix" and the format's extension.
+     * @return false if a recording is running or no file could be created
+     */
+    bool start(const juce::File& baseFile, double sampleRate, const Options& options);
+    bool start(const juce::File& baseFile, double sampleRate) { return start(baseFile, sampleRate, Options()); }
+
+    /**
+     * Stop recording, write out what is staged and finish the file headers.
+     */
+    void stop();
+
+    bool isRecording() const { return writer != nullptr; }
+    bool isRecording(Tap tap) const { return stages[static_cast<size_t>(tap)].isActive(); }
+
+    // File of the current or most recent recording of a tap
+    juce::File getFile(Tap tap) const { return files[static_cast<size_t>(tap)]; }
+
+    //==========================================================================
+    // Statistics (any thread)
+    //==========================================================================
+
+    uint64_t getRecordedSamples(Tap tap) const { return recorded[static_cast<size_t>(tap)].load(); }
+
+    // Samples lost because the staging ring was full or a write failed
+    uint64_t getDroppedSamples(Tap tap) const { return stages[static_cast<size_t>(tap)].dropped.load(); }
+    uint64_t getDroppedSamples() const;
+
+    // A file write failed; that tap has stopped recording
+    bool hasWriteError() const { return writeError.load(); }
+
+    static juce::String getFileExtension(Format format);
+
+    // File a tap of the capture named baseFile is recorded to
+    static juce::File getTapFile(const juce::File& baseFile, Tap tap, Format format);
+
+    /**
+     * Timestamped base name in ~/Documents/VizASynth Captures.
+     */
+    static juce::File createDefaultCaptureFile();
+
+private:
+    class Writer;
+
+    std::array<Stage, NumTaps> stages;
+    std::array<std::atomic<uint64_t>, NumTaps> recorded{};
+    std::array<juce::File, NumTaps> files;
+    std::atomic<bool> writeError{false};
+    std::unique_ptr<Writer> writer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProbeRecorder)
+};
+
+} // namespace vizasynth
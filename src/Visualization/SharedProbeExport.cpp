@@ -0,0 +1,142 @@
+#include "SharedProbeExport.h"
+#include "ProbeBuffer.h"
+#include <atomic>
+#include <cstring>
+
+#if !JUCE_WINDOWS
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <unistd.h>
+#endif
+
+namespace vizasynth {
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t) && std::atomic<uint64_t>::is_always_lock_free,
+              "Shared probe indices must be plain lock-free 64-bit words");
+static_assert(sizeof(std::atomic<double>) == sizeof(double) && std::atomic<double>::is_always_lock_free,
+              "Shared probe sample rate must be a plain lock-free double");
+
+namespace {
+
+constexpr size_t SegmentAlignment = 64;
+
+constexpr size_t alignUp(size_t value)
+{
+    return (value + SegmentAlignment - 1) & ~(SegmentAlignment - 1);
+}
+
+void initialiseChannel(vz_probe_channel& channel, const char* name, size_t dataOffset, int32_t probePoint)
+{
+    std::strncpy(channel.name, name, sizeof(channel.name) - 1);
+    channel.capacity = static_cast<uint32_t>(SharedProbeExport::RingCapacity);
+    channel.data_offset = static_cast<uint32_t>(dataOffset);
+    channel.write_index.store(0);
+    channel.probe_point.store(probePoint);
+}
+
+} // namespace
+
+//=============================================================================
+// Lifetime
+//=============================================================================
+
+SharedProbeExport::~SharedProbeExport()
+{
+    destroy();
+}
+
+bool SharedProbeExport::create(const juce::String& baseName, ProbeBuffer& voiceRing, ProbeBuffer& mixRing)
+{
+#if JUCE_WINDOWS
+    juce::ignoreUnused(baseName, voiceRing, mixRing);
+    return false;
+#else
+    destroy();
+
+    // POSIX names are a single leading slash and no others. The suffix keeps
+    // instances in one process, and in different processes, apart.
+    static std::atomic<int> instanceCounter{0};
+    const auto prefix = baseName.startsWithChar('/') ? baseName : "/" + baseName;
+    const auto name = prefix + "-" + juce::String(static_cast<int>(getpid())) + "-" + juce::String(++instanceCounter);
+
+    const size_t ringBytes = static_cast<size_t>(RingCapacity) * sizeof(float);
+    const size_t voiceOffset = alignUp(sizeof(vz_probe_header));
+    const size_t mixOffset = voiceOffset + alignUp(ringBytes);
+    const size_t size = mixOffset + alignUp(ringBytes);
+
+    // Never take over an existing segment: it belongs to another exporter
+    const int fd = shm_open(name.toRawUTF8(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+        return false;
+
+    segmentName = name;
+
+    void* mapped = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+        mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    close(fd);
+
+    if (mapped == MAP_FAILED) {
+        shm_unlink(segmentName.toRawUTF8());
+        return false;
+    }
+
+    // ftruncate zero-fills, so the header starts with no magic
+    header = static_cast<vz_probe_header*>(mapped);
+    segmentSize = size;
+
+    header->version = VZ_PROBE_VERSION;
+    header->header_size = static_cast<uint16_t>(sizeof(vz_probe_header));
+    header->sample_format = VZ_PROBE_FORMAT_FLOAT32;
+    header->num_channels = 2;
+    header->sample_rate.store(0.0);
+    header->sample_clock.store(0);
+    initialiseChannel(header->channels[0], VZ_PROBE_CHANNEL_VOICE, voiceOffset, static_cast<int32_t>(ProbePoint::Output));
+    initialiseChannel(header->channels[1], VZ_PROBE_CHANNEL_MIX, mixOffset, static_cast<int32_t>(ProbePoint::Output));
+
+    auto* base = static_cast<char*>(mapped);
+    voiceRing.useExternalStorage(reinterpret_cast<float*>(base + voiceOffset), RingCapacity, &header->channels[0].write_index);
+    mixRing.useExternalStorage(reinterpret_cast<float*>(base + mixOffset), RingCapacity, &header->channels[1].write_index);
+
+    // Readers treat the segment as valid once the magic is visible
+    header->magic.store(VZ_PROBE_MAGIC, std::memory_order_release);
+    return true;
+#endif
+}
+
+void SharedProbeExport::destroy()
+{
+#if !JUCE_WINDOWS
+    if (header == nullptr)
+        return;
+
+    munmap(header, segmentSize);
+    shm_unlink(segmentName.toRawUTF8());
+    header = nullptr;
+    segmentSize = 0;
+#endif
+}
+
+//=============================================================================
+// Header updates
+//=============================================================================
+
+void SharedProbeExport::setSampleRate(double rate)
+{
+    if (header != nullptr)
+        header->sample_rate.store(rate, std::memory_order_release);
+}
+
+void SharedProbeExport::setProbePoint(ProbePoint probe)
+{
+    if (header == nullptr)
+        return;
+
+    // The mix channel follows the effects bus probe points and is the output otherwise
+    header->channels[0].probe_point.store(static_cast<int32_t>(probe), std::memory_order_release);
+    header->channels[1].probe_point.store(static_cast<int32_t>(isEffectProbePoint(probe) ? probe : ProbePoint::Output),
+                                          std::memory_order_release);
+}
+
+} // namespace vizasynth
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "SharedProbeLayout.h"
+#include "../Core/Types.h"
+
+namespace vizasynth {
+
+class ProbeBuffer;
+
+/**
+ * SharedProbeExport - Probe rings in a POSIX shared-memory segment
+ *
+ * Creates the segment described in SharedProbeLayout.h and hands each ring's
+ * slot to its ProbeBuffer as external storage, so the audio thread's normal
+ * ring write is the export. The segment is unlinked when the export is
+ * destroyed; readers that still have it mapped keep their view.
+ *
+ * Every export gets a segment of its own, named after the requested base
+ * name, the process ID and a per-process instance number
+ * ("/vizasynth-probes-<pid>-<n>"), so several synth instances can export at
+ * once. An existing segment is never replaced. Unavailable on Windows
+ * (create() returns false).
+ */
+class SharedProbeExport
+{
+public:
+    static constexpr int RingCapacity = 1 << 18;  // Samples per channel (~6 s at 44.1 kHz)
+
+    SharedProbeExport() = default;
+    ~SharedProbeExport();
+
+    /**
+     * Create this instance's segment and move the rings into it. Fails if a
+     * segment of that name already exists. Message thread, before prepareToPlay.
+     * @param baseName Segment name without the instance suffix
+     */
+    bool create(const juce::String& baseName, ProbeBuffer& voiceRing, ProbeBuffer& mixRing);
+
+    bool isActive() const { return header != nullptr; }
+    const juce::String& getName() const { return segmentName; }
+
+    void setSampleRate(double rate);
+    void setProbePoint(ProbePoint probe);
+
+    // Audio thread, once per block
+    void setSampleClock(uint64_t sampleClock) {
+        header->sample_clock.store(sampleClock, std::memory_order_release);
+    }
+
+private:
+    void destroy();
+
+    juce::String segmentName;
+    vz_probe_header* header = nullptr;
+    size_t segmentSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharedProbeExport)
+};
+
+} // namespace vizasynth
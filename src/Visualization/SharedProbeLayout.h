@@ -0,0 +1,216 @@
+/*
+ * SharedProbeLayout.h - Shared-memory probe export: segment layout and C reader API
+ *
+ * With the VIZASYNTH_PROBE_SHM environment variable set (e.g.
+ * "/vizasynth-probes"), each synth instance places its probe rings in a
+ * POSIX shared-memory segment named after it, with the process ID and an
+ * instance number appended ("/vizasynth-probes-<pid>-<n>"; the synth logs
+ * the name). The audio thread writes samples
+ * straight into the segment; nothing is copied on its behalf. Other
+ * processes map it read-only and follow the write indices.
+ *
+ * Segment layout (native byte order):
+ *
+ *   vz_probe_header   at offset 0
+ *   float32 rings     at channels[i].data_offset, channels[i].capacity samples each
+ *
+ * Each ring holds the newest `capacity` samples of its tap. The sample with
+ * running index n lives at ring[n & (capacity - 1)]. write_index is the
+ * number of samples written so far. The writer stores it with release
+ * ordering after the samples, so a reader that loads it with acquire
+ * ordering may read every sample below it. Samples older than
+ * write_index - capacity have been overwritten; a reader that falls that
+ * far behind must skip ahead. A reader should check write_index again after
+ * copying, to catch samples overwritten while it copied.
+ *
+ * This header is plain C99 (plus GCC/Clang atomic builtins) so analysis
+ * tools can include it without the rest of the synth.
+ */
+
+#ifndef VIZASYNTH_SHARED_PROBE_LAYOUT_H
+#define VIZASYNTH_SHARED_PROBE_LAYOUT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+  #include <atomic>
+  #define VZ_PROBE_ATOMIC(type) std::atomic<type>
+#else
+  #define VZ_PROBE_ATOMIC(type) type
+#endif
+
+#define VZ_PROBE_MAGIC          0x525A5056u  /* "VPZR" */
+#define VZ_PROBE_VERSION        1u
+#define VZ_PROBE_FORMAT_FLOAT32 1u
+#define VZ_PROBE_MAX_CHANNELS   4
+
+/* Channel names */
+#define VZ_PROBE_CHANNEL_VOICE  "voice"  /* Active voice at the selected probe point */
+#define VZ_PROBE_CHANNEL_MIX    "mix"    /* Sum of all voices at the output, or after an effect */
+
+typedef struct vz_probe_channel
+{
+    char     name[16];                        /* NUL-terminated */
+    uint32_t capacity;                        /* Ring length in samples, a power of two */
+    uint32_t data_offset;                     /* Byte offset of the ring in the segment */
+    VZ_PROBE_ATOMIC(uint64_t) write_index;    /* Samples written so far (release-stored) */
+    VZ_PROBE_ATOMIC(int32_t) probe_point;     /* Tap: 0 osc, 1 filter, 2 envelope, 3 output, 4 mix,
+                                                 5 chorus, 6 delay, 7 reverb */
+    uint32_t reserved;
+} vz_probe_channel;
+
+typedef struct vz_probe_header
+{
+    VZ_PROBE_ATOMIC(uint32_t) magic;          /* VZ_PROBE_MAGIC once the segment is initialised */
+    uint16_t version;                         /* VZ_PROBE_VERSION */
+    uint16_t header_size;                     /* sizeof(vz_probe_header) */
+    uint32_t sample_format;                   /* VZ_PROBE_FORMAT_FLOAT32 */
+    uint32_t num_channels;
+    VZ_PROBE_ATOMIC(double) sample_rate;      /* Updated when playback is prepared */
+    VZ_PROBE_ATOMIC(uint64_t) sample_clock;   /* Synth sample clock at the latest block start */
+    vz_probe_channel channels[VZ_PROBE_MAX_CHANNELS];
+} vz_probe_header;
+
+#undef VZ_PROBE_ATOMIC
+
+/*============================================================================
+ * Reader API (POSIX, C only; the synth itself uses SharedProbeExport)
+ *============================================================================*/
+
+#if !defined(__cplusplus) && !defined(_WIN32)
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+typedef struct vz_probe_reader
+{
+    const vz_probe_header* header;
+    size_t size;
+} vz_probe_reader;
+
+/* Map a segment read-only. Returns 0 on success, -1 if it is missing or not a probe export. */
+static inline int vz_probe_open(vz_probe_reader* reader, const char* name)
+{
+    struct stat info;
+    void* mapped;
+    int fd = shm_open(name, O_RDONLY, 0);
+
+    reader->header = NULL;
+    reader->size = 0;
+
+    if (fd < 0)
+        return -1;
+
+    if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(vz_probe_header)) {
+        close(fd);
+        return -1;
+    }
+
+    mapped = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapped == MAP_FAILED)
+        return -1;
+
+    reader->header = (const vz_probe_header*) mapped;
+    reader->size = (size_t) info.st_size;
+
+    if (__atomic_load_n(&reader->header->magic, __ATOMIC_ACQUIRE) != VZ_PROBE_MAGIC
+        || reader->header->version != VZ_PROBE_VERSION) {
+        munmap(mapped, reader->size);
+        reader->header = NULL;
+        return -1;
+    }
+
+    return 0;
+}
+
+static inline void vz_probe_close(vz_probe_reader* reader)
+{
+    if (reader->header != NULL)
+        munmap((void*) reader->header, reader->size);
+
+    reader->header = NULL;
+}
+
+/* Index of a channel by name, or -1. */
+static inline int vz_probe_find_channel(const vz_probe_reader* reader, const char* name)
+{
+    uint32_t i;
+    for (i = 0; i < reader->header->num_channels && i < VZ_PROBE_MAX_CHANNELS; ++i)
+        if (strncmp(reader->header->channels[i].name, name, sizeof(reader->header->channels[i].name)) == 0)
+            return (int) i;
+
+    return -1;
+}
+
+static inline uint64_t vz_probe_write_index(const vz_probe_reader* reader, int channel)
+{
+    return __atomic_load_n(&reader->header->channels[channel].write_index, __ATOMIC_ACQUIRE);
+}
+
+static inline double vz_probe_sample_rate(const vz_probe_reader* reader)
+{
+    double rate;
+    __atomic_load(&reader->header->sample_rate, &rate, __ATOMIC_ACQUIRE);
+    return rate;
+}
+
+/*
+ * Copy up to max_samples samples from *cursor onwards and advance the cursor.
+ * Returns the number copied. If the cursor had fallen out of the ring, it
+ * first jumps to the oldest sample still held, and *dropped (if not NULL)
+ * receives how many were skipped.
+ */
+static inline size_t vz_probe_read(const vz_probe_reader* reader, int channel, uint64_t* cursor,
+                                   float* destination, size_t max_samples, uint64_t* dropped)
+{
+    const vz_probe_channel* ch = &reader->header->channels[channel];
+    const float* ring = (const float*) ((const char*) reader->header + ch->data_offset);
+    const uint64_t mask = (uint64_t) ch->capacity - 1;
+    uint64_t write = vz_probe_write_index(reader, channel);
+    uint64_t skipped = 0;
+    size_t count, i;
+
+    if (write - *cursor > ch->capacity) {
+        skipped = write - ch->capacity - *cursor;
+        *cursor = write - ch->capacity;
+    }
+
+    count = (size_t) (write - *cursor);
+    if (count > max_samples)
+        count = max_samples;
+
+    for (i = 0; i < count; ++i)
+        destination[i] = ring[(*cursor + i) & mask];
+
+    /* Anything the writer lapped while we copied is unreliable: drop it */
+    write = vz_probe_write_index(reader, channel);
+    if (write - *cursor > ch->capacity) {
+        const uint64_t torn = write - ch->capacity - *cursor;
+        if (torn >= count) {
+            skipped += torn;
+            *cursor = write - ch->capacity;
+            count = 0;
+        } else {
+            memmove(destination, destination + torn, (count - torn) * sizeof(float));
+            skipped += torn;
+            *cursor += torn;
+            count -= (size_t) torn;
+        }
+    }
+
+    *cursor += count;
+
+    if (dropped != NULL)
+        *dropped = skipped;
+
+    return count;
+}
+
+#endif /* !__cplusplus && !_WIN32 */
+
+#endif /* VIZASYNTH_SHARED_PROBE_LAYOUT_H */
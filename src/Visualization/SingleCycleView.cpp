@@ -1,5 +1,6 @@
 #include "SingleCycleView.h"
 #include "../Core/Configuration.h"
+#include "../Core/TraceRecorder.h"
 #include <cmath>
 
 namespace vizasynth {
@@ -12,10 +13,8 @@ SingleCycleView::SingleCycleView(ProbeManager& pm, PolyBLEPOscillator& osc)
     waveformCycle.resize(SamplesPerCycle);
     frozenCycle.resize(SamplesPerCycle);
 
-    // Generate initial waveform
+    // Generate initial waveform; the timer starts once the view is showing
     generateWaveformCycle();
-
-    startTimerHz(RefreshRateHz);
 }
 
 SingleCycleView::~SingleCycleView()
@@ -26,6 +25,7 @@ SingleCycleView::~SingleCycleView()
 //==============================================================================
 void SingleCycleView::paint(juce::Graphics& g)
 {
+    VIZASYNTH_TRACE_SCOPE("paint", "singleCycle");
     auto& config = ConfigurationManager::getInstance();
     auto bounds = getLocalBounds().toFloat().reduced(2.0f);
 
@@ -70,6 +70,9 @@ void SingleCycleView::paint(juce::Graphics& g)
         case ProbePoint::PostEnvelope: probeText = "ENV"; break;
         case ProbePoint::Output:       probeText = "OUT"; break;
         case ProbePoint::Mix:          probeText = "MIX"; break;
+        case ProbePoint::Chorus:       probeText = "CHO"; break;
+        case ProbePoint::Delay:        probeText = "DLY"; break;
+        case ProbePoint::Reverb:       probeText = "REV"; break;
     }
 
     g.drawText(probeText, static_cast<int>(bounds.getRight() - 50),
@@ -89,7 +92,7 @@ void SingleCycleView::paint(juce::Graphics& g)
 
     // Show voice count in Mix mode
     juce::String modeInfo;
-    if (probeManager.getVoiceMode() == VoiceMode::Mix)
+    if (probeManager.getVoiceMode() != VoiceMode::SingleVoice)
     {
         auto frequencies = probeManager.getActiveFrequencies();
         if (frequencies.size() > 1)
@@ -145,13 +148,36 @@ juce::Colour SingleCycleView::getProbeColour(ProbePoint probe)
         case ProbePoint::PostEnvelope: return config.getProbeColour("envelope");
         case ProbePoint::Output:       return config.getProbeColour("output");
         case ProbePoint::Mix:          return config.getProbeColour("mix");
+        case ProbePoint::Chorus:       return config.getProbeColour("chorus");
+        case ProbePoint::Delay:        return config.getProbeColour("delay");
+        case ProbePoint::Reverb:       return config.getProbeColour("reverb");
     }
     return config.getTextColour();
 }
 
 //==============================================================================
+void SingleCycleView::visibilityChanged()
+{
+    updateTimer();
+}
+
+void SingleCycleView::parentHierarchyChanged()
+{
+    updateTimer();
+}
+
+void SingleCycleView::updateTimer()
+{
+    // Hidden outside Scope mode, and with the editor closed
+    if (!isShowing())
+        stopTimer();
+    else if (!isTimerRunning())
+        startTimerHz(RefreshRateHz);
+}
+
 void SingleCycleView::timerCallback()
 {
+    VIZASYNTH_TRACE_SCOPE("timer", "SingleCycleView::timerCallback");
     if (frozen)
         return;
 
@@ -196,7 +222,7 @@ float SingleCycleView::generateSampleForWaveform(double phase) const
 void SingleCycleView::generateWaveformCycle()
 {
     // Check if we're in Mix mode with multiple active voices
-    if (probeManager.getVoiceMode() == VoiceMode::Mix)
+    if (probeManager.getVoiceMode() != VoiceMode::SingleVoice)
     {
         auto frequencies = probeManager.getActiveFrequencies();
 
@@ -334,7 +360,7 @@ void SingleCycleView::drawVoiceModeToggle(juce::Graphics& g, juce::Rectangle<flo
     mixButtonBounds = juce::Rectangle<float>(startX, startY, buttonWidth, buttonHeight);
     voiceButtonBounds = juce::Rectangle<float>(startX + buttonWidth + spacing, startY, buttonWidth, buttonHeight);
 
-    bool isMixMode = probeManager.getVoiceMode() == VoiceMode::Mix;
+    bool isMixMode = probeManager.getVoiceMode() != VoiceMode::SingleVoice;
 
     auto activeButtonColour = config.getGridMajorColour();
     auto inactiveButtonColour = config.getGridColour();
@@ -24,6 +24,8 @@ public:
     void paint(juce::Graphics& g) override;
     void resized() override;
     void mouseDown(const juce::MouseEvent& event) override;
+    void visibilityChanged() override;
+    void parentHierarchyChanged() override;
 
     // Freeze functionality
     void setFrozen(bool frozen);
@@ -39,6 +41,9 @@ public:
 private:
     void timerCallback() override;
 
+    // Run the refresh timer only while the view is on screen
+    void updateTimer();
+
     // Generate one cycle of the current waveform mathematically
     void generateWaveformCycle();
 
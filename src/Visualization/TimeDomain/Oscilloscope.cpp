@@ -1,5 +1,7 @@
 #include "Oscilloscope.h"
 #include "../../Core/Configuration.h"
+#include "../../Core/TraceRecorder.h"
+#include "../Core/PanelRegistry.h"
 
 namespace vizasynth {
 
@@ -12,6 +14,14 @@ Oscilloscope::Oscilloscope(ProbeManager& pm)
 
     // Get sample rate from probe manager
     sampleRate = static_cast<float>(probeManager.getSampleRate());
+
+    // The display keeps up to twice the longest (100 ms) time window
+    probeManager.requireHistory(0.2);
+}
+
+Oscilloscope::~Oscilloscope()
+{
+    stopRoll();
 }
 
 //==============================================================================
@@ -20,19 +30,24 @@ void Oscilloscope::setFrozen(bool freeze)
     if (freeze && !frozen) {
         // Capture current display to frozen buffer
         frozenBuffer = displayBuffer;
+        frozenRoll = rollBuffer;
+        frozenOverlay = overlayTraces;
     }
     frozen = freeze;
+    refreshDisplay();
 }
 
 void Oscilloscope::clearTrace()
 {
     frozenBuffer.clear();
-    repaint();
+    frozenRoll.clear();
+    frozenOverlay.clear();
+    refreshDisplay();
 }
 
 void Oscilloscope::setTimeWindow(float milliseconds)
 {
-    timeWindowMs = juce::jlimit(1.0f, 100.0f, milliseconds);
+    timeWindowMs = juce::jlimit(1.0f, MaxRollWindowMs, milliseconds);
 }
 
 juce::Colour Oscilloscope::getProbeColour(ProbePoint probe)
@@ -43,10 +58,27 @@ juce::Colour Oscilloscope::getProbeColour(ProbePoint probe)
         case ProbePoint::PostEnvelope: return juce::Colour(0xff4caf50);  // Green
         case ProbePoint::Output:       return juce::Colour(0xff00e5ff);  // Cyan
         case ProbePoint::Mix:          return juce::Colour(0xffffffff);  // White
+        case ProbePoint::Chorus:       return juce::Colour(0xffff4081);  // Pink
+        case ProbePoint::Delay:        return juce::Colour(0xffffd54f);  // Amber
+        case ProbePoint::Reverb:       return juce::Colour(0xff448aff);  // Blue
     }
     return juce::Colours::white;
 }
 
+juce::Colour Oscilloscope::getVoiceColour(int voiceIndex)
+{
+    // Golden-ratio steps round the hue circle keep neighbouring slots apart at any polyphony
+    const float hue = std::fmod(0.52f + static_cast<float>(voiceIndex) * 0.618034f, 1.0f);
+    return juce::Colour::fromHSV(hue, 0.65f, 1.0f, 0.85f);
+}
+
+bool Oscilloscope::isOverlayMode() const
+{
+    // The effects bus has no per-voice signal to overlay
+    return probeManager.getVoiceMode() == VoiceMode::Overlay && !isRollMode()
+           && !isEffectProbePoint(probeManager.getActiveProbe());
+}
+
 //==============================================================================
 void Oscilloscope::renderBackground(juce::Graphics& g)
 {
@@ -79,23 +111,69 @@ void Oscilloscope::renderBackground(juce::Graphics& g)
 
 void Oscilloscope::renderVisualization(juce::Graphics& g)
 {
-    auto bounds = getVisualizationBounds();
-    auto probeColour = getProbeColour(probeManager.getActiveProbe());
+    paintFrame(g, captureFrame());
+}
+
+VisualizationPanel::LayerPainter Oscilloscope::createLayerPainter()
+{
+    return [frame = captureFrame()](juce::Graphics& g) { paintFrame(g, frame); };
+}
+
+Oscilloscope::WaveformFrame Oscilloscope::captureFrame() const
+{
+    auto& config = ConfigurationManager::getInstance();
+
+    WaveformFrame frame;
+    frame.bounds = getVisualizationBounds();
+    frame.colour = getProbeColour(probeManager.getActiveProbe());
+    frame.samplesToDisplay = static_cast<int>((timeWindowMs / 1000.0f) * sampleRate);
+    frame.amplitude = cachedAmplitude;
+    frame.markerColour = config.getGridMajorColour().withAlpha(0.6f);
+    frame.labelColour = config.getTextDimColour();
+    frame.labelFontSize = config.getFontSizeSmall() - 2.0f;
+    frame.quality = getRenderQuality();
+
+    frame.rollMode = isRollMode();
+    if (frame.rollMode) {
+        frame.roll = frozen ? frozenRoll : rollBuffer;
+        return frame;
+    }
+
+    frame.overlayMode = isOverlayMode();
+    if (frame.overlayMode) {
+        frame.voices = frozen ? frozenOverlay : overlayTraces;
+        return frame;
+    }
 
+    frame.ghost = frozenBuffer;
+    frame.trace = frozen ? frozenBuffer : displayBuffer;
+    return frame;
+}
+
+void Oscilloscope::paintFrame(juce::Graphics& g, const WaveformFrame& frame)
+{
     // Draw amplitude markers (dashed lines at peak levels)
-    drawAmplitudeMarkers(g, bounds);
+    drawAmplitudeMarkers(g, frame);
 
-    // Draw frozen trace first (ghosted)
-    if (!frozenBuffer.empty()) {
-        drawWaveform(g, bounds, frozenBuffer, probeColour.withAlpha(0.3f));
+    if (frame.rollMode) {
+        drawRoll(g, frame);
+        return;
+    }
+
+    if (frame.overlayMode) {
+        for (const auto& voice : frame.voices)
+            drawWaveform(g, frame, voice.samples, getVoiceColour(voice.voice), 0);
+        return;
     }
 
-    // Draw live trace if not frozen
-    if (!frozen && !displayBuffer.empty()) {
-        drawWaveform(g, bounds, displayBuffer, probeColour);
+    // Draw frozen trace first (ghosted)
+    if (!frame.ghost.empty()) {
+        drawWaveform(g, frame, frame.ghost, frame.colour.withAlpha(0.3f));
     }
-    else if (frozen && !frozenBuffer.empty()) {
-        drawWaveform(g, bounds, frozenBuffer, probeColour);
+
+    // Draw the live trace, or the frozen one at full strength
+    if (!frame.trace.empty()) {
+        drawWaveform(g, frame, frame.trace, frame.colour);
     }
 }
 
@@ -104,7 +182,8 @@ void Oscilloscope::renderOverlay(juce::Graphics& g)
     auto& config = ConfigurationManager::getInstance();
     auto fullBounds = getLocalBounds().toFloat();
     auto bounds = getVisualizationBounds();
-    auto probeColour = getProbeColour(probeManager.getActiveProbe());
+    const auto activeProbe = probeManager.getActiveProbe();
+    auto probeColour = getProbeColour(activeProbe);
 
     // Get font sizes from config
     float fontSmall = config.getFontSizeSmall();
@@ -114,36 +193,46 @@ void Oscilloscope::renderOverlay(juce::Graphics& g)
     g.setColour(probeColour);
     g.setFont(fontNormal);
 
-    juce::String probeText;
-    switch (probeManager.getActiveProbe()) {
-        case ProbePoint::Oscillator:   probeText = "OSC"; break;
-        case ProbePoint::PostFilter:   probeText = "FILT"; break;
-        case ProbePoint::PostEnvelope: probeText = "ENV"; break;
-        case ProbePoint::Output:       probeText = "OUT"; break;
-        case ProbePoint::Mix:          probeText = "MIX"; break;
-    }
-    g.drawText(probeText, static_cast<int>(fullBounds.getRight() - 50), static_cast<int>(fullBounds.getY() + 5), 45, 15,
-               juce::Justification::centredRight);
+    labels.draw(g, ProbeLabel,
+                {static_cast<int>(fullBounds.getRight() - 50), static_cast<int>(fullBounds.getY() + 5), 45, 15},
+                juce::Justification::centredRight, [activeProbe] {
+        switch (activeProbe) {
+            case ProbePoint::Oscillator:   return juce::String("OSC");
+            case ProbePoint::PostFilter:   return juce::String("FILT");
+            case ProbePoint::PostEnvelope: return juce::String("ENV");
+            case ProbePoint::Output:       return juce::String("OUT");
+            case ProbePoint::Mix:          return juce::String("MIX");
+            case ProbePoint::Chorus:       return juce::String("CHO");
+            case ProbePoint::Delay:        return juce::String("DLY");
+            case ProbePoint::Reverb:       return juce::String("REV");
+        }
+        return juce::String();
+    }, static_cast<int>(activeProbe));
 
     // Draw time window indicator
     g.setColour(config.getTextDimColour());
     g.setFont(fontSmall);
-    g.drawText(juce::String(timeWindowMs, 1) + " ms", static_cast<int>(fullBounds.getX() + 5), static_cast<int>(fullBounds.getY() + 5),
-               60, 15, juce::Justification::centredLeft);
+    const bool rollMode = isRollMode();
+    labels.draw(g, TimeWindowLabel,
+                {static_cast<int>(fullBounds.getX() + 5), static_cast<int>(fullBounds.getY() + 5), 90, 15},
+                juce::Justification::centredLeft, [this, rollMode] {
+        return juce::String(timeWindowMs, 1) + (rollMode ? " ms roll" : " ms");
+    }, timeWindowMs, rollMode);
 
     // Draw frozen indicator
     if (frozen) {
         g.setColour(juce::Colours::red.withAlpha(0.8f));
         g.setFont(fontNormal);
-        g.drawText("FROZEN", static_cast<int>(fullBounds.getCentreX() - 30), static_cast<int>(fullBounds.getY() + 5), 60, 15,
-                   juce::Justification::centred);
+        labels.draw(g, FrozenLabel,
+                    {static_cast<int>(fullBounds.getCentreX() - 30), static_cast<int>(fullBounds.getY() + 5), 60, 15},
+                    juce::Justification::centred, [] { return juce::String("FROZEN"); });
     }
 
     // Get frequency directly from ProbeManager (set by the oscillator)
     // This is much more stable than trying to detect it from the waveform
     float detectedFreq;
-    if (probeManager.getVoiceMode() == VoiceMode::Mix) {
-        // For mix mode, use the lowest active frequency (bass note)
+    if (probeManager.getVoiceMode() != VoiceMode::SingleVoice) {
+        // For mix and overlay modes, use the lowest active frequency (bass note)
         detectedFreq = probeManager.getLowestActiveFrequency();
     } else {
         // For single voice mode, use the active voice's frequency
@@ -155,26 +244,29 @@ void Oscilloscope::renderOverlay(juce::Graphics& g)
     int freqInfoHeight = config.getLayoutInt("components.oscilloscope.overlay.frequencyInfo.height", 14);
 
     if (detectedFreq > 20.0f && detectedFreq < sampleRate / 2.0f) {
-        auto freqValue = FrequencyValue::fromHz(detectedFreq, sampleRate);
-        float periodMs = 1000.0f / detectedFreq;
-
         g.setColour(config.getTextColour());
         g.setFont(fontSmall);
 
-        // Show period and frequency with dual display
-        juce::String periodText = "T = " + juce::String(periodMs, 2) + " ms";
-        juce::String freqText = juce::String(freqValue.toDualString(sampleRate));
-        juce::String noteText = juce::String(freqValue.toNoteName(sampleRate));
-
-        // Build the full info string: "T = 2.27 ms | f0 = 440 Hz (0.063 rad) (A4)"
-        juce::String infoText = periodText + " | f0 = " + freqText;
-        if (noteText.isNotEmpty()) {
-            infoText += " (" + noteText + ")";
-        }
-
         // Draw at top of panel, centered
-        g.drawText(infoText, static_cast<int>(fullBounds.getX()), static_cast<int>(fullBounds.getY() + freqInfoY),
-                   static_cast<int>(fullBounds.getWidth()), freqInfoHeight, juce::Justification::centred);
+        labels.draw(g, FrequencyLabel,
+                    {static_cast<int>(fullBounds.getX()), static_cast<int>(fullBounds.getY() + freqInfoY),
+                     static_cast<int>(fullBounds.getWidth()), freqInfoHeight},
+                    juce::Justification::centred, [this, detectedFreq] {
+            auto freqValue = FrequencyValue::fromHz(detectedFreq, sampleRate);
+            float periodMs = 1000.0f / detectedFreq;
+
+            // Show period and frequency with dual display
+            juce::String periodText = "T = " + juce::String(periodMs, 2) + " ms";
+            juce::String freqText = juce::String(freqValue.toDualString(sampleRate));
+            juce::String noteText = juce::String(freqValue.toNoteName(sampleRate));
+
+            // Build the full info string: "T = 2.27 ms | f0 = 440 Hz (0.063 rad) (A4)"
+            juce::String infoText = periodText + " | f0 = " + freqText;
+            if (noteText.isNotEmpty()) {
+                infoText += " (" + noteText + ")";
+            }
+            return infoText;
+        }, detectedFreq, sampleRate);
     }
 
     // Draw amplitude measurements (Vpp, Vrms) - left side below time window
@@ -187,49 +279,59 @@ void Oscilloscope::renderOverlay(juce::Graphics& g)
         float ampY = config.getLayoutFloat("components.oscilloscope.overlay.amplitudeInfo.y", 20.0f);
         int lineHeight = config.getLayoutInt("components.oscilloscope.overlay.amplitudeInfo.lineHeight", 12);
 
-        // Format amplitude values - show as normalized values (0-2 for full scale)
-        juce::String vppText = "Vpp: " + juce::String(cachedAmplitude.peakToPeak, 3);
-        juce::String rmsText = "Vrms: " + juce::String(cachedAmplitude.rms, 3);
+        const int textX = static_cast<int>(fullBounds.getX() + ampX);
+        const int textY = static_cast<int>(fullBounds.getY() + ampY);
+        const float peakToPeak = cachedAmplitude.peakToPeak;
+        const float rms = cachedAmplitude.rms;
 
-        // Draw Vpp and Vrms on left side
-        g.drawText(vppText, static_cast<int>(fullBounds.getX() + ampX), static_cast<int>(fullBounds.getY() + ampY),
-                   70, lineHeight, juce::Justification::centredLeft);
-        g.drawText(rmsText, static_cast<int>(fullBounds.getX() + ampX), static_cast<int>(fullBounds.getY() + ampY + lineHeight),
-                   70, lineHeight, juce::Justification::centredLeft);
+        // Format amplitude values - show as normalized values (0-2 for full scale)
+        labels.draw(g, VppLabel, {textX, textY, 70, lineHeight}, juce::Justification::centredLeft,
+                    [peakToPeak] { return "Vpp: " + juce::String(peakToPeak, 3); }, peakToPeak);
+        labels.draw(g, RmsLabel, {textX, textY + lineHeight, 70, lineHeight}, juce::Justification::centredLeft,
+                    [rms] { return "Vrms: " + juce::String(rms, 3); }, rms);
 
         // Also show dB values for audio context
-        float vppDb = 20.0f * std::log10(std::max(cachedAmplitude.peakToPeak / 2.0f, 0.0001f));
-        float rmsDb = 20.0f * std::log10(std::max(cachedAmplitude.rms, 0.0001f));
-
-        juce::String vppDbText = "(" + juce::String(vppDb, 1) + " dB)";
-        juce::String rmsDbText = "(" + juce::String(rmsDb, 1) + " dB)";
-
-        g.drawText(vppDbText, static_cast<int>(fullBounds.getX() + ampX + 70), static_cast<int>(fullBounds.getY() + ampY),
-                   55, lineHeight, juce::Justification::centredLeft);
-        g.drawText(rmsDbText, static_cast<int>(fullBounds.getX() + ampX + 70), static_cast<int>(fullBounds.getY() + ampY + lineHeight),
-                   55, lineHeight, juce::Justification::centredLeft);
+        labels.draw(g, VppDbLabel, {textX + 70, textY, 55, lineHeight}, juce::Justification::centredLeft, [peakToPeak] {
+            float vppDb = 20.0f * std::log10(std::max(peakToPeak / 2.0f, 0.0001f));
+            return "(" + juce::String(vppDb, 1) + " dB)";
+        }, peakToPeak);
+        labels.draw(g, RmsDbLabel, {textX + 70, textY + lineHeight, 55, lineHeight}, juce::Justification::centredLeft, [rms] {
+            float rmsDb = 20.0f * std::log10(std::max(rms, 0.0001f));
+            return "(" + juce::String(rmsDb, 1) + " dB)";
+        }, rms);
     }
 
     // Draw sample rate info with enhanced display
     g.setColour(config.getTextDimColour());
     g.setFont(fontSmall);
-    juce::String fsText = "fs = " + juce::String(formatSampleRate(sampleRate));
-    // Also show Nyquist frequency
-    float nyquist = sampleRate / 2.0f;
-    juce::String nyquistText = "fN = " + juce::String(nyquist / 1000.0f, 1) + " kHz";
-    g.drawText(fsText + " | " + nyquistText, static_cast<int>(bounds.getRight() - 160), static_cast<int>(bounds.getY() - 15),
-               155, 12, juce::Justification::right);
+    labels.draw(g, SampleRateLabel,
+                {static_cast<int>(bounds.getRight() - 160), static_cast<int>(bounds.getY() - 15), 155, 12},
+                juce::Justification::right, [this] {
+        juce::String fsText = "fs = " + juce::String(formatSampleRate(sampleRate));
+        // Also show Nyquist frequency
+        float nyquist = sampleRate / 2.0f;
+        juce::String nyquistText = "fN = " + juce::String(nyquist / 1000.0f, 1) + " kHz";
+        return fsText + " | " + nyquistText;
+    }, sampleRate);
 
     // Voice indicator (only show in single voice mode)
+    const juce::Rectangle<int> voiceArea(static_cast<int>(fullBounds.getX() + 5), static_cast<int>(bounds.getBottom() - 15), 80, 15);
+
     if (probeManager.getVoiceMode() == VoiceMode::SingleVoice) {
         int activeVoice = probeManager.getActiveVoice();
         if (activeVoice >= 0) {
             g.setColour(juce::Colours::grey);
-            g.drawText("Voice " + juce::String(activeVoice + 1) + "/8",
-                       static_cast<int>(fullBounds.getX() + 5), static_cast<int>(bounds.getBottom() - 15), 80, 15,
-                       juce::Justification::centredLeft);
+            labels.draw(g, VoiceLabel, voiceArea, juce::Justification::centredLeft,
+                        [activeVoice] { return "Voice " + juce::String(activeVoice + 1) + "/8"; }, activeVoice);
         }
     }
+    else if (isOverlayMode()) {
+        const int numVoices = static_cast<int>((frozen ? frozenOverlay : overlayTraces).size());
+        g.setColour(juce::Colours::grey);
+        labels.draw(g, VoiceCountLabel, voiceArea, juce::Justification::centredLeft, [numVoices] {
+            return juce::String(numVoices) + (numVoices == 1 ? " voice" : " voices");
+        }, numVoices);
+    }
 
     // Draw voice mode toggle
     drawVoiceModeToggle(g, fullBounds);
@@ -247,37 +349,67 @@ void Oscilloscope::mouseDown(const juce::MouseEvent& event)
     if (mixButtonBounds.contains(pos)) {
         probeManager.setVoiceMode(VoiceMode::Mix);
         displayBuffer.clear();
-        repaint();
+        refreshDisplay();
     }
     else if (voiceButtonBounds.contains(pos)) {
         probeManager.setVoiceMode(VoiceMode::SingleVoice);
         displayBuffer.clear();
-        repaint();
+        refreshDisplay();
+    }
+    else if (overlayButtonBounds.contains(pos)) {
+        probeManager.setVoiceMode(VoiceMode::Overlay);
+        displayBuffer.clear();
+        overlayTraces.clear();
+        refreshDisplay();
     }
 }
 
 //==============================================================================
 void Oscilloscope::timerCallback()
 {
+    VIZASYNTH_TRACE_SCOPE("timer", "Oscilloscope::timerCallback");
     // Don't process if not visible - prevents stealing data from other visualizers
     if (!isVisible())
         return;
 
+    if (isOverlayMode())
+        probeConsumer.claimLanes();
+    else
+        probeConsumer.claim(getActiveBuffer());
+
     // Update sample rate
     sampleRate = static_cast<float>(probeManager.getSampleRate());
 
     if (frozen) {
         // Still update amplitude from frozen buffer
-        cachedAmplitude = calculateAmplitude(frozenBuffer);
+        cachedAmplitude = isRollMode() ? calculateAmplitude(frozenRoll) : calculateAmplitude(frozenBuffer);
         return;
     }
 
+    if (isRollMode()) {
+        updateRoll();
+        cachedAmplitude = calculateAmplitude(rollBuffer);
+        refreshDisplay();
+        return;
+    }
+
+    stopRoll();
+
     // Calculate how many samples we need for the current time window
     int samplesNeeded = static_cast<int>((timeWindowMs / 1000.0f) * sampleRate);
-    samplesNeeded = std::min(samplesNeeded, ProbeBuffer::BufferSize);
+
+    if (isOverlayMode()) {
+        updateOverlay(samplesNeeded);
+        cachedAmplitude = calculateAmplitude(displayBuffer);
+        refreshDisplay();
+        return;
+    }
+
+    overlayTraces.clear();
+    samplesNeeded = std::min(samplesNeeded, getActiveBuffer().getCapacity());
 
     // Pull available samples from the appropriate probe buffer
-    std::vector<float> tempBuffer(ProbeBuffer::BufferSize);
+    std::vector<float> tempBuffer(static_cast<size_t>(getActiveBuffer().getCapacity()));
     int numPulled = getActiveBuffer().pull(tempBuffer.data(),
                                            static_cast<int>(tempBuffer.size()));
 
@@ -298,21 +430,29 @@ void Oscilloscope::timerCallback()
     // Calculate amplitude measurements for display
     cachedAmplitude = calculateAmplitude(displayBuffer);
 
-    repaint();
+    refreshDisplay();
+}
+
+void Oscilloscope::showingChanged(bool isNowShowing)
+{
+    if (!isNowShowing)
+        probeConsumer.release();
 }
 
 //==============================================================================
 ProbeBuffer& Oscilloscope::getActiveBuffer()
 {
-    // For Output probe point, use mix buffer in Mix mode
-    if (probeManager.getVoiceMode() == VoiceMode::Mix &&
-        probeManager.getActiveProbe() == ProbePoint::Output) {
+    // For Output probe point, use mix buffer in Mix mode (and for Overlay's roll mode);
+    // the effects bus is only ever probed through the mix buffer
+    const auto activeProbe = probeManager.getActiveProbe();
+    if (isEffectProbePoint(activeProbe) ||
+        (probeManager.getVoiceMode() != VoiceMode::SingleVoice && activeProbe == ProbePoint::Output)) {
         return probeManager.getMixProbeBuffer();
     }
     return probeManager.getProbeBuffer();
 }
 
-int Oscilloscope::findTriggerPoint(const std::vector<float>& samples) const
+int Oscilloscope::findTriggerPoint(const std::vector<float>& samples)
 {
     if (samples.size() < 2)
         return 0;
@@ -357,22 +497,178 @@ Oscilloscope::AmplitudeMeasurements Oscilloscope::calculateAmplitude(const std::
     return result;
 }
 
-void Oscilloscope::drawWaveform(juce::Graphics& g, juce::Rectangle<float> bounds,
+Oscilloscope::AmplitudeMeasurements Oscilloscope::calculateAmplitude(const std::vector<DecimatedPoint>& points) const
+{
+    AmplitudeMeasurements result;
+
+    if (points.empty()) {
+        return result;
+    }
+
+    float maxVal = points[0].maximum;
+    float minVal = points[0].minimum;
+    float sumSquares = 0.0f;
+
+    // Every point covers the same number of samples, so mean squares average
+    for (const auto& point : points) {
+        maxVal = std::max(maxVal, point.maximum);
+        minVal = std::min(minVal, point.minimum);
+        sumSquares += point.rms * point.rms;
+    }
+
+    result.peakPositive = maxVal;
+    result.peakNegative = -minVal;
+    result.peakToPeak = maxVal - minVal;
+    result.rms = std::sqrt(sumSquares / static_cast<float>(points.size()));
+    result.valid = result.peakToPeak > MinAmplitudeThreshold;
+
+    return result;
+}
+
+//==============================================================================
+void Oscilloscope::updateRoll()
+{
+    auto& buffer = getActiveBuffer();
+    auto& stream = buffer.getDecimatedStream();
+    const int windowSamples = static_cast<int>((timeWindowMs / 1000.0f) * sampleRate);
+    const int factor = std::max(1, windowSamples / RollPoints);
+
+    // Follow the active buffer and window; points of another scale don't mix
+    if (&stream != rollStream || factor != rollFactor) {
+        stopRoll();
+        rollStream = &stream;
+        rollFactor = factor;
+        stream.setFactor(factor);
+        stream.clear();
+    }
+
+    rollScratch.resize(static_cast<size_t>(DecimatedStream::Capacity));
+    const int numPulled = stream.pull(rollScratch.data(), DecimatedStream::Capacity);
+
+    rollBuffer.insert(rollBuffer.end(), rollScratch.begin(), rollScratch.begin() + numPulled);
+    if (static_cast<int>(rollBuffer.size()) > RollPoints)
+        rollBuffer.erase(rollBuffer.begin(), rollBuffer.end() - RollPoints);
+}
+
+void Oscilloscope::stopRoll()
+{
+    if (rollStream == nullptr)
+        return;
+
+    // Back to full rate: drop what piled up in the ring meanwhile
+    rollStream->setFactor(0);
+    getActiveBuffer().clear();
+
+    rollStream = nullptr;
+    rollFactor = 0;
+    rollBuffer.clear();
+}
+
+void Oscilloscope::updateOverlay(int samplesNeeded)
+{
+    auto& lanes = probeManager.getVoiceLanes();
+    const int span = std::min(samplesNeeded * 2, lanes.getMaxReadSamples());
+    samplesNeeded = std::min(samplesNeeded, span);
+
+    // The same span of the clock from every lane that sounded in it
+    const auto end = lanes.getClock();
+    size_t numSounding = 0;
+
+    for (int lane = 0; lane < lanes.getNumLanes(); ++lane) {
+        if (numSounding == overlayScratch.size())
+            overlayScratch.emplace_back();
+
+        auto& trace = overlayScratch[numSounding];
+        trace.samples.resize(static_cast<size_t>(span));
+
+        if (lanes.read(lane, end, trace.samples.data(), span)) {
+            trace.voice = lane;
+            ++numSounding;
+        }
+    }
+
+    overlayTraces.resize(numSounding);
+    displayBuffer.clear();
+
+    if (numSounding == 0)
+        return;
+
+    // Trigger on the most recently played voice, as Voice mode would, and
+    // cut every trace there so their phases stay as they sound
+    size_t reference = 0;
+    for (size_t i = 0; i < numSounding; ++i)
+        if (overlayScratch[i].voice == probeManager.getActiveVoice())
+            reference = i;
+
+    const auto& referenceSamples = overlayScratch[reference].samples;
+    const int trigger = std::min(findTriggerPoint(referenceSamples), span - samplesNeeded);
+    displayBuffer.assign(referenceSamples.begin(), referenceSamples.end());
+
+    for (size_t i = 0; i < numSounding; ++i) {
+        const auto first = overlayScratch[i].samples.begin() + trigger;
+        overlayTraces[i].voice = overlayScratch[i].voice;
+        overlayTraces[i].samples.assign(first, first + samplesNeeded);
+    }
+}
+
+void Oscilloscope::drawRoll(juce::Graphics& g, const WaveformFrame& frame)
+{
+    const int numPoints = static_cast<int>(frame.roll.size());
+    if (numPoints < 2)
+        return;
+
+    auto bounds = frame.bounds;
+    float xScale = bounds.getWidth() / (RollPoints - 1);
+    float xStart = bounds.getRight() - (numPoints - 1) * xScale;
+    float yCenter = bounds.getCentreY();
+    float yScale = bounds.getHeight() * 0.45f;
+
+    auto yFor = [&](float value) { return yCenter - juce::jlimit(-1.0f, 1.0f, value) * yScale; };
+
+    if (frame.quality.pixelLines()) {
+        g.setColour(frame.colour);
+        for (int i = 0; i < numPoints; ++i) {
+            const auto& point = frame.roll[static_cast<size_t>(i)];
+            g.drawVerticalLine(static_cast<int>(xStart + i * xScale), yFor(point.maximum), yFor(point.minimum) + 1.0f);
+        }
+        return;
+    }
+
+    // Maxima left to right, then minima back again
+    juce::Path envelope;
+    envelope.startNewSubPath(xStart, yFor(frame.roll[0].maximum));
+    for (int i = 1; i < numPoints; ++i)
+        envelope.lineTo(xStart + i * xScale, yFor(frame.roll[static_cast<size_t>(i)].maximum));
+    for (int i = numPoints; --i >= 0;)
+        envelope.lineTo(xStart + i * xScale, yFor(frame.roll[static_cast<size_t>(i)].minimum));
+    envelope.closeSubPath();
+
+    g.setColour(frame.colour.withAlpha(0.5f));
+    g.fillPath(envelope);
+    g.setColour(frame.colour);
+    g.strokePath(envelope, juce::PathStrokeType(1.0f));
+}
+
+void Oscilloscope::drawWaveform(juce::Graphics& g, const WaveformFrame& frame,
                                  const std::vector<float>& samples, juce::Colour colour)
+{
+    drawWaveform(g, frame, samples, colour, findTriggerPoint(samples));
+}
+
+void Oscilloscope::drawWaveform(juce::Graphics& g, const WaveformFrame& frame,
+                                 const std::vector<float>& samples, juce::Colour colour, int triggerOffset)
 {
     if (samples.empty())
         return;
 
+    auto bounds = frame.bounds;
+
     // Calculate samples to display
-    int samplesToDisplay = static_cast<int>((timeWindowMs / 1000.0f) * sampleRate);
-    samplesToDisplay = std::min(samplesToDisplay, static_cast<int>(samples.size()));
+    int samplesToDisplay = std::min(frame.samplesToDisplay, static_cast<int>(samples.size()));
 
     if (samplesToDisplay < 2)
         return;
 
-    // Find trigger point
-    int triggerOffset = findTriggerPoint(samples);
-
     // Make sure we have enough samples after trigger
     if (triggerOffset + samplesToDisplay > static_cast<int>(samples.size()))
         triggerOffset = std::max(0, static_cast<int>(samples.size()) - samplesToDisplay);
@@ -383,6 +679,35 @@ void Oscilloscope::drawWaveform(juce::Graphics& g, juce::Rectangle<float> bounds
     float yCenter = bounds.getCentreY();
     float yScale = bounds.getHeight() * 0.45f;
 
+    // Reduced detail: the first and last extreme of each pixel column, in order
+    const int columns = std::max(1, static_cast<int>(bounds.getWidth()));
+    if (frame.quality.reduceDetail() && samplesToDisplay > 2 * columns) {
+        const float* visible = samples.data() + triggerOffset;
+        int begin = 0;
+
+        for (int column = 0; column < columns; ++column) {
+            const int end = std::max(begin + 1, static_cast<int>(static_cast<int64_t>(column + 1) * samplesToDisplay / columns));
+            const auto lowest = std::min_element(visible + begin, visible + end);
+            const auto highest = std::max_element(visible + begin, visible + end);
+
+            for (auto extreme : {std::min(lowest, highest), std::max(lowest, highest)}) {
+                const float x = bounds.getX() + static_cast<float>(extreme - visible) * xScale;
+                const float y = yCenter - juce::jlimit(-1.0f, 1.0f, *extreme) * yScale;
+
+                if (waveformPath.isEmpty())
+                    waveformPath.startNewSubPath(x, y);
+                else
+                    waveformPath.lineTo(x, y);
+            }
+
+            begin = end;
+        }
+
+        g.setColour(colour);
+        drawTrace(g, waveformPath, 1.5f, frame.quality.pixelLines());
+        return;
+    }
+
     for (int i = 0; i < samplesToDisplay; ++i) {
         float sample = samples[static_cast<size_t>(triggerOffset + i)];
         sample = juce::jlimit(-1.0f, 1.0f, sample);
@@ -397,26 +722,26 @@ void Oscilloscope::drawWaveform(juce::Graphics& g, juce::Rectangle<float> bounds
     }
 
     g.setColour(colour);
-    g.strokePath(waveformPath, juce::PathStrokeType(1.5f));
+    drawTrace(g, waveformPath, 1.5f, frame.quality.pixelLines());
 }
 
-void Oscilloscope::drawAmplitudeMarkers(juce::Graphics& g, juce::Rectangle<float> bounds)
+void Oscilloscope::drawAmplitudeMarkers(juce::Graphics& g, const WaveformFrame& frame)
 {
-    if (!cachedAmplitude.valid)
+    const auto& amplitude = frame.amplitude;
+    if (!amplitude.valid)
         return;
 
-    auto& config = ConfigurationManager::getInstance();
+    auto bounds = frame.bounds;
 
     float yCenter = bounds.getCentreY();
     float yScale = bounds.getHeight() * 0.45f;
 
     // Calculate Y positions for peak levels
-    float yPeakPos = yCenter - cachedAmplitude.peakPositive * yScale;
-    float yPeakNeg = yCenter + cachedAmplitude.peakNegative * yScale;
+    float yPeakPos = yCenter - amplitude.peakPositive * yScale;
+    float yPeakNeg = yCenter + amplitude.peakNegative * yScale;
 
     // Set up dashed line style using grid colour from config
-    juce::Colour markerColour = config.getGridMajorColour().withAlpha(0.6f);
-    g.setColour(markerColour);
+    g.setColour(frame.markerColour);
 
     // Draw dashed lines for peak positive and negative
     float dashLengths[] = { 4.0f, 4.0f };  // 4px dash, 4px gap
@@ -437,12 +762,12 @@ void Oscilloscope::drawAmplitudeMarkers(juce::Graphics& g, juce::Rectangle<float
     g.strokePath(peakNegPath, strokeType);
 
     // Draw small labels at the right edge
-    g.setFont(config.getFontSizeSmall() - 2.0f);
-    g.setColour(config.getTextDimColour());
+    g.setFont(frame.labelFontSize);
+    g.setColour(frame.labelColour);
 
     // Format peak values
-    juce::String peakPosLabel = "+" + juce::String(cachedAmplitude.peakPositive, 2);
-    juce::String peakNegLabel = "-" + juce::String(cachedAmplitude.peakNegative, 2);
+    juce::String peakPosLabel = "+" + juce::String(amplitude.peakPositive, 2);
+    juce::String peakNegLabel = "-" + juce::String(amplitude.peakNegative, 2);
 
     // Position labels just inside the bounds
     float labelX = bounds.getRight() - 35.0f;
@@ -468,26 +793,34 @@ void Oscilloscope::drawVoiceModeToggle(juce::Graphics& g, juce::Rectangle<float>
     float spacing = config.getLayoutFloat("components.oscilloscope.voiceModeToggle.spacing", 2.0f);
     float padding = config.getLayoutFloat("components.oscilloscope.voiceModeToggle.padding", 8.0f);
 
-    float startX = bounds.getRight() - (buttonWidth * 2 + spacing + padding);
+    float startX = bounds.getRight() - (buttonWidth * 3 + spacing * 2 + padding);
     float startY = bounds.getBottom() - buttonHeight - padding;
 
     mixButtonBounds = juce::Rectangle<float>(startX, startY, buttonWidth, buttonHeight);
-    voiceButtonBounds = juce::Rectangle<float>(startX + buttonWidth + spacing, startY, buttonWidth, buttonHeight);
+    voiceButtonBounds = mixButtonBounds.translated(buttonWidth + spacing, 0.0f);
+    overlayButtonBounds = voiceButtonBounds.translated(buttonWidth + spacing, 0.0f);
 
-    bool isMixMode = probeManager.getVoiceMode() == VoiceMode::Mix;
-
-    // Draw Mix button
-    g.setColour(isMixMode ? config.getGridMajorColour() : config.getGridColour());
-    g.fillRoundedRectangle(mixButtonBounds, 3.0f);
-    g.setColour(isMixMode ? config.getTextColour() : config.getTextDimColour());
+    const auto mode = probeManager.getVoiceMode();
     g.setFont(config.getFontSizeSmall());
-    g.drawText("Mix", mixButtonBounds, juce::Justification::centred);
 
-    // Draw Voice button
-    g.setColour(!isMixMode ? config.getGridMajorColour() : config.getGridColour());
-    g.fillRoundedRectangle(voiceButtonBounds, 3.0f);
-    g.setColour(!isMixMode ? config.getTextColour() : config.getTextDimColour());
-    g.drawText("Voice", voiceButtonBounds, juce::Justification::centred);
+    auto drawButton = [&](juce::Rectangle<float> buttonBounds, const juce::String& text, bool selected) {
+        g.setColour(selected ? config.getGridMajorColour() : config.getGridColour());
+        g.fillRoundedRectangle(buttonBounds, 3.0f);
+        g.setColour(selected ? config.getTextColour() : config.getTextDimColour());
+        g.drawText(text, buttonBounds, juce::Justification::centred);
+    };
+
+    drawButton(mixButtonBounds, "Mix", mode == VoiceMode::Mix);
+    drawButton(voiceButtonBounds, "Voice", mode == VoiceMode::SingleVoice);
+    drawButton(overlayButtonBounds, "All", mode == VoiceMode::Overlay);
 }
 
+//==============================================================================
+REGISTER_PANEL("oscilloscope", "Oscilloscope", Oscilloscope, [] {
+    PanelCapabilities caps;
+    caps.needsProbeBuffer = true;
+    caps.supportsFreezing = true;
+    return caps;
+}())
+
 } // namespace vizasynth
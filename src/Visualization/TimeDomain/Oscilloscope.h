@@ -12,11 +12,15 @@ namespace vizasynth {
  *
  * Displays time-domain waveform from a ProbeBuffer with zero-crossing triggering.
  * Extends VisualizationPanel for consistent interface with other panels.
+ *
+ * In Overlay voice mode every sounding voice is drawn in its own colour from
+ * the per-voice lanes, all cut at the trigger point found on the most
+ * recently played voice so their phases line up as they sound.
  */
 class Oscilloscope : public VisualizationPanel {
 public:
     explicit Oscilloscope(ProbeManager& probeManager);
-    ~Oscilloscope() override = default;
+    ~Oscilloscope() override;
 
     //=========================================================================
     // VisualizationPanel Interface
@@ -40,7 +44,9 @@ public:
     //=========================================================================
 
     /**
-     * Set the time window in milliseconds.
+     * Set the time window in milliseconds. Windows longer than
+     * MaxTriggeredWindowMs switch to roll mode: a scrolling min/max envelope
+     * fed by the probe's decimated stream instead of full-rate samples.
      */
     void setTimeWindow(float milliseconds);
 
@@ -49,12 +55,23 @@ public:
      */
     float getTimeWindow() const { return timeWindowMs; }
 
+    bool isRollMode() const { return timeWindowMs > MaxTriggeredWindowMs; }
+
+    // Drawing every voice from the lanes (Overlay mode outside roll mode, before the effects)
+    bool isOverlayMode() const;
+
+    static constexpr float MaxTriggeredWindowMs = 100.0f;
+    static constexpr float MaxRollWindowMs = 2000.0f;
+
     //=========================================================================
     // Probe Color (static for use by other components)
     //=========================================================================
 
     static juce::Colour getProbeColour(ProbePoint probe);
 
+    // Trace colour for a voice slot in Overlay mode
+    static juce::Colour getVoiceColour(int voiceIndex);
+
 protected:
     //=========================================================================
     // VisualizationPanel Overrides
@@ -76,12 +93,31 @@ protected:
     //=========================================================================
 
     void timerCallback() override;
+    void showingChanged(bool isNowShowing) override;
+
+    //=========================================================================
+    // Background Rendering
+    //=========================================================================
+
+    LayerPainter createLayerPainter() override;
 
 private:
     /**
-     * Find a good trigger point (rising zero crossing).
+     * Overlay label ids in the label cache.
      */
-    int findTriggerPoint(const std::vector<float>& samples) const;
+    enum OverlayLabel {
+        ProbeLabel,
+        TimeWindowLabel,
+        FrozenLabel,
+        FrequencyLabel,
+        VppLabel,
+        RmsLabel,
+        VppDbLabel,
+        RmsDbLabel,
+        SampleRateLabel,
+        VoiceLabel,
+        VoiceCountLabel
+    };
 
     /**
      * Amplitude measurements for the waveform.
@@ -94,16 +130,79 @@ private:
         bool valid = false;          // True if measurements are valid
     };
 
+    /**
+     * One voice's trace in Overlay mode, already cut at the shared trigger.
+     */
+    struct VoiceTrace {
+        int voice = 0;
+        std::vector<float> samples;
+    };
+
+    /**
+     * Everything the waveform layer draws, copied on the message thread so
+     * it can be painted on a render thread.
+     */
+    struct WaveformFrame {
+        juce::Rectangle<float> bounds;
+        std::vector<float> trace;       // Live (or frozen) trace
+        std::vector<float> ghost;       // Frozen trace drawn behind it
+        std::vector<DecimatedPoint> roll;  // Roll mode envelope, oldest first
+        std::vector<VoiceTrace> voices;    // Overlay mode traces
+        bool rollMode = false;
+        bool overlayMode = false;
+        juce::Colour colour;
+        int samplesToDisplay = 0;
+        AmplitudeMeasurements amplitude;
+        juce::Colour markerColour;
+        juce::Colour labelColour;
+        float labelFontSize = 10.0f;
+        RenderQuality quality;
+    };
+
+    /**
+     * Snapshot the current display state.
+     */
+    WaveformFrame captureFrame() const;
+
+    /**
+     * Paint the waveform layer (markers, ghost and live traces).
+     */
+    static void paintFrame(juce::Graphics& g, const WaveformFrame& frame);
+
+    /**
+     * Find a good trigger point (rising zero crossing).
+     */
+    static int findTriggerPoint(const std::vector<float>& samples);
+
     /**
      * Calculate amplitude measurements from waveform samples.
      */
     AmplitudeMeasurements calculateAmplitude(const std::vector<float>& samples) const;
+    AmplitudeMeasurements calculateAmplitude(const std::vector<DecimatedPoint>& points) const;
 
     /**
      * Draw the waveform path.
      */
-    void drawWaveform(juce::Graphics& g, juce::Rectangle<float> bounds,
-                      const std::vector<float>& samples, juce::Colour colour);
+    static void drawWaveform(juce::Graphics& g, const WaveformFrame& frame,
+                             const std::vector<float>& samples, juce::Colour colour);
+    static void drawWaveform(juce::Graphics& g, const WaveformFrame& frame,
+                             const std::vector<float>& samples, juce::Colour colour, int triggerOffset);
+
+    /**
+     * Draw the roll mode envelope, newest point at the right edge.
+     */
+    static void drawRoll(juce::Graphics& g, const WaveformFrame& frame);
+
+    /**
+     * Roll mode: follow the active probe's decimated stream and append its points.
+     */
+    void updateRoll();
+    void stopRoll();
+
+    /**
+     * Overlay mode: read every lane's newest samples and cut them at one trigger.
+     */
+    void updateOverlay(int samplesNeeded);
 
     /**
      * Draw voice mode toggle buttons.
@@ -113,7 +212,7 @@ private:
     /**
      * Draw amplitude marker lines at peak levels.
      */
-    void drawAmplitudeMarkers(juce::Graphics& g, juce::Rectangle<float> bounds);
+    static void drawAmplitudeMarkers(juce::Graphics& g, const WaveformFrame& frame);
 
     /**
      * Get the appropriate probe buffer based on voice mode.
@@ -121,17 +220,31 @@ private:
     ProbeBuffer& getActiveBuffer();
 
     ProbeManager& probeManager;
+    ProbeManager::Consumer probeConsumer{probeManager};  // Keeps the tap being read live
 
     // Display buffers
     std::vector<float> displayBuffer;
     std::vector<float> frozenBuffer;
 
+    // Roll mode envelope and the stream feeding it
+    std::vector<DecimatedPoint> rollBuffer;
+    std::vector<DecimatedPoint> frozenRoll;
+    std::vector<DecimatedPoint> rollScratch;
+    DecimatedStream* rollStream = nullptr;
+    int rollFactor = 0;
+
+    // Overlay mode traces; lane reads reuse the scratch traces' storage
+    std::vector<VoiceTrace> overlayTraces;
+    std::vector<VoiceTrace> frozenOverlay;
+    std::vector<VoiceTrace> overlayScratch;
+
     // Settings
     float timeWindowMs = 10.0f;
 
     // Voice mode toggle button bounds (for hit testing)
     juce::Rectangle<float> mixButtonBounds;
     juce::Rectangle<float> voiceButtonBounds;
+    juce::Rectangle<float> overlayButtonBounds;
 
     // Cached amplitude measurements (updated each frame)
     AmplitudeMeasurements cachedAmplitude;
@@ -139,6 +252,7 @@ private:
     // Constants
     static constexpr float TriggerHysteresis = 0.02f;
     static constexpr float MinAmplitudeThreshold = 0.001f;  // Below this, consider silent
+    static constexpr int RollPoints = 1024;                  // Envelope points across the window
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Oscilloscope)
 };
@@ -0,0 +1,76 @@
+#include "VoiceLanes.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace vizasynth {
+
+void VoiceLanes::allocate(int newNumLanes, double rate)
+{
+    const int minSamples = static_cast<int>(std::ceil(HistorySeconds * juce::jmax(1.0, rate)));
+    const auto capacity = static_cast<uint64_t>(juce::nextPowerOfTwo(juce::jmax(1024, minSamples)));
+
+    numLanes = juce::jmax(0, newNumLanes);
+    mask = capacity - 1;
+    samples.assign(static_cast<size_t>(numLanes) * capacity, 0.0f);
+    runs = std::make_unique<Run[]>(static_cast<size_t>(numLanes));
+
+    blockClock = 0;
+    publishedClock.store(0);
+}
+
+void VoiceLanes::write(int lane, int blockOffset, const float* source, int numSamples)
+{
+    if (lane < 0 || lane >= numLanes || numSamples <= 0)
+        return;
+
+    auto& run = runs[static_cast<size_t>(lane)];
+    const uint64_t clock = blockClock + static_cast<uint64_t>(blockOffset);
+
+    if (run.end.load(std::memory_order_relaxed) != clock)
+        run.start.store(clock, std::memory_order_relaxed);
+
+    // One copy, or two where the block wraps round the ring
+    float* ring = samples.data() + static_cast<size_t>(lane) * (mask + 1);
+    const auto first = static_cast<int>(std::min<uint64_t>(static_cast<uint64_t>(numSamples), mask + 1 - (clock & mask)));
+
+    std::memcpy(ring + (clock & mask), source, static_cast<size_t>(first) * sizeof(float));
+    std::memcpy(ring, source + first, static_cast<size_t>(numSamples - first) * sizeof(float));
+
+    run.end.store(clock + static_cast<uint64_t>(numSamples), std::memory_order_release);
+}
+
+bool VoiceLanes::read(int lane, uint64_t end, float* destination, int numSamples) const
+{
+    if (lane < 0 || lane >= numLanes || numSamples <= 0)
+        return false;
+
+    numSamples = std::min(numSamples, getMaxReadSamples());
+    const uint64_t from = end >= static_cast<uint64_t>(numSamples) ? end - static_cast<uint64_t>(numSamples) : 0;
+
+    const auto& run = runs[static_cast<size_t>(lane)];
+    const uint64_t runEnd = std::min(run.end.load(std::memory_order_acquire), end);
+    const uint64_t runStart = std::max(run.start.load(std::memory_order_relaxed), from);
+
+    if (runStart >= runEnd)
+        return false;
+
+    const auto leading = static_cast<size_t>(runStart + static_cast<uint64_t>(numSamples) - end);
+    const auto length = static_cast<size_t>(runEnd - runStart);
+    const float* ring = samples.data() + static_cast<size_t>(lane) * (mask + 1);
+
+    std::fill(destination, destination + leading, 0.0f);
+
+    for (size_t i = 0; i < length;)
+    {
+        const auto position = (runStart + i) & mask;
+        const auto count = std::min<size_t>(length - i, static_cast<size_t>(mask + 1 - position));
+        std::memcpy(destination + leading + i, ring + position, count * sizeof(float));
+        i += count;
+    }
+
+    std::fill(destination + leading + length, destination + numSamples, 0.0f);
+    return true;
+}
+
+} // namespace vizasynth
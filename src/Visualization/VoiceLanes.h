@@ -0,0 +1,75 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace vizasynth {
+
+//==============================================================================
+/**
+ * Per-voice probe lanes: one small ring per voice slot, all on the same
+ * sample clock, for drawing every sounding voice at once.
+ *
+ * Each voice copies its probed block into its own lane at the block's
+ * position on the clock, so lanes line up sample for sample and a silent
+ * voice simply leaves a gap. Writing is one block copy per voice with no
+ * shared state between lanes, so the cost grows linearly with polyphony.
+ *
+ * Lanes are overwritten rather than drained: the reader copies the newest
+ * span it wants from each lane and never holds them back. Keep spans below
+ * getMaxReadSamples() so the writer can't catch up with a copy in progress.
+ */
+class VoiceLanes
+{
+public:
+    // History each lane holds; twice the oscilloscope's longest triggered window
+    static constexpr double HistorySeconds = 0.2;
+
+    VoiceLanes() = default;
+
+    // Allocate numLanes lanes for at least HistorySeconds at rate. Reallocates,
+    // so only while nothing writes (prepareToPlay, polyphony changes).
+    void allocate(int numLanes, double rate);
+
+    int getNumLanes() const { return numLanes; }
+    int getCapacity() const { return static_cast<int>(mask + 1); }
+    int getMaxReadSamples() const { return getCapacity() - getCapacity() / 4; }
+
+    // Audio thread: block start on the sample clock, then each voice's
+    // chunks at their offsets into the block, then the block's end
+    void beginBlock(uint64_t blockStart) { blockClock = blockStart; }
+    void write(int lane, int blockOffset, const float* samples, int numSamples);
+    void endBlock(int numSamples) { publishedClock.store(blockClock + static_cast<uint64_t>(numSamples), std::memory_order_release); }
+
+    // UI thread: the clock up to which every lane is complete
+    uint64_t getClock() const { return publishedClock.load(std::memory_order_acquire); }
+
+    // UI thread: copy a lane's samples for [end - numSamples, end), with
+    // zeros where the voice was silent. @return false if it was silent
+    // throughout (destination is then left untouched)
+    bool read(int lane, uint64_t end, float* destination, int numSamples) const;
+
+private:
+    // Clock span of the run a lane is currently writing; a write that
+    // doesn't continue it starts a new one
+    struct Run
+    {
+        std::atomic<uint64_t> start{0};
+        std::atomic<uint64_t> end{0};
+    };
+
+    std::vector<float> samples;  // Lane after lane, each capacity long
+    std::unique_ptr<Run[]> runs;
+    int numLanes = 0;
+    uint64_t mask = 0;
+
+    uint64_t blockClock = 0;  // Audio thread
+    std::atomic<uint64_t> publishedClock{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VoiceLanes)
+};
+
+} // namespace vizasynth
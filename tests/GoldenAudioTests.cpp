@@ -0,0 +1,673 @@
+#include "GoldenFile.h"
+#include "GoldenScenarios.h"
+#include "PluginProcessor.h"
+#include "Core/PresetBank.h"
+#include "Core/RealtimeSanitizer.h"
+#include "Visualization/CaptureReplay.h"
+#include "Visualization/FrequencyDomain/SpectrumAnalyzer.h"
+#include <juce_events/juce_events.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+/**
+ * VizASynth_GoldenTests - golden-audio regression tests
+ *
+ * Renders every GoldenScenario through VizASynthAudioProcessor and compares
+ * the output audio, the voice and mix probe streams and the spectrum
+ * analyser output against stored references in tests/golden.
+ *
+ * A scenario without a reference fails, so a new scenario has to be
+ * committed together with its reference. Run with --update to (re)generate
+ * references after an intentional change in sound.
+ *
+ * Every render also records the probe taps it reads with ProbeRecorder and
+ * plays the capture back through CaptureReplay; the replayed rings have to
+ * match the tail of the live probe streams sample for sample. Scenarios that
+ * switch programs are also checked for clicks around each switch, and
+ * sample-accurate pan changes for the sample the render splits at.
+ */
+
+namespace vizasynth {
+
+namespace {
+
+//=============================================================================
+// Tolerance
+//=============================================================================
+
+struct Tolerance {
+    enum class Mode {
+        BitExact,   // Every float identical
+        MaxAbs,     // Largest per-sample difference
+        Spectral    // Largest per-bin magnitude difference (dB), phase-insensitive
+    };
+
+    Mode mode = Mode::MaxAbs;
+    float maxAbs = 1.0e-5f;
+    float maxDecibels = 0.5f;  // Also used for the spectrum analyser streams
+};
+
+bool isDecibelStream(const std::string& name)
+{
+    return name.rfind("spectrum", 0) == 0;
+}
+
+//=============================================================================
+// Rendering
+//=============================================================================
+
+void setParameter(VizASynthAudioProcessor& processor, const std::string& id, float value)
+{
+    auto* parameter = processor.getAPVTS().getParameter(id);
+    jassert(parameter != nullptr);
+
+    if (parameter != nullptr)
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+void drain(ProbeBuffer& probe, std::vector<float>& destination)
+{
+    float scratch[1024];
+    for (int n; (n = probe.pull(scratch, 1024)) > 0;)
+        destination.insert(destination.end(), scratch, scratch + n);
+}
+
+/**
+ * Replace the processor's bank with the scenario's programs, each one the
+ * parameter defaults plus its own values.
+ */
+bool loadScenarioBank(VizASynthAudioProcessor& processor, const GoldenScenario& scenario, const juce::File& bankFile)
+{
+    std::vector<PresetBank::Program> programs;
+    for (const auto& program : scenario.programs) {
+        auto captured = PresetBank::capture(processor, program.name);
+        for (const auto& [id, value] : program.values) {
+            const int index = PresetBank::findParameterIndex(processor, id);
+            jassert(index >= 0);
+            if (index >= 0)
+                captured.values[static_cast<size_t>(index)] = value;
+        }
+        programs.push_back(std::move(captured));
+    }
+
+    const bool loaded = PresetBank::write(bankFile, processor, programs) && processor.loadPresetBank(bankFile);
+    bankFile.deleteFile();
+    return loaded;
+}
+
+/**
+ * @param captureBase  Base name the probe taps are recorded to during the render
+ * @param finalProgram Receives the processor's program when the render ends
+ */
+GoldenFile renderScenario(const GoldenScenario& scenario, const juce::File& captureBase, int& finalProgram)
+{
+    VizASynthAudioProcessor processor;
+    processor.setNonRealtime(true);
+    processor.setPlayConfigDetails(0, 2, scenario.sampleRate, scenario.blockSize);
+
+    if (!scenario.programs.empty() && !loadScenarioBank(processor, scenario, captureBase.withFileExtension("vzbank")))
+        std::cerr << "  cannot load the scenario bank\n";
+
+    auto& probes = processor.getProbeManager();
+    probes.setActiveProbe(scenario.probe);
+    probes.setVoiceMode(scenario.voiceMode);
+
+    // Read the taps an editor on this probe point would: the voice always,
+    // the mix at the Output point and the effects bus points
+    const bool readMix = scenario.probe == ProbePoint::Output || isEffectProbePoint(scenario.probe);
+    ProbeManager::Consumer voiceReader(probes), mixReader(probes);
+    voiceReader.claim(probes.getProbeBuffer());
+    if (readMix)
+        mixReader.claim(probes.getMixProbeBuffer());
+
+    const auto toSample = [&](double seconds) {
+        return static_cast<juce::int64>(std::llround(seconds * scenario.sampleRate));
+    };
+
+    // Note events and parameter changes in time order
+    juce::MidiMessageSequence sequence;
+    for (const auto& note : scenario.notes) {
+        sequence.addEvent(juce::MidiMessage::noteOn(1, note.noteNumber, note.velocity)
+                              .withTimeStamp(static_cast<double>(toSample(note.start))));
+        sequence.addEvent(juce::MidiMessage::noteOff(1, note.noteNumber)
+                              .withTimeStamp(static_cast<double>(toSample(note.start + note.length))));
+    }
+    sequence.sort();
+
+    auto parameters = scenario.parameters;
+    std::stable_sort(parameters.begin(), parameters.end(),
+                     [](const auto& a, const auto& b) { return a.time < b.time; });
+
+    size_t nextParameter = 0;
+    while (nextParameter < parameters.size() && parameters[nextParameter].time <= 0.0) {
+        setParameter(processor, parameters[nextParameter].id, parameters[nextParameter].value);
+        ++nextParameter;
+    }
+
+    processor.prepareToPlay(scenario.sampleRate, scenario.blockSize);
+    processor.reset();
+
+    std::vector<float> discard;
+    drain(probes.getProbeBuffer(), discard);
+    drain(probes.getMixProbeBuffer(), discard);
+
+    // Record exactly the taps read below, so recording doesn't change what is probed
+    ProbeRecorder::Options recording;
+    recording.voice = true;
+    recording.mix = readMix;
+    recording.preallocate = false;
+    if (!probes.startRecording(captureBase, recording))
+        std::cerr << "  cannot record to " << captureBase.getFullPathName() << "\n";
+
+    GoldenFile result;
+    auto& left = result.streams["audio.left"];
+    auto& right = result.streams["audio.right"];
+    auto& voiceProbe = result.streams["probe.voice"];
+    auto& mixProbe = result.streams["probe.mix"];
+
+    const auto totalSamples = toSample(scenario.duration);
+    juce::AudioBuffer<float> buffer(2, scenario.blockSize);
+    juce::MidiBuffer midi;
+    int nextEvent = 0;
+    size_t nextProgramChange = 0;
+
+    for (juce::int64 position = 0; position < totalSamples; position += scenario.blockSize) {
+        const int numSamples = static_cast<int>(juce::jmin<juce::int64>(scenario.blockSize, totalSamples - position));
+
+        // Automation lands on the block containing its timestamp, at the
+        // block start or, for sample-accurate changes, at its own sample
+        while (nextParameter < parameters.size() && toSample(parameters[nextParameter].time) < position + numSamples) {
+            const auto& change = parameters[nextParameter];
+            if (change.sampleAccurate)
+                processor.scheduleParameterChange(change.id, change.value, toSample(change.time));
+            else
+                setParameter(processor, change.id, change.value);
+            ++nextParameter;
+        }
+
+        while (nextProgramChange < scenario.programChanges.size()
+               && toSample(scenario.programChanges[nextProgramChange].time) < position + numSamples) {
+            processor.setCurrentProgram(scenario.programChanges[nextProgramChange].index);
+            ++nextProgramChange;
+        }
+
+        midi.clear();
+        while (nextEvent < sequence.getNumEvents()) {
+            const auto& message = sequence.getEventPointer(nextEvent)->message;
+            const auto eventSample = static_cast<juce::int64>(message.getTimeStamp());
+            if (eventSample >= position + numSamples)
+                break;
+            midi.addEvent(message, static_cast<int>(eventSample - position));
+            ++nextEvent;
+        }
+
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, numSamples);
+        processor.processBlock(block, midi);
+
+        left.insert(left.end(), block.getReadPointer(0), block.getReadPointer(0) + numSamples);
+        right.insert(right.end(), block.getReadPointer(1), block.getReadPointer(1) + numSamples);
+
+        // Probe rings hold several blocks, so draining once per block never drops
+        drain(probes.getProbeBuffer(), voiceProbe);
+        drain(probes.getMixProbeBuffer(), mixProbe);
+    }
+
+    probes.stopRecording();
+    processor.releaseResources();
+    finalProgram = processor.getCurrentProgram();
+
+    // Analysis output: what the spectrum panel would show for the left channel
+    SpectrumAnalyzer analyzer(probes);
+    auto& spectrum = result.streams["spectrum.left"];
+    constexpr auto frameSize = static_cast<size_t>(SpectrumAnalyzer::FFTSize);
+
+    for (size_t start = 0; start + frameSize <= left.size(); start += frameSize / 2) {
+        analyzer.processFFT(left.data() + start);
+        const auto& magnitudes = analyzer.getMagnitudeSpectrum();
+        spectrum.insert(spectrum.end(), magnitudes.begin(), magnitudes.end());
+    }
+
+    return result;
+}
+
+//=============================================================================
+// Comparison
+//=============================================================================
+
+/**
+ * Frame-wise magnitude spectra in dB, used for phase-insensitive comparison.
+ */
+std::vector<float> magnitudeFrames(const std::vector<float>& samples)
+{
+    constexpr int Order = 11;
+    constexpr int Size = 1 << Order;
+
+    juce::dsp::FFT fft(Order);
+    juce::dsp::WindowingFunction<float> window(Size, juce::dsp::WindowingFunction<float>::hann);
+    std::vector<float> frame(Size * 2);
+    std::vector<float> result;
+
+    for (size_t start = 0; start < samples.size(); start += Size / 2) {
+        std::fill(frame.begin(), frame.end(), 0.0f);
+        const auto count = std::min(samples.size() - start, static_cast<size_t>(Size));
+        std::copy(samples.begin() + static_cast<std::ptrdiff_t>(start),
+                  samples.begin() + static_cast<std::ptrdiff_t>(start + count), frame.begin());
+
+        window.multiplyWithWindowingTable(frame.data(), Size);
+        fft.performFrequencyOnlyForwardTransform(frame.data());
+
+        for (int bin = 0; bin < Size / 2; ++bin)
+            result.push_back(juce::Decibels::gainToDecibels(frame[static_cast<size_t>(bin)] / Size, -120.0f));
+    }
+
+    return result;
+}
+
+bool compareStream(const std::string& name, const std::vector<float>& expected,
+                   const std::vector<float>& actual, const Tolerance& tolerance, juce::String& detail)
+{
+    if (expected.size() != actual.size()) {
+        detail = "length " + juce::String(static_cast<juce::int64>(actual.size()))
+               + ", expected " + juce::String(static_cast<juce::int64>(expected.size()));
+        return false;
+    }
+
+    if (tolerance.mode == Tolerance::Mode::BitExact) {
+        for (size_t i = 0; i < expected.size(); ++i) {
+            if (std::memcmp(&expected[i], &actual[i], sizeof(float)) != 0) {
+                detail = "first difference at " + juce::String(static_cast<juce::int64>(i))
+                       + ": " + juce::String(actual[i], 9) + " vs " + juce::String(expected[i], 9);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Analyser output is already in dB; audio streams compare per sample
+    // or, in spectral mode, per magnitude bin above the noise floor
+    const bool decibels = isDecibelStream(name) || tolerance.mode == Tolerance::Mode::Spectral;
+    const auto a = (tolerance.mode == Tolerance::Mode::Spectral && !isDecibelStream(name)) ? magnitudeFrames(expected) : expected;
+    const auto b = (tolerance.mode == Tolerance::Mode::Spectral && !isDecibelStream(name)) ? magnitudeFrames(actual) : actual;
+    const float limit = decibels ? tolerance.maxDecibels : tolerance.maxAbs;
+
+    float worst = 0.0f;
+    size_t worstIndex = 0;
+
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (decibels && a[i] < -90.0f && b[i] < -90.0f)
+            continue;
+
+        const float difference = std::abs(a[i] - b[i]);
+        if (std::isnan(difference)) {
+            detail = "NaN at " + juce::String(static_cast<juce::int64>(i));
+            return false;
+        }
+
+        if (difference > worst) {
+            worst = difference;
+            worstIndex = i;
+        }
+    }
+
+    detail = "max error " + juce::String(worst, 7) + (decibels ? " dB" : "")
+           + " at " + juce::String(static_cast<juce::int64>(worstIndex));
+    return worst <= limit;
+}
+
+//=============================================================================
+// Capture round trip
+//=============================================================================
+
+/**
+ * Replays the capture recorded during a render and checks that the replayed
+ * rings hold the newest samples of the live probe streams, bit for bit.
+ */
+bool checkCaptureReplay(const juce::File& captureBase, const GoldenFile& rendered, juce::String& detail)
+{
+    CaptureReplay replay;
+    if (!replay.openCapture(captureBase)) {
+        detail = "cannot open the capture";
+        return false;
+    }
+
+    // Seek to the end; the feeder refills the rings with the history before it
+    replay.setPositionSamples(replay.getLengthSamples());
+    for (int waited = 0; replay.getPositionSamples() < replay.getLengthSamples(); ++waited) {
+        if (waited == 2000) {
+            detail = "seek timed out";
+            return false;
+        }
+        juce::Thread::sleep(1);
+    }
+
+    const std::pair<ProbeRecorder::Tap, const char*> taps[] = {
+        {ProbeRecorder::VoiceTap, "probe.voice"},
+        {ProbeRecorder::MixTap, "probe.mix"},
+    };
+
+    auto& probes = replay.getProbeManager();
+    int checked = 0;
+
+    for (const auto& [tap, name] : taps) {
+        if (!replay.isOpen(tap))
+            continue;
+
+        auto& ring = tap == ProbeRecorder::VoiceTap ? probes.getProbeBuffer() : probes.getMixProbeBuffer();
+        std::vector<float> replayed;
+        drain(ring, replayed);
+
+        // Taps are aligned at their first sample, so a shorter tap (the voice
+        // tap only records while a voice sounds) holds less of the window
+        const auto& live = rendered.streams.at(name);
+        const auto end = static_cast<int64_t>(live.size());
+        const auto start = juce::jlimit<int64_t>(0, end, replay.getLengthSamples() - ring.getCapacity());
+        const bool matches = static_cast<int64_t>(replayed.size()) == end - start
+                             && std::equal(replayed.begin(), replayed.end(), live.begin() + static_cast<std::ptrdiff_t>(start));
+        if (!matches) {
+            detail = juce::String(name) + ": replayed " + juce::String(static_cast<int>(replayed.size()))
+                   + " samples differ from rendered samples "
+                   + juce::String(static_cast<juce::int64>(start)) + " to " + juce::String(static_cast<juce::int64>(end));
+            return false;
+        }
+
+        ++checked;
+    }
+
+    detail = juce::String(checked) + " taps";
+    return checked > 0;
+}
+
+//=============================================================================
+// Program switching
+//=============================================================================
+
+float largestStep(const std::vector<float>& samples, int64_t start, int64_t end)
+{
+    const auto size = static_cast<int64_t>(samples.size());
+    float largest = 0.0f;
+    for (auto i = juce::jlimit<int64_t>(1, size, start); i < juce::jlimit<int64_t>(1, size, end); ++i)
+        largest = std::max(largest, std::abs(samples[static_cast<size_t>(i)] - samples[static_cast<size_t>(i - 1)]));
+    return largest;
+}
+
+/**
+ * Checks that every program change fades out and back in without a click:
+ * around a switch, no sample-to-sample step of the output may be more than
+ * half again the largest step of the steady signal before or after it.
+ */
+bool checkProgramSwitches(const GoldenScenario& scenario, const GoldenFile& rendered, int finalProgram,
+                          juce::String& detail)
+{
+    if (finalProgram != scenario.programChanges.back().index) {
+        detail = "ended on program " + juce::String(finalProgram) + ", expected "
+               + juce::String(scenario.programChanges.back().index);
+        return false;
+    }
+
+    // Fade out, swap and fade in (ProgramFade's default 5 ms per half) from
+    // the block the request lands on
+    const auto fadeSamples = static_cast<int64_t>(scenario.sampleRate * 0.005);
+    const auto steadySamples = static_cast<int64_t>(scenario.sampleRate * 0.05);
+    float worstRatio = 0.0f;
+
+    for (const auto& change : scenario.programChanges) {
+        const auto requested = static_cast<int64_t>(std::llround(change.time * scenario.sampleRate));
+        const auto start = requested / scenario.blockSize * scenario.blockSize;
+        const auto end = start + scenario.blockSize + 2 * fadeSamples;
+
+        for (const char* name : {"audio.left", "audio.right"}) {
+            const auto& samples = rendered.streams.at(name);
+            const float steady = std::max(largestStep(samples, start - steadySamples, start),
+                                          largestStep(samples, end, end + steadySamples));
+            const float during = largestStep(samples, start, end);
+
+            if (during > 1.5f * steady + 1.0e-4f) {
+                detail = juce::String(name) + ": step of " + juce::String(during, 5) + " switching at "
+                       + juce::String(change.time, 3) + " s, steady signal steps up to " + juce::String(steady, 5);
+                return false;
+            }
+
+            if (steady > 0.0f)
+                worstRatio = std::max(worstRatio, during / steady);
+        }
+    }
+
+    detail = juce::String(static_cast<int>(scenario.programChanges.size())) + " switches, largest step "
+           + juce::String(worstRatio, 2) + "x the steady signal's";
+    return true;
+}
+
+//=============================================================================
+// Sample-accurate changes
+//=============================================================================
+
+/**
+ * Checks that sample-accurate pan changes split the render at their sample.
+ * Voices share one pan position, so the output's right/left ratio is the
+ * pan law's gain ratio, and it has to change exactly at the scheduled sample.
+ */
+bool checkSampleAccurateChanges(const GoldenScenario& scenario, const GoldenFile& rendered, juce::String& detail)
+{
+    const auto& left = rendered.streams.at("audio.left");
+    const auto& right = rendered.streams.at("audio.right");
+    const auto size = static_cast<int64_t>(std::min(left.size(), right.size()));
+    const auto gainRatio = [](float pan) {
+        return std::tan((pan + 1.0f) * juce::MathConstants<float>::pi * 0.25f);
+    };
+
+    float pan = 0.0f;
+    int checked = 0;
+
+    for (const auto& change : scenario.parameters) {
+        if (change.id != "pan")
+            continue;
+
+        if (change.sampleAccurate && change.time > 0.0) {
+            const auto at = static_cast<int64_t>(std::llround(change.time * scenario.sampleRate));
+            const float before = gainRatio(pan), after = gainRatio(change.value);
+
+            // The split moves the balance at this sample, not a block boundary before or after it
+            for (auto n = juce::jlimit<int64_t>(0, size, at - 64); n < juce::jlimit<int64_t>(0, size, at + 64); ++n) {
+                const auto i = static_cast<size_t>(n);
+                if (std::abs(left[i]) < 1.0e-3f)
+                    continue;
+
+                const float expected = n < at ? before : after;
+                if (std::abs(right[i] / left[i] - expected) > 1.0e-3f * expected) {
+                    detail = "pan change at sample " + juce::String(static_cast<juce::int64>(at))
+                           + ": right/left ratio " + juce::String(right[i] / left[i], 4) + " at sample "
+                           + juce::String(static_cast<juce::int64>(n)) + ", expected " + juce::String(expected, 4);
+                    return false;
+                }
+            }
+
+            ++checked;
+        }
+
+        pan = change.value;
+    }
+
+    detail = juce::String(checked) + " pan changes";
+    return true;
+}
+
+void deleteCapture(const juce::File& captureBase)
+{
+    for (auto tap : {ProbeRecorder::VoiceTap, ProbeRecorder::MixTap})
+        ProbeRecorder::getTapFile(captureBase, tap, ProbeRecorder::Options().format).deleteFile();
+}
+
+//=============================================================================
+// Running
+//=============================================================================
+
+enum class Outcome { Passed, Failed, Updated };
+
+Outcome runScenario(const GoldenScenario& scenario, const juce::File& goldenDir,
+                    const Tolerance& tolerance, bool update)
+{
+    const auto referenceFile = goldenDir.getChildFile(scenario.name + ".golden");
+    const auto captureBase = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                 .getNonexistentChildFile("vizasynth-golden-" + scenario.name, {});
+    int finalProgram = 0;
+    const auto rendered = renderScenario(scenario, captureBase, finalProgram);
+
+    juce::String replayDetail;
+    const bool replayed = update || checkCaptureReplay(captureBase, rendered, replayDetail);
+    deleteCapture(captureBase);
+
+    // Checked on --update too: a reference must not be written from a clicking render
+    juce::String switchDetail;
+    const bool switched = scenario.programChanges.empty()
+                          || checkProgramSwitches(scenario, rendered, finalProgram, switchDetail);
+    if (!scenario.programChanges.empty())
+        (switched ? std::cout : std::cerr) << "  program switches: " << (switched ? "ok" : "FAIL")
+                                           << " (" << switchDetail << ")\n";
+    if (!switched)
+        return Outcome::Failed;
+
+    const bool sampleAccurate = std::any_of(scenario.parameters.begin(), scenario.parameters.end(),
+                                            [](const auto& change) { return change.sampleAccurate; });
+    juce::String splitDetail;
+    const bool split = !sampleAccurate || checkSampleAccurateChanges(scenario, rendered, splitDetail);
+    if (sampleAccurate)
+        (split ? std::cout : std::cerr) << "  sample-accurate changes: " << (split ? "ok" : "FAIL")
+                                        << " (" << splitDetail << ")\n";
+    if (!split)
+        return Outcome::Failed;
+
+    if (update) {
+        if (!rendered.write(referenceFile)) {
+            std::cerr << "  cannot write " << referenceFile.getFullPathName() << "\n";
+            return Outcome::Failed;
+        }
+        return Outcome::Updated;
+    }
+
+    if (!referenceFile.existsAsFile()) {
+        std::cerr << "  no reference at " << referenceFile.getFullPathName() << ", run with --update\n";
+        return Outcome::Failed;
+    }
+
+    GoldenFile reference;
+    juce::String error;
+    if (!reference.read(referenceFile, error)) {
+        std::cerr << "  " << error << "\n";
+        return Outcome::Failed;
+    }
+
+    bool passed = replayed;
+    (replayed ? std::cout : std::cerr) << "  capture replay: " << (replayed ? "ok" : "FAIL")
+                                       << " (" << replayDetail << ")\n";
+
+    for (const auto& [name, expected] : reference.streams) {
+        auto it = rendered.streams.find(name);
+        if (it == rendered.streams.end()) {
+            std::cerr << "  " << name << ": missing from render\n";
+            passed = false;
+            continue;
+        }
+
+        juce::String detail;
+        const bool ok = compareStream(name, expected, it->second, tolerance, detail);
+        (ok ? std::cout : std::cerr) << "  " << name << ": " << (ok ? "ok" : "FAIL") << " (" << detail << ")\n";
+        passed = passed && ok;
+    }
+
+    for (const auto& [name, samples] : rendered.streams) {
+        if (reference.streams.count(name) == 0)
+            std::cout << "  " << name << ": no reference, run --update to add it\n";
+    }
+
+    return passed ? Outcome::Passed : Outcome::Failed;
+}
+
+} // namespace
+
+} // namespace vizasynth
+
+//=============================================================================
+int main(int argc, char* argv[])
+{
+    using namespace vizasynth;
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h")) {
+        std::cout <<
+            "Usage: VizASynth_GoldenTests [options]\n"
+            "  --golden-dir <dir>    Reference directory (default: tests/golden)\n"
+            "  --update              Write references instead of comparing\n"
+            "  --filter <substring>  Only run matching scenarios\n"
+            "  --list                List scenarios and exit\n"
+            "  --mode <m>            bitexact | maxabs | spectral (default maxabs)\n"
+            "  --max-abs <value>     Per-sample tolerance (default 1e-5)\n"
+            "  --max-db <value>      Per-bin tolerance in dB (default 0.5)\n"
+            "  --strict-realtime     Fail on real-time violations (sanitizer builds)\n";
+        return 0;
+    }
+
+    const auto cwd = juce::File::getCurrentWorkingDirectory();
+    auto goldenDir = args.containsOption("--golden-dir")
+                         ? cwd.getChildFile(args.getValueForOption("--golden-dir"))
+                         : juce::File(VIZASYNTH_GOLDEN_DIR);
+
+    const bool update = args.containsOption("--update");
+    const auto filter = args.containsOption("--filter") ? args.getValueForOption("--filter") : juce::String();
+
+    Tolerance tolerance;
+    if (args.containsOption("--mode")) {
+        const auto mode = args.getValueForOption("--mode");
+        if (mode == "bitexact")
+            tolerance.mode = Tolerance::Mode::BitExact;
+        else if (mode == "spectral")
+            tolerance.mode = Tolerance::Mode::Spectral;
+        else if (mode != "maxabs") {
+            std::cerr << "Unknown mode: " << mode << "\n";
+            return 1;
+        }
+    }
+    if (args.containsOption("--max-abs"))
+        tolerance.maxAbs = args.getValueForOption("--max-abs").getFloatValue();
+    if (args.containsOption("--max-db"))
+        tolerance.maxDecibels = args.getValueForOption("--max-db").getFloatValue();
+
+    int passed = 0, failed = 0, updated = 0;
+
+    for (const auto& scenario : getGoldenScenarios()) {
+        if (filter.isNotEmpty() && !juce::String(scenario.name).contains(filter))
+            continue;
+
+        if (args.containsOption("--list")) {
+            std::cout << scenario.name << "  " << scenario.description << "\n";
+            continue;
+        }
+
+        std::cout << "[ RUN  ] " << scenario.name << "\n";
+
+        switch (runScenario(scenario, goldenDir, tolerance, update)) {
+            case Outcome::Passed:  ++passed;  std::cout << "[  OK  ] "; break;
+            case Outcome::Failed:  ++failed;  std::cout << "[ FAIL ] "; break;
+            case Outcome::Updated: ++updated; std::cout << "[ UPD  ] "; break;
+        }
+        std::cout << scenario.name << "\n";
+    }
+
+    std::cout << passed << " passed, " << failed << " failed";
+    if (updated > 0)
+        std::cout << ", " << updated << " references written to " << goldenDir.getFullPathName();
+    std::cout << "\n";
+
+    // Sanitizer builds: report audio-thread violations seen while rendering
+    if (rtsan::isActive()) {
+        rtsan::writeReport(std::cout);
+
+        if (args.containsOption("--strict-realtime") && rtsan::getViolationCount() > 0)
+            return 1;
+    }
+
+    return failed > 0 ? 1 : 0;
+}
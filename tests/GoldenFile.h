@@ -0,0 +1,95 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace vizasynth {
+
+/**
+ * GoldenFile - Named float streams stored as one reference file
+ *
+ * Layout (little-endian):
+ *   char[4]  magic "VZGD"
+ *   int32    format version
+ *   int32    number of streams
+ *   per stream:
+ *     int32    name length, followed by the UTF-8 name bytes
+ *     int32    number of samples, followed by that many float32 values
+ *
+ * Samples are stored verbatim so bit-exact comparison is possible.
+ */
+class GoldenFile {
+public:
+    static constexpr int FormatVersion = 1;
+
+    std::map<std::string, std::vector<float>> streams;
+
+    bool write(const juce::File& file) const {
+        file.getParentDirectory().createDirectory();
+        file.deleteFile();
+
+        juce::FileOutputStream out(file);
+        if (!out.openedOk())
+            return false;
+
+        out.write("VZGD", 4);
+        out.writeInt(FormatVersion);
+        out.writeInt(static_cast<int>(streams.size()));
+
+        for (const auto& [name, samples] : streams) {
+            out.writeInt(static_cast<int>(name.size()));
+            out.write(name.data(), name.size());
+            out.writeInt(static_cast<int>(samples.size()));
+            for (auto sample : samples)
+                out.writeFloat(sample);
+        }
+
+        out.flush();
+        return out.getStatus().wasOk();
+    }
+
+    bool read(const juce::File& file, juce::String& error) {
+        streams.clear();
+
+        juce::FileInputStream in(file);
+        if (!in.openedOk()) {
+            error = "cannot open " + file.getFullPathName();
+            return false;
+        }
+
+        char magic[4] = {};
+        if (in.read(magic, 4) != 4 || std::string(magic, 4) != "VZGD") {
+            error = "not a golden file: " + file.getFullPathName();
+            return false;
+        }
+
+        if (const int version = in.readInt(); version != FormatVersion) {
+            error = "unsupported golden file version " + juce::String(version);
+            return false;
+        }
+
+        const int numStreams = in.readInt();
+        for (int s = 0; s < numStreams && !in.isExhausted(); ++s) {
+            const int nameLength = in.readInt();
+            std::string name(static_cast<size_t>(juce::jmax(0, nameLength)), '\0');
+            in.read(name.data(), nameLength);
+
+            const int numSamples = in.readInt();
+            if (numSamples < 0 || numSamples > in.getNumBytesRemaining() / 4) {
+                error = "truncated golden file: " + file.getFullPathName();
+                return false;
+            }
+
+            auto& samples = streams[name];
+            samples.resize(static_cast<size_t>(numSamples));
+            for (auto& sample : samples)
+                sample = in.readFloat();
+        }
+
+        return true;
+    }
+};
+
+} // namespace vizasynth
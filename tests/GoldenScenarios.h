@@ -0,0 +1,190 @@
+#pragma once
+
+#include "Core/Types.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vizasynth {
+
+/**
+ * A fixed render scenario for the golden-audio regression tests.
+ *
+ * Scenarios are defined in code rather than as MIDI files so they cover
+ * parameter automation and probe settings too, and cannot drift from the
+ * references by an edited asset.
+ */
+struct GoldenScenario {
+    struct Note {
+        double start;        // Seconds
+        double length;       // Seconds until note-off
+        int noteNumber;
+        float velocity;
+    };
+
+    struct ParameterChange {
+        double time;         // Seconds, applied at the next block boundary
+        std::string id;
+        float value;         // In parameter units (Hz, dB, ...)
+        bool sampleAccurate = false;  // Scheduled at its exact sample instead
+    };
+
+    struct Program {
+        std::string name;
+        std::vector<std::pair<std::string, float>> values;  // Parameter units; the rest keep their defaults
+    };
+
+    struct ProgramChange {
+        double time;         // Seconds, requested at the next block boundary
+        int index;           // Into programs
+    };
+
+    std::string name;
+    std::string description;
+    double sampleRate = 48000.0;
+    int blockSize = 512;
+    double duration = 1.0;
+    ProbePoint probe = ProbePoint::Output;
+    VoiceMode voiceMode = VoiceMode::Mix;
+    std::vector<ParameterChange> parameters;  // time 0 entries form the initial preset
+    std::vector<Note> notes;
+    std::vector<Program> programs;            // Bank written for the render; empty keeps the shipped one
+    std::vector<ProgramChange> programChanges;  // In time order
+};
+
+/**
+ * The regression corpus. Append new scenarios at the end and regenerate
+ * only their references; never edit an existing one in place.
+ */
+inline std::vector<GoldenScenario> getGoldenScenarios()
+{
+    std::vector<GoldenScenario> scenarios;
+
+    {
+        GoldenScenario s;
+        s.name = "sine_single_note";
+        s.description = "One sine note through attack, sustain and release";
+        s.duration = 1.0;
+        s.probe = ProbePoint::Oscillator;
+        s.voiceMode = VoiceMode::SingleVoice;
+        s.parameters = {{0.0, "oscType", 0.0f}, {0.0, "cutoff", 20000.0f}};
+        s.notes = {{0.05, 0.5, 69, 0.8f}};
+        scenarios.push_back(s);
+    }
+
+    {
+        GoldenScenario s;
+        s.name = "saw_chord_resonant_filter";
+        s.description = "Saw triad into a resonant lowpass, probed after the filter";
+        s.blockSize = 256;
+        s.duration = 1.2;
+        s.probe = ProbePoint::PostFilter;
+        s.voiceMode = VoiceMode::SingleVoice;
+        s.parameters = {{0.0, "oscType", 1.0f}, {0.0, "cutoff", 1800.0f}, {0.0, "resonance", 4.0f}};
+        s.notes = {{0.0, 0.8, 60, 0.9f}, {0.0, 0.8, 64, 0.7f}, {0.0, 0.8, 67, 0.7f}};
+        scenarios.push_back(s);
+    }
+
+    {
+        GoldenScenario s;
+        s.name = "square_staccato_odd_blocks";
+        s.description = "Short square notes with an odd block size to exercise block boundaries";
+        s.blockSize = 137;
+        s.duration = 1.0;
+        s.parameters = {{0.0, "oscType", 2.0f}, {0.0, "attack", 0.002f}, {0.0, "release", 0.02f}};
+        for (int i = 0; i < 12; ++i)
+            s.notes.push_back({0.02 + 0.07 * i, 0.035, 48 + (i * 5) % 24, 0.6f + 0.03f * static_cast<float>(i % 4)});
+        scenarios.push_back(s);
+    }
+
+    {
+        GoldenScenario s;
+        s.name = "voice_stealing";
+        s.description = "More overlapping notes than voices, forcing voice stealing";
+        s.blockSize = 64;
+        s.duration = 1.5;
+        s.parameters = {{0.0, "oscType", 1.0f}, {0.0, "release", 0.6f}};
+        for (int i = 0; i < 12; ++i)
+            s.notes.push_back({0.05 * i, 0.9, 40 + 3 * i, 0.5f});
+        scenarios.push_back(s);
+    }
+
+    {
+        GoldenScenario s;
+        s.name = "stereo_spread";
+        s.description = "Panned chord with full voice spread on the stereo bus";
+        s.duration = 1.0;
+        s.parameters = {{0.0, "oscType", 1.0f}, {0.0, "pan", 0.3f}, {0.0, "spread", 1.0f}};
+        s.notes = {{0.0, 0.6, 55, 0.8f}, {0.01, 0.6, 62, 0.8f}, {0.02, 0.6, 71, 0.8f}};
+        scenarios.push_back(s);
+    }
+
+    {
+        GoldenScenario s;
+        s.name = "automation";
+        s.description = "Cutoff and master volume moves while a note is held";
+        s.blockSize = 128;
+        s.duration = 1.2;
+        s.parameters = {{0.0, "oscType", 1.0f}, {0.0, "cutoff", 400.0f}, {0.0, "masterVolume", -6.0f},
+                        {0.3, "cutoff", 4000.0f}, {0.5, "masterVolume", -18.0f},
+                        {0.7, "cutoff", 800.0f}, {0.8, "masterVolume", 0.0f}};
+        s.notes = {{0.0, 1.0, 45, 1.0f}};
+        scenarios.push_back(s);
+    }
+
+    {
+        GoldenScenario s;
+        s.name = "effects_all";
+        s.description = "Chorus, delay and reverb on from the start on the stereo bus, probed after the reverb";
+        s.duration = 1.5;
+        s.probe = ProbePoint::Reverb;
+        s.parameters = {{0.0, "oscType", 1.0f}, {0.0, "spread", 0.6f},
+                        {0.0, "chorusEnabled", 1.0f}, {0.0, "delayEnabled", 1.0f}, {0.0, "reverbEnabled", 1.0f},
+                        {0.0, "delayTime", 120.0f}, {0.0, "delayFeedback", 0.5f}, {0.0, "reverbSize", 0.8f}};
+        s.notes = {{0.0, 0.3, 57, 0.8f}, {0.0, 0.3, 64, 0.7f}, {0.4, 0.2, 69, 0.9f}};
+        scenarios.push_back(s);
+    }
+
+    {
+        GoldenScenario s;
+        s.name = "effects_toggle";
+        s.description = "Effects switched on, off and on again mid-render on the mono voice bus, delay time automated";
+        s.blockSize = 96;
+        s.duration = 1.6;
+        s.parameters = {{0.0, "oscType", 2.0f}, {0.0, "release", 0.05f}, {0.0, "delayTime", 150.0f},
+                        {0.2, "delayEnabled", 1.0f}, {0.45, "delayTime", 90.0f},
+                        {0.7, "delayEnabled", 0.0f}, {1.0, "reverbEnabled", 1.0f},
+                        {1.15, "delayEnabled", 1.0f}, {1.3, "reverbEnabled", 0.0f}};
+        for (int i = 0; i < 8; ++i)
+            s.notes.push_back({0.1 + 0.16 * i, 0.06, 52 + (i * 7) % 12, 0.8f});
+        scenarios.push_back(s);
+    }
+
+    {
+        GoldenScenario s;
+        s.name = "program_switch";
+        s.description = "Program switched to a hard-panned one and back while a sine note is held; checked for clicks";
+        s.duration = 1.2;
+        s.parameters = {{0.0, "oscType", 0.0f}, {0.0, "cutoff", 20000.0f}};
+        s.programs = {{"Centre", {{"oscType", 0.0f}, {"cutoff", 20000.0f}}},
+                      {"Left", {{"oscType", 0.0f}, {"cutoff", 20000.0f}, {"pan", -1.0f}, {"masterVolume", -6.0f}}}};
+        s.programChanges = {{0.4, 1}, {0.8, 0}};
+        s.notes = {{0.0, 1.1, 69, 0.8f}};
+        scenarios.push_back(s);
+    }
+
+    {
+        GoldenScenario s;
+        s.name = "sample_accurate_pan";
+        s.description = "Pan scheduled to a sample inside a block while a sine note is held; checked for the split point";
+        s.duration = 0.6;
+        s.parameters = {{0.0, "oscType", 0.0f}, {0.0, "cutoff", 20000.0f}, {0.0, "pan", -0.5f},
+                        {0.3013, "pan", 0.5f, true}};
+        s.notes = {{0.0, 0.5, 69, 0.8f}};
+        scenarios.push_back(s);
+    }
+
+    return scenarios;
+}
+
+} // namespace vizasynth
@@ -0,0 +1,247 @@
+#include "PluginProcessor.h"
+#include "Core/PluginState.h"
+#include "Core/PresetBank.h"
+#include <juce_events/juce_events.h>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+/**
+ * VizASynth_StateTests - plugin state save/restore tests
+ *
+ * Checks the VZST binary state: a full round trip through a second
+ * processor (every parameter, the program index and the non-parameter
+ * properties), truncated blobs, restores from a host thread other than the
+ * message thread, and XML states saved by earlier versions.
+ */
+
+namespace vizasynth {
+
+namespace {
+
+constexpr const char* ExtraProperty = "stateTestProperty";
+constexpr int TestProgram = 2;
+
+struct Result {
+    int failed = 0;
+
+    void check(bool condition, const juce::String& what)
+    {
+        if (!condition) {
+            ++failed;
+            std::cerr << "  " << what << "\n";
+        }
+    }
+};
+
+/**
+ * A processor with a three-program bank, switched to TestProgram and then
+ * given values that differ from the program's in every parameter.
+ */
+void prepareSource(VizASynthAudioProcessor& processor, const juce::File& bankFile)
+{
+    processor.setNonRealtime(true);
+    processor.setPlayConfigDetails(0, 2, 48000.0, 256);
+    processor.loadPresetBank(bankFile);
+    processor.prepareToPlay(48000.0, 256);
+
+    // Offline, the switch (fade out, swap, fade in) completes inside processBlock
+    processor.setCurrentProgram(TestProgram);
+    juce::AudioBuffer<float> buffer(2, 256);
+    juce::MidiBuffer midi;
+    for (int block = 0; block < 64 && processor.getCurrentProgram() != TestProgram; ++block)
+        processor.processBlock(buffer, midi);
+
+    const auto& parameters = processor.getParameters();
+    for (int i = 0; i < parameters.size(); ++i)
+        parameters[i]->setValueNotifyingHost(std::fmod(0.11f + 0.37f * static_cast<float>(i + 1), 1.0f));
+
+    processor.getAPVTS().state.setProperty(ExtraProperty, "restored", nullptr);
+}
+
+void compareParameters(Result& result, VizASynthAudioProcessor& expected, VizASynthAudioProcessor& actual)
+{
+    const auto& a = expected.getParameters();
+    const auto& b = actual.getParameters();
+    result.check(a.size() == b.size(), "parameter count differs");
+
+    for (int i = 0; i < juce::jmin(a.size(), b.size()); ++i) {
+        if (std::abs(a[i]->getValue() - b[i]->getValue()) > 1.0e-5f)
+            result.check(false, a[i]->getName(64) + ": expected " + juce::String(a[i]->getValue())
+                                    + ", got " + juce::String(b[i]->getValue()));
+    }
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+
+int testRoundTrip(const juce::File& bankFile)
+{
+    Result result;
+
+    VizASynthAudioProcessor source;
+    prepareSource(source, bankFile);
+    result.check(source.getCurrentProgram() == TestProgram, "program switch did not complete");
+
+    juce::MemoryBlock state;
+    source.getStateInformation(state);
+    result.check(PluginState::isBinaryState(state.getData(), static_cast<int>(state.getSize())),
+                 "state is not in the binary format");
+
+    std::vector<PluginState::Value> values;
+    juce::ValueTree properties;
+    result.check(PluginState::read(state.getData(), static_cast<int>(state.getSize()), values, properties),
+                 "state does not read back");
+    result.check(static_cast<int>(values.size()) == source.getParameters().size(), "parameter table is incomplete");
+    result.check(properties.getProperty(ExtraProperty) == "restored", "non-parameter property not written");
+
+    VizASynthAudioProcessor restored;
+    restored.loadPresetBank(bankFile);
+    restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+
+    compareParameters(result, source, restored);
+    result.check(restored.getCurrentProgram() == TestProgram, "program index not restored");
+    result.check(restored.getAPVTS().state.getProperty(ExtraProperty) == "restored",
+                 "non-parameter property not restored");
+
+    return result.failed;
+}
+
+int testTruncated(const juce::File& bankFile)
+{
+    Result result;
+
+    VizASynthAudioProcessor source;
+    prepareSource(source, bankFile);
+
+    juce::MemoryBlock state;
+    source.getStateInformation(state);
+
+    VizASynthAudioProcessor untouched;
+    VizASynthAudioProcessor target;
+
+    // Every cut, from the header to the last byte of the property tree
+    for (int size = 0; size < static_cast<int>(state.getSize()); ++size) {
+        std::vector<PluginState::Value> values;
+        juce::ValueTree properties;
+        if (PluginState::read(state.getData(), size, values, properties))
+            result.check(false, "state truncated to " + juce::String(size) + " bytes reads as valid");
+
+        target.setStateInformation(state.getData(), size);
+    }
+
+    compareParameters(result, untouched, target);
+    result.check(!target.getAPVTS().state.hasProperty(ExtraProperty), "truncated state applied properties");
+
+    return result.failed;
+}
+
+int testRestoreOffMessageThread(const juce::File& bankFile)
+{
+    Result result;
+
+    VizASynthAudioProcessor source;
+    prepareSource(source, bankFile);
+
+    juce::MemoryBlock state;
+    source.getStateInformation(state);
+
+    VizASynthAudioProcessor restored;
+    restored.loadPresetBank(bankFile);
+    std::thread host([&] { restored.setStateInformation(state.getData(), static_cast<int>(state.getSize())); });
+    host.join();
+
+    // Parameters and the program take effect right away; the properties wait
+    // for the message thread but are already part of the saved state
+    compareParameters(result, source, restored);
+    result.check(restored.getCurrentProgram() == TestProgram, "program index not restored");
+
+    juce::MemoryBlock saved;
+    restored.getStateInformation(saved);
+
+    std::vector<PluginState::Value> values;
+    juce::ValueTree properties;
+    PluginState::read(saved.getData(), static_cast<int>(saved.getSize()), values, properties);
+    result.check(properties.getProperty(ExtraProperty) == "restored",
+                 "property restored on a host thread is lost when saving");
+
+    return result.failed;
+}
+
+int testLegacyXml(const juce::File& bankFile)
+{
+    Result result;
+
+    VizASynthAudioProcessor source;
+    prepareSource(source, bankFile);
+
+    // What getStateInformation wrote before the binary format
+    auto tree = source.getAPVTS().copyState();
+    tree.setProperty("currentProgram", TestProgram, nullptr);
+
+    juce::MemoryBlock state;
+    juce::AudioProcessor::copyXmlToBinary(*tree.createXml(), state);
+    result.check(!PluginState::isBinaryState(state.getData(), static_cast<int>(state.getSize())),
+                 "XML state taken for binary");
+
+    VizASynthAudioProcessor restored;
+    restored.loadPresetBank(bankFile);
+    restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+
+    compareParameters(result, source, restored);
+    result.check(restored.getCurrentProgram() == TestProgram, "program index not restored from XML");
+    result.check(restored.getAPVTS().state.getProperty(ExtraProperty) == "restored",
+                 "property not restored from XML");
+
+    return result.failed;
+}
+
+} // namespace
+
+} // namespace vizasynth
+
+//=============================================================================
+int main()
+{
+    using namespace vizasynth;
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    // A bank with enough programs to restore a non-zero index
+    juce::TemporaryFile bankFile(".vzbank");
+    {
+        VizASynthAudioProcessor processor;
+        std::vector<PresetBank::Program> programs;
+        for (int i = 0; i <= TestProgram; ++i)
+            programs.push_back(PresetBank::capture(processor, "Program " + juce::String(i + 1)));
+
+        if (!PresetBank::write(bankFile.getFile(), processor, programs)) {
+            std::cerr << "Cannot write " << bankFile.getFile().getFullPathName() << "\n";
+            return 1;
+        }
+    }
+
+    const std::pair<const char*, int (*)(const juce::File&)> tests[] = {
+        {"round_trip", testRoundTrip},
+        {"truncated", testTruncated},
+        {"restore_off_message_thread", testRestoreOffMessageThread},
+        {"legacy_xml", testLegacyXml},
+    };
+
+    int passed = 0, failed = 0;
+
+    for (const auto& [name, test] : tests) {
+        std::cout << "[ RUN  ] " << name << "\n";
+        if (test(bankFile.getFile()) == 0) {
+            ++passed;
+            std::cout << "[  OK  ] " << name << "\n";
+        } else {
+            ++failed;
+            std::cout << "[ FAIL ] " << name << "\n";
+        }
+    }
+
+    std::cout << passed << " passed, " << failed << " failed\n";
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,92 @@
+/*
+ * probe_reader - Follow a VizASynth shared-memory probe export
+ *
+ * Start the synth with VIZASYNTH_PROBE_SHM=/vizasynth-probes, then pass the
+ * segment it logs (the name with "-<pid>-<instance>" appended):
+ *
+ *   probe_reader segment [voice|mix] [--raw]
+ *
+ * Prints peak and RMS ten times a second, or with --raw writes the samples
+ * to stdout as native float32 (e.g. piped into numpy.frombuffer).
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../../src/Visualization/SharedProbeLayout.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define CHUNK 4096
+
+int main(int argc, char** argv)
+{
+    const char* segment = argc > 1 ? argv[1] : NULL;
+    const char* channelName = argc > 2 ? argv[2] : VZ_PROBE_CHANNEL_MIX;
+    const int raw = argc > 3 && strcmp(argv[3], "--raw") == 0;
+
+    vz_probe_reader reader;
+    float samples[CHUNK];
+    const struct timespec interval = {0, 100 * 1000 * 1000};
+    uint64_t cursor;
+    int channel;
+
+    if (segment == NULL) {
+        fprintf(stderr, "Usage: probe_reader segment [voice|mix] [--raw]\n");
+        return 1;
+    }
+
+    if (vz_probe_open(&reader, segment) != 0) {
+        fprintf(stderr, "No probe export at %s (is VIZASYNTH_PROBE_SHM set for the synth?)\n", segment);
+        return 1;
+    }
+
+    channel = vz_probe_find_channel(&reader, channelName);
+    if (channel < 0) {
+        fprintf(stderr, "No channel '%s' in %s\n", channelName, segment);
+        vz_probe_close(&reader);
+        return 1;
+    }
+
+    /* Start from now rather than replaying the whole ring */
+    cursor = vz_probe_write_index(&reader, channel);
+
+    for (;;) {
+        uint64_t received = 0, dropped = 0, skipped;
+        double sumSquares = 0.0;
+        float peak = 0.0f;
+        size_t count, i;
+
+        while ((count = vz_probe_read(&reader, channel, &cursor, samples, CHUNK, &skipped)) > 0) {
+            dropped += skipped;
+            received += count;
+
+            if (raw) {
+                fwrite(samples, sizeof(float), count, stdout);
+                continue;
+            }
+
+            for (i = 0; i < count; ++i) {
+                const float magnitude = fabsf(samples[i]);
+                if (magnitude > peak)
+                    peak = magnitude;
+                sumSquares += (double) samples[i] * samples[i];
+            }
+        }
+
+        if (raw) {
+            fflush(stdout);
+        } else {
+            printf("%-6s %7.0f Hz  clock %12llu  samples %6llu  dropped %6llu  peak %6.3f  rms %6.3f\n",
+                   channelName, vz_probe_sample_rate(&reader),
+                   (unsigned long long) __atomic_load_n(&reader.header->sample_clock, __ATOMIC_ACQUIRE),
+                   (unsigned long long) received, (unsigned long long) dropped,
+                   peak, received > 0 ? sqrt(sumSquares / (double) received) : 0.0);
+            fflush(stdout);
+        }
+
+        nanosleep(&interval, NULL);
+    }
+}
@@ -0,0 +1,146 @@
+#include "OfflineRenderer.h"
+#include <juce_events/juce_events.h>
+#include <iostream>
+
+/**
+ * VizASynth_Renderer - command line front end for OfflineRenderer
+ *
+ *   VizASynth_Renderer [options] <file.mid>...
+ *   VizASynth_Renderer [options] --batch <directory>
+ */
+
+namespace {
+
+void printUsage()
+{
+    std::cout <<
+        "Usage: VizASynth_Renderer [options] <file.mid>...\n"
+        "       VizASynth_Renderer [options] --batch <directory>\n"
+        "\n"
+        "Options:\n"
+        "  --preset <file>       Processor state to load (binary state or XML)\n"
+        "  --out <path>          Output .wav (single input) or directory\n"
+        "                        (default: next to each MIDI file)\n"
+        "  --batch <directory>   Render every .mid/.midi file below a directory\n"
+        "  --jobs <n>            Worker threads, 0 = one per CPU core (default 0)\n"
+        "  --sample-rate <hz>    Render sample rate (default 48000)\n"
+        "  --block-size <n>      Processing block size (default 512)\n"
+        "  --bit-depth <n>       16, 24 or 32 (default 24)\n"
+        "  --tail <seconds>      Audio rendered after the last event (default 2)\n"
+        "  --mono                Render a single channel\n";
+}
+
+juce::String takeValue(juce::ArgumentList& args, const juce::String& option, const juce::String& fallback)
+{
+    return args.containsOption(option) ? args.removeValueForOption(option) : fallback;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.size() == 0 || args.containsOption("--help|-h")) {
+        printUsage();
+        return args.size() == 0 ? 1 : 0;
+    }
+
+    vizasynth::OfflineRenderer::Settings settings;
+    settings.sampleRate = takeValue(args, "--sample-rate", "48000").getDoubleValue();
+    settings.blockSize = takeValue(args, "--block-size", "512").getIntValue();
+    settings.bitDepth = takeValue(args, "--bit-depth", "24").getIntValue();
+    settings.tailSeconds = takeValue(args, "--tail", "2").getDoubleValue();
+    settings.numChannels = args.removeOptionIfFound("--mono") ? 1 : 2;
+
+    auto presetPath = takeValue(args, "--preset", {});
+    if (presetPath.isNotEmpty())
+        settings.preset = juce::File::getCurrentWorkingDirectory().getChildFile(presetPath);
+
+    const int numWorkers = takeValue(args, "--jobs", "0").getIntValue();
+    const auto outPath = takeValue(args, "--out", {});
+    const auto batchPath = takeValue(args, "--batch", {});
+    const auto cwd = juce::File::getCurrentWorkingDirectory();
+
+    if (settings.sampleRate <= 0.0 || settings.blockSize <= 0) {
+        std::cerr << "Invalid sample rate or block size\n";
+        return 1;
+    }
+
+    // Collect inputs, keeping paths relative to the batch root so the output
+    // tree mirrors the input tree
+    juce::File inputRoot;
+    juce::Array<juce::File> midiFiles;
+
+    if (batchPath.isNotEmpty()) {
+        inputRoot = cwd.getChildFile(batchPath);
+        for (const auto& entry : juce::RangedDirectoryIterator(inputRoot, true, "*.mid;*.midi"))
+            midiFiles.add(entry.getFile());
+        midiFiles.sort();
+    }
+
+    for (const auto& arg : args.arguments) {
+        if (arg.isOption()) {
+            std::cerr << "Unknown option: " << arg.text << "\n";
+            return 1;
+        }
+        midiFiles.add(cwd.getChildFile(arg.text));
+    }
+
+    if (midiFiles.isEmpty()) {
+        std::cerr << "No MIDI files to render\n";
+        return 1;
+    }
+
+    const auto outTarget = outPath.isNotEmpty() ? cwd.getChildFile(outPath) : juce::File();
+    const bool outIsFile = midiFiles.size() == 1 && outTarget.hasFileExtension("wav");
+
+    std::vector<vizasynth::OfflineRenderer::Job> jobs;
+    for (const auto& midiFile : midiFiles) {
+        vizasynth::OfflineRenderer::Job job;
+        job.midiFile = midiFile;
+
+        if (outIsFile) {
+            job.outputFile = outTarget;
+        } else if (outTarget == juce::File()) {
+            job.outputFile = midiFile.withFileExtension("wav");
+        } else {
+            auto relative = inputRoot != juce::File() && midiFile.isAChildOf(inputRoot)
+                                ? midiFile.getRelativePathFrom(inputRoot)
+                                : midiFile.getFileName();
+            job.outputFile = outTarget.getChildFile(relative).withFileExtension("wav");
+        }
+
+        jobs.push_back(job);
+    }
+
+    vizasynth::OfflineRenderer renderer(settings);
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+    auto results = renderer.renderBatch(jobs, numWorkers);
+    const auto wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+
+    int failures = 0;
+    double audioSeconds = 0.0;
+
+    for (const auto& result : results) {
+        if (result.success) {
+            audioSeconds += result.renderedSeconds;
+            std::cout << result.job.outputFile.getFullPathName() << "  "
+                      << juce::String(result.renderedSeconds, 2) << " s in "
+                      << juce::String(result.elapsedSeconds, 2) << " s\n";
+        } else {
+            ++failures;
+            std::cerr << result.job.midiFile.getFullPathName() << ": " << result.error << "\n";
+        }
+    }
+
+    std::cout << results.size() - static_cast<size_t>(failures) << "/" << results.size()
+              << " rendered, " << juce::String(audioSeconds, 1) << " s of audio in "
+              << juce::String(wallSeconds, 2) << " s ("
+              << juce::String(wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0, 1)
+              << "x real time)\n";
+
+    return failures == 0 ? 0 : 1;
+}
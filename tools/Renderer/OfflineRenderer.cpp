@@ -0,0 +1,232 @@
+#include "OfflineRenderer.h"
+#include "PluginProcessor.h"
+#include <atomic>
+
+namespace vizasynth {
+
+namespace {
+
+juce::MidiMessageSequence readMidiSequence(const juce::File& file, juce::String& error)
+{
+    juce::MidiMessageSequence sequence;
+    juce::FileInputStream stream(file);
+
+    if (!stream.openedOk()) {
+        error = "Cannot open MIDI file: " + file.getFullPathName();
+        return sequence;
+    }
+
+    juce::MidiFile midiFile;
+    if (!midiFile.readFrom(stream)) {
+        error = "Not a valid MIDI file: " + file.getFullPathName();
+        return sequence;
+    }
+
+    // Tempo maps are resolved here, so every event carries a time in seconds
+    midiFile.convertTimestampTicksToSeconds();
+
+    for (int track = 0; track < midiFile.getNumTracks(); ++track)
+        sequence.addSequence(*midiFile.getTrack(track), 0.0);
+
+    sequence.sort();
+    return sequence;
+}
+
+std::unique_ptr<juce::AudioFormatWriter> createWavWriter(const juce::File& file, double sampleRate,
+                                                         int numChannels, int bitDepth, juce::String& error)
+{
+    file.getParentDirectory().createDirectory();
+    file.deleteFile();
+
+    auto stream = std::make_unique<juce::FileOutputStream>(file);
+    if (!stream->openedOk()) {
+        error = "Cannot write to " + file.getFullPathName();
+        return nullptr;
+    }
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer(
+        wav.createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(numChannels),
+                            bitDepth, {}, 0));
+
+    if (writer == nullptr) {
+        error = "Unsupported WAV format (" + juce::String(bitDepth) + " bit)";
+        return nullptr;
+    }
+
+    stream.release();  // Now owned by the writer
+    return writer;
+}
+
+} // namespace
+
+//=============================================================================
+OfflineRenderer::OfflineRenderer(const Settings& s)
+    : settings(s)
+{
+    settings.blockSize = juce::jmax(1, settings.blockSize);
+    settings.numChannels = juce::jlimit(1, 2, settings.numChannels);
+}
+
+OfflineRenderer::~OfflineRenderer() = default;
+
+//=============================================================================
+std::unique_ptr<VizASynthAudioProcessor> OfflineRenderer::createProcessor(juce::String& error) const
+{
+    auto processor = std::make_unique<VizASynthAudioProcessor>();
+
+    // Lets the processor skip anything that only matters for live playback
+    processor->setNonRealtime(true);
+    processor->setPlayConfigDetails(0, settings.numChannels, settings.sampleRate, settings.blockSize);
+
+    if (settings.preset != juce::File() && !loadPreset(*processor, error))
+        return nullptr;
+
+    return processor;
+}
+
+bool OfflineRenderer::loadPreset(VizASynthAudioProcessor& processor, juce::String& error) const
+{
+    if (!settings.preset.existsAsFile()) {
+        error = "Preset not found: " + settings.preset.getFullPathName();
+        return false;
+    }
+
+    // Plain XML presets (an exported parameter tree) are accepted alongside
+    // the binary blob written by getStateInformation()
+    if (auto xml = juce::parseXML(settings.preset)) {
+        auto& apvts = processor.getAPVTS();
+
+        if (!xml->hasTagName(apvts.state.getType())) {
+            error = "Preset is not a Viz-A-Synth parameter tree: " + settings.preset.getFullPathName();
+            return false;
+        }
+
+        apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        return true;
+    }
+
+    juce::MemoryBlock data;
+    if (!settings.preset.loadFileAsData(data) || data.isEmpty()) {
+        error = "Cannot read preset: " + settings.preset.getFullPathName();
+        return false;
+    }
+
+    processor.setStateInformation(data.getData(), static_cast<int>(data.getSize()));
+    return true;
+}
+
+//=============================================================================
+OfflineRenderer::Result OfflineRenderer::render(VizASynthAudioProcessor& processor, const Job& job) const
+{
+    Result result;
+    result.job = job;
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    auto sequence = readMidiSequence(job.midiFile, result.error);
+    if (result.error.isNotEmpty())
+        return result;
+
+    auto writer = createWavWriter(job.outputFile, settings.sampleRate, settings.numChannels,
+                                  settings.bitDepth, result.error);
+    if (writer == nullptr)
+        return result;
+
+    const double sampleRate = settings.sampleRate;
+    const int blockSize = settings.blockSize;
+    const auto totalSamples = static_cast<juce::int64>(
+        std::ceil((sequence.getEndTime() + settings.tailSeconds) * sampleRate));
+
+    processor.prepareToPlay(sampleRate, blockSize);
+    processor.reset();
+
+    juce::AudioBuffer<float> buffer(settings.numChannels, blockSize);
+    juce::MidiBuffer midi;
+    int nextEvent = 0;
+
+    for (juce::int64 position = 0; position < totalSamples; position += blockSize) {
+        const int numSamples = static_cast<int>(juce::jmin<juce::int64>(blockSize, totalSamples - position));
+
+        // Collect the events that fall inside this block at sample accuracy
+        midi.clear();
+        while (nextEvent < sequence.getNumEvents()) {
+            const auto& message = sequence.getEventPointer(nextEvent)->message;
+            const auto eventSample = static_cast<juce::int64>(std::llround(message.getTimeStamp() * sampleRate));
+
+            if (eventSample >= position + numSamples)
+                break;
+
+            if (!message.isMetaEvent())
+                midi.addEvent(message, static_cast<int>(juce::jmax<juce::int64>(0, eventSample - position)));
+
+            ++nextEvent;
+        }
+
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), settings.numChannels, numSamples);
+        processor.processBlock(block, midi);
+
+        if (!writer->writeFromAudioSampleBuffer(block, 0, numSamples)) {
+            result.error = "Write failed: " + job.outputFile.getFullPathName();
+            break;
+        }
+    }
+
+    processor.releaseResources();
+    writer.reset();  // Flushes and finalises the WAV header
+
+    result.success = result.error.isEmpty();
+    result.renderedSeconds = static_cast<double>(totalSamples) / sampleRate;
+    result.elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+    return result;
+}
+
+//=============================================================================
+std::vector<OfflineRenderer::Result> OfflineRenderer::renderBatch(const std::vector<Job>& jobs,
+                                                                  int numWorkers) const
+{
+    std::vector<Result> results(jobs.size());
+
+    if (numWorkers <= 0)
+        numWorkers = juce::SystemStats::getNumCpus();
+
+    numWorkers = juce::jlimit(1, juce::jmax(1, static_cast<int>(jobs.size())), numWorkers);
+
+    // One processor per worker, all constructed up front on this thread
+    std::vector<std::unique_ptr<VizASynthAudioProcessor>> processors;
+    for (int i = 0; i < numWorkers; ++i) {
+        juce::String error;
+        auto processor = createProcessor(error);
+
+        if (processor == nullptr) {
+            for (size_t j = 0; j < jobs.size(); ++j) {
+                results[j].job = jobs[j];
+                results[j].error = error;
+            }
+            return results;
+        }
+
+        processors.push_back(std::move(processor));
+    }
+
+    // Workers pull the next job index until the list is exhausted, which keeps
+    // all cores busy even when files differ widely in length
+    std::atomic<size_t> nextJob{0};
+    juce::ThreadPool pool(numWorkers);
+
+    for (auto& processor : processors) {
+        auto* worker = processor.get();
+
+        pool.addJob([this, worker, &jobs, &results, &nextJob] {
+            for (auto index = nextJob++; index < jobs.size(); index = nextJob++)
+                results[index] = render(*worker, jobs[index]);
+        });
+    }
+
+    while (pool.getNumJobs() > 0)
+        juce::Thread::sleep(10);
+
+    return results;
+}
+
+} // namespace vizasynth
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <memory>
+#include <vector>
+
+class VizASynthAudioProcessor;
+
+namespace vizasynth {
+
+/**
+ * OfflineRenderer - Headless MIDI file to WAV renderer
+ *
+ * Drives VizASynthAudioProcessor without an editor or audio device. The
+ * processor is switched to non-realtime mode and rendered block by block as
+ * fast as the CPU allows, with MIDI events placed sample-accurately.
+ *
+ * Batch mode spreads jobs across worker threads. Every worker owns its own
+ * processor instance, so no audio state is shared between renders.
+ */
+class OfflineRenderer {
+public:
+    /**
+     * Render settings shared by every job.
+     */
+    struct Settings {
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        int numChannels = 2;
+        int bitDepth = 24;
+        double tailSeconds = 2.0;     // Rendered after the last MIDI event for releases
+        juce::File preset;            // Optional processor state (binary state or XML)
+    };
+
+    /**
+     * One MIDI file rendered to one WAV file.
+     */
+    struct Job {
+        juce::File midiFile;
+        juce::File outputFile;
+    };
+
+    /**
+     * Outcome of a single job.
+     */
+    struct Result {
+        Job job;
+        bool success = false;
+        juce::String error;
+        double renderedSeconds = 0.0;  // Length of the rendered audio
+        double elapsedSeconds = 0.0;   // Wall-clock time spent rendering
+    };
+
+    explicit OfflineRenderer(const Settings& settings);
+    ~OfflineRenderer();
+
+    /**
+     * Render a single job with the given processor.
+     * The processor is prepared, rendered and released; its state is left
+     * as loaded from the preset.
+     */
+    Result render(VizASynthAudioProcessor& processor, const Job& job) const;
+
+    /**
+     * Render all jobs using up to numWorkers threads.
+     * Processors are created on the calling thread (the configuration and
+     * parameter trees are not safe to construct concurrently) and then handed
+     * to one worker each.
+     * @param numWorkers Number of worker threads, 0 = one per CPU core
+     * @return Results in job order
+     */
+    std::vector<Result> renderBatch(const std::vector<Job>& jobs, int numWorkers) const;
+
+    /**
+     * Create a processor configured for offline rendering with the preset applied.
+     */
+    std::unique_ptr<VizASynthAudioProcessor> createProcessor(juce::String& error) const;
+
+private:
+    bool loadPreset(VizASynthAudioProcessor& processor, juce::String& error) const;
+
+    Settings settings;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineRenderer)
+};
+
+} // namespace vizasynth